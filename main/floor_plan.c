@@ -0,0 +1,275 @@
+/*
+ * floor_plan.c
+ * Cartesian floor-plan view of the room, the alternative to the polar radar.
+ *
+ * Walls, a one metre grid and every sensor with its field of view are drawn
+ * once into an RGB565 canvas in PSRAM, so the background is a single blit.
+ * Tracked targets are the same sprite markers as on the radar, placed in room
+ * millimetres with a Q16 scale. The view reads the shared target store like
+ * the radar does and the screen manager keeps both screens resident:
+ * switching views is a screen load, with no parsing and no widget rebuild.
+ */
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "lvgl.h"
+#include "floor_plan.h"
+#include "marker_sprites.h"
+#include "radar_targets.h"
+#include "screen_manager.h"
+
+#define SKN_PLAN_PAD         12   // Pixels kept clear around the room outline
+#define SKN_PLAN_GRID_MM     1000
+#define SKN_PLAN_FOV_MM      1500 // Length of the drawn field-of-view edges
+#define SKN_PLAN_HALF_FOV    60   // RD-03D azimuth either side of boresight
+#define SKN_PLAN_SHIFT       16   // Q16 pixels per millimetre
+#define SKN_PLAN_WALL_COLOR  0xC0C0C0
+#define SKN_PLAN_GRID_COLOR  0x203050
+#define SKN_PLAN_FOV_COLOR   0x4080FF
+
+#if CONFIG_SKN_FLOOR_PLAN_ENABLE
+
+static const char *PLAN_TAG = "FloorPlan";
+
+typedef struct
+{
+    lv_obj_t *screen;
+    lv_obj_t *background;
+    lv_obj_t *markers[SKN_MAX_TARGETS];
+    lv_draw_buf_t buf;
+    lv_timer_t *timer;
+    int32_t px_per_mm_q16;
+    int32_t origin_x; // Pixel of the room's left wall
+    int32_t origin_y; // Pixel of the room's far wall
+    uint32_t seq;
+    skn_target_frame_t prev;
+    uint8_t heading[SKN_MAX_TARGETS];
+} skn_floor_plan_t;
+
+static skn_floor_plan_t plan;
+
+/**
+ * @brief Room millimetres to floor-plan pixels; y grows away from the sensor wall
+ */
+static void skn_plan_mm_to_point(int32_t x_mm, int32_t y_mm, lv_point_t *point)
+{
+    const int64_t half = 1 << (SKN_PLAN_SHIFT - 1);
+
+    point->x = plan.origin_x + (int32_t)(((int64_t)(x_mm - CONFIG_SKN_ROOM_MIN_X_MM) * plan.px_per_mm_q16 + half) >> SKN_PLAN_SHIFT);
+    point->y = plan.origin_y + (int32_t)(((int64_t)(CONFIG_SKN_ROOM_MAX_Y_MM - y_mm) * plan.px_per_mm_q16 + half) >> SKN_PLAN_SHIFT);
+}
+
+static void skn_plan_line(lv_layer_t *layer, lv_draw_line_dsc_t *line, int32_t x1_mm, int32_t y1_mm, int32_t x2_mm,
+                          int32_t y2_mm)
+{
+    lv_point_t p1, p2;
+
+    skn_plan_mm_to_point(x1_mm, y1_mm, &p1);
+    skn_plan_mm_to_point(x2_mm, y2_mm, &p2);
+    line->p1.x = p1.x;
+    line->p1.y = p1.y;
+    line->p2.x = p2.x;
+    line->p2.y = p2.y;
+    lv_draw_line(layer, line);
+}
+
+/**
+ * @brief Draw a sensor and the edges of its field of view
+ *
+ * @param yaw_deg Boresight counter-clockwise from the room's y axis
+ */
+static void skn_plan_sensor(lv_layer_t *layer, int32_t x_mm, int32_t y_mm, int32_t yaw_deg)
+{
+    lv_draw_line_dsc_t line;
+    lv_draw_rect_dsc_t rect;
+    lv_point_t p;
+
+    lv_draw_line_dsc_init(&line);
+    line.width = 1;
+    line.color = lv_color_hex(SKN_PLAN_FOV_COLOR);
+    for (int32_t edge = -SKN_PLAN_HALF_FOV; edge <= SKN_PLAN_HALF_FOV; edge += 2 * SKN_PLAN_HALF_FOV) {
+        // Boresight is +y, i.e. 90 degrees in the math convention lv_trigo uses
+        int32_t angle = 90 + yaw_deg + edge;
+        angle = ((angle % 360) + 360) % 360;
+        skn_plan_line(layer, &line, x_mm, y_mm,
+                      x_mm + ((SKN_PLAN_FOV_MM * lv_trigo_cos(angle)) >> LV_TRIGO_SHIFT),
+                      y_mm + ((SKN_PLAN_FOV_MM * lv_trigo_sin(angle)) >> LV_TRIGO_SHIFT));
+    }
+
+    skn_plan_mm_to_point(x_mm, y_mm, &p);
+    lv_draw_rect_dsc_init(&rect);
+    rect.bg_color = lv_color_hex(SKN_PLAN_FOV_COLOR);
+    rect.radius = LV_RADIUS_CIRCLE;
+    lv_area_t area = {.x1 = p.x - 4, .y1 = p.y - 4, .x2 = p.x + 4, .y2 = p.y + 4};
+    lv_draw_rect(layer, &rect, &area);
+}
+
+/**
+ * @brief Fit the room into the screen and render the static background once
+ */
+static bool skn_plan_background_render(int32_t width, int32_t height)
+{
+    const int32_t room_w = CONFIG_SKN_ROOM_MAX_X_MM - CONFIG_SKN_ROOM_MIN_X_MM;
+    const int32_t room_d = CONFIG_SKN_ROOM_MAX_Y_MM - CONFIG_SKN_ROOM_MIN_Y_MM;
+    int32_t fit_w = ((int64_t)(width - 2 * SKN_PLAN_PAD) << SKN_PLAN_SHIFT) / room_w;
+    int32_t fit_h = ((int64_t)(height - 2 * SKN_PLAN_PAD) << SKN_PLAN_SHIFT) / room_d;
+
+    plan.px_per_mm_q16 = LV_MIN(fit_w, fit_h);
+    plan.origin_x = (width - (int32_t)(((int64_t)room_w * plan.px_per_mm_q16) >> SKN_PLAN_SHIFT)) / 2;
+    plan.origin_y = (height - (int32_t)(((int64_t)room_d * plan.px_per_mm_q16) >> SKN_PLAN_SHIFT)) / 2;
+
+    uint32_t stride = lv_draw_buf_width_to_stride(width, LV_COLOR_FORMAT_RGB565);
+    void *data = heap_caps_aligned_alloc(LV_DRAW_BUF_ALIGN, stride * height, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (data == NULL) {
+        ESP_LOGE(PLAN_TAG, "Unable to allocate %" LV_PRId32 "x%" LV_PRId32 " floor plan", width, height);
+        return false;
+    }
+    lv_draw_buf_init(&plan.buf, width, height, LV_COLOR_FORMAT_RGB565, stride, data, stride * height);
+    lv_canvas_set_draw_buf(plan.background, &plan.buf);
+    lv_canvas_fill_bg(plan.background, lv_color_black(), LV_OPA_COVER);
+
+    lv_layer_t layer;
+    lv_canvas_init_layer(plan.background, &layer);
+
+    lv_draw_line_dsc_t line;
+    lv_draw_line_dsc_init(&line);
+    line.width = 1;
+    line.color = lv_color_hex(SKN_PLAN_GRID_COLOR);
+    for (int32_t x = CONFIG_SKN_ROOM_MIN_X_MM - CONFIG_SKN_ROOM_MIN_X_MM % SKN_PLAN_GRID_MM; x < CONFIG_SKN_ROOM_MAX_X_MM;
+         x += SKN_PLAN_GRID_MM) {
+        if (x > CONFIG_SKN_ROOM_MIN_X_MM) {
+            skn_plan_line(&layer, &line, x, CONFIG_SKN_ROOM_MIN_Y_MM, x, CONFIG_SKN_ROOM_MAX_Y_MM);
+        }
+    }
+    for (int32_t y = CONFIG_SKN_ROOM_MIN_Y_MM - CONFIG_SKN_ROOM_MIN_Y_MM % SKN_PLAN_GRID_MM; y < CONFIG_SKN_ROOM_MAX_Y_MM;
+         y += SKN_PLAN_GRID_MM) {
+        if (y > CONFIG_SKN_ROOM_MIN_Y_MM) {
+            skn_plan_line(&layer, &line, CONFIG_SKN_ROOM_MIN_X_MM, y, CONFIG_SKN_ROOM_MAX_X_MM, y);
+        }
+    }
+
+    lv_draw_rect_dsc_t walls;
+    lv_point_t top_left, bottom_right;
+    lv_draw_rect_dsc_init(&walls);
+    walls.bg_opa = LV_OPA_TRANSP;
+    walls.border_width = 3;
+    walls.border_color = lv_color_hex(SKN_PLAN_WALL_COLOR);
+    skn_plan_mm_to_point(CONFIG_SKN_ROOM_MIN_X_MM, CONFIG_SKN_ROOM_MAX_Y_MM, &top_left);
+    skn_plan_mm_to_point(CONFIG_SKN_ROOM_MAX_X_MM, CONFIG_SKN_ROOM_MIN_Y_MM, &bottom_right);
+    lv_area_t room = {.x1 = top_left.x, .y1 = top_left.y, .x2 = bottom_right.x, .y2 = bottom_right.y};
+    lv_draw_rect(&layer, &walls, &room);
+
+    skn_plan_sensor(&layer, CONFIG_SKN_SENSOR1_X_MM, CONFIG_SKN_SENSOR1_Y_MM, CONFIG_SKN_SENSOR1_YAW_DEG);
+#if CONFIG_SKN_SENSOR_COUNT > 1
+    skn_plan_sensor(&layer, CONFIG_SKN_SENSOR2_X_MM, CONFIG_SKN_SENSOR2_Y_MM, CONFIG_SKN_SENSOR2_YAW_DEG);
+#endif
+
+    lv_canvas_finish_layer(plan.background, &layer);
+    return true;
+}
+
+/**
+ * @brief Show a new frame; only markers whose target moved are touched
+ */
+static void skn_plan_show(const skn_target_frame_t *frame)
+{
+    for (uint8_t i = 0; i < SKN_MAX_TARGETS; i++) {
+        lv_obj_t *marker = plan.markers[i];
+        bool hidden = lv_obj_has_flag(marker, LV_OBJ_FLAG_HIDDEN);
+
+        if (i >= frame->count) {
+            if (!hidden) lv_obj_add_flag(marker, LV_OBJ_FLAG_HIDDEN);
+            continue;
+        }
+
+        const skn_target_t *t = &frame->targets[i];
+        const skn_target_t *p = i < plan.prev.count ? &plan.prev.targets[i] : NULL;
+        if (!hidden && p != NULL && t->x_mm == p->x_mm && t->y_mm == p->y_mm && t->speed_mms == p->speed_mms) {
+            continue;
+        }
+        if (p != NULL) {
+            uint8_t heading = skn_sprite_heading(t->x_mm - p->x_mm, t->y_mm - p->y_mm);
+            plan.heading[i] = heading != SKN_SPRITE_NO_HEADING ? heading : plan.heading[i];
+        }
+
+        lv_point_t point;
+        skn_plan_mm_to_point(t->x_mm, t->y_mm, &point);
+        lv_obj_set_pos(marker, point.x - SKN_SPRITE_SZ / 2, point.y - SKN_SPRITE_SZ / 2);
+        const lv_image_dsc_t *sprite = skn_sprite_get(i, plan.heading[i], skn_sprite_speed_class(t->speed_mms));
+        if (sprite != NULL && lv_image_get_src(marker) != sprite) {
+            lv_image_set_src(marker, sprite);
+        }
+        if (hidden) lv_obj_remove_flag(marker, LV_OBJ_FLAG_HIDDEN);
+    }
+    plan.prev = *frame;
+}
+
+/**
+ * @brief Follow the shared target store while the floor plan is on screen
+ *
+ * An off-screen plan does nothing; it catches up with the first tick after
+ * its screen is loaded.
+ */
+static void skn_plan_timer_cb(lv_timer_t *timer)
+{
+    skn_target_frame_t frame;
+
+    if (lv_screen_active() != plan.screen) {
+        return;
+    }
+    if (skn_targets_latest(&frame) == plan.seq) {
+        return;
+    }
+    plan.seq = frame.seq;
+    skn_plan_show(&frame);
+}
+
+/**
+ * @brief Build the floor-plan screen for the screen manager
+ *
+ * Step 0 renders the background, step 1 adds markers, the feed and the way
+ * back to the radar.
+ *
+ * @param screen Screen created by the screen manager
+ * @param step Build step
+ * @return true once the screen is complete
+ */
+bool skn_floor_plan_build(lv_obj_t *screen, uint8_t step)
+{
+    if (step == 0) {
+        plan.screen = screen;
+        lv_obj_set_style_bg_color(screen, lv_color_black(), 0);
+        lv_obj_set_style_bg_opa(screen, LV_OPA_COVER, 0);
+        lv_obj_remove_flag(screen, LV_OBJ_FLAG_SCROLLABLE);
+
+        plan.background = lv_canvas_create(screen);
+        lv_obj_remove_flag(plan.background, LV_OBJ_FLAG_CLICKABLE);
+        if (!skn_plan_background_render(lv_obj_get_width(screen), lv_obj_get_height(screen))) {
+            lv_obj_add_flag(plan.background, LV_OBJ_FLAG_HIDDEN);
+        }
+        return false;
+    }
+
+    esp_err_t ret = skn_sprites_init();
+    if (ret != ESP_OK) {
+        ESP_LOGW(PLAN_TAG, "No marker sprites (%s), targets will not be shown", esp_err_to_name(ret));
+    }
+    for (uint8_t i = 0; i < SKN_MAX_TARGETS; i++) {
+        plan.markers[i] = lv_image_create(screen);
+        plan.heading[i] = SKN_SPRITE_NO_HEADING;
+        lv_obj_remove_flag(plan.markers[i], LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_add_flag(plan.markers[i], LV_OBJ_FLAG_HIDDEN);
+    }
+    plan.timer = lv_timer_create(skn_plan_timer_cb, CONFIG_SKN_SENSOR_POLL_MS, NULL);
+    skn_screen_switch_add(screen, SKN_SCREEN_RADAR, "Radar");
+    return true;
+}
+
+#else
+
+bool skn_floor_plan_build(lv_obj_t *screen, uint8_t step)
+{
+    return true;
+}
+
+#endif
@@ -0,0 +1,303 @@
+/*
+ * heatmap.c
+ * Occupancy heat map and motion trails for the radar screen.
+ *
+ * Targets are accumulated into two low-resolution byte grids in PSRAM that
+ * cover the whole sensor field: a slowly decaying heat grid (dwell history)
+ * and a fast decaying trail grid (recent paths, one line per track). Every
+ * period both grids decay exponentially four cells at a time, are mapped
+ * through palette tables into a single ARGB8888 image and that image is
+ * stretched over the radar background by one lv_image. No LVGL object is
+ * created per point. Each radar gets its own layer; the state hangs off the
+ * image, its timer and the radar's geometry callback as user data.
+ */
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include <stdlib.h>
+#include <string.h>
+#include "heatmap.h"
+#include "radar_panel.h"
+#include "radar_targets.h"
+
+#define SKN_HEAT_FIELD_MM  8000
+#define SKN_HEAT_W         128 // 125 mm cells across -8 m..8 m
+#define SKN_HEAT_H         64  // 125 mm cells across 0..8 m
+#define SKN_HEAT_CELLS     (SKN_HEAT_W * SKN_HEAT_H)
+#define SKN_HEAT_DEPOSIT   32  // Heat added per frame at the target cell
+#define SKN_HEAT_SPREAD    12  // Heat added to the 8 neighbouring cells
+#define SKN_TRAIL_JUMP_MM  1500 // Longer moves are track swaps, not motion
+
+#if CONFIG_SKN_HEATMAP_ENABLE
+
+static const char *HEAT_TAG = "HeatMap";
+
+typedef struct
+{
+    lv_obj_t *image;
+    lv_timer_t *timer;
+    lv_image_dsc_t dsc;
+    uint8_t *heat;
+    uint8_t *trail;
+    uint32_t *pixels;
+    uint32_t heat_lut[256];
+    uint32_t trail_lut[256];
+    uint32_t last_seq;
+    bool visible;
+    bool prev_valid[SKN_MAX_TARGETS];
+    int16_t prev_cx[SKN_MAX_TARGETS];
+    int16_t prev_cy[SKN_MAX_TARGETS];
+} skn_heatmap_t;
+
+/**
+ * @brief Exponential decay of a byte grid, four cells per 32-bit word
+ *
+ * Each byte loses (v >> shift) plus one while non-zero, so every cell reaches
+ * zero. Neither term can exceed the byte, so no borrow crosses lanes.
+ *
+ * @return OR of all decayed words, zero once the grid is empty
+ */
+static uint32_t skn_heatmap_decay(uint32_t *grid, size_t words, unsigned shift)
+{
+    const uint32_t lane_mask = (0xFFu >> shift) * 0x01010101u;
+    uint32_t any = 0;
+
+    for (size_t i = 0; i < words; i++) {
+        uint32_t v = grid[i];
+        if (v == 0) {
+            continue;
+        }
+        uint32_t nonzero = ((((v & 0x7F7F7F7Fu) + 0x7F7F7F7Fu) | v) >> 7) & 0x01010101u;
+        v -= ((v >> shift) & lane_mask) + nonzero;
+        grid[i] = v;
+        any |= v;
+    }
+    return any;
+}
+
+static inline void skn_heatmap_add(uint8_t *cell, uint8_t amount)
+{
+    *cell = (*cell > 255 - amount) ? 255 : *cell + amount;
+}
+
+static bool skn_heatmap_cell(const skn_target_t *t, int16_t *cx, int16_t *cy)
+{
+    int32_t x = ((int32_t)t->x_mm + SKN_HEAT_FIELD_MM) * SKN_HEAT_W / (2 * SKN_HEAT_FIELD_MM);
+    int32_t y = ((int32_t)SKN_HEAT_FIELD_MM - t->y_mm) * SKN_HEAT_H / SKN_HEAT_FIELD_MM;
+
+    if (x < 0 || x >= SKN_HEAT_W || y < 0 || y >= SKN_HEAT_H) {
+        return false;
+    }
+    *cx = x;
+    *cy = y;
+    return true;
+}
+
+static void skn_heatmap_deposit(skn_heatmap_t *heatmap, int16_t cx, int16_t cy)
+{
+    for (int16_t y = cy - 1; y <= cy + 1; y++) {
+        if (y < 0 || y >= SKN_HEAT_H) {
+            continue;
+        }
+        for (int16_t x = cx - 1; x <= cx + 1; x++) {
+            if (x < 0 || x >= SKN_HEAT_W) {
+                continue;
+            }
+            skn_heatmap_add(&heatmap->heat[y * SKN_HEAT_W + x],
+                            (x == cx && y == cy) ? SKN_HEAT_DEPOSIT : SKN_HEAT_SPREAD);
+        }
+    }
+}
+
+static void skn_heatmap_trail(skn_heatmap_t *heatmap, int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+    int16_t dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int16_t dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int16_t err = dx + dy;
+
+    for (;;) {
+        heatmap->trail[y0 * SKN_HEAT_W + x0] = 255;
+        if (x0 == x1 && y0 == y1) {
+            break;
+        }
+        int16_t e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+static void skn_heatmap_accumulate(skn_heatmap_t *heatmap, const skn_target_frame_t *frame)
+{
+    bool seen[SKN_MAX_TARGETS] = {false};
+    int16_t jump_cells = SKN_TRAIL_JUMP_MM * SKN_HEAT_H / SKN_HEAT_FIELD_MM;
+
+    for (uint8_t slot = 0; slot < frame->count; slot++) {
+        int16_t cx, cy;
+        if (!skn_heatmap_cell(&frame->targets[slot], &cx, &cy)) {
+            continue;
+        }
+        skn_heatmap_deposit(heatmap, cx, cy);
+        if (heatmap->prev_valid[slot] && abs(cx - heatmap->prev_cx[slot]) <= jump_cells &&
+            abs(cy - heatmap->prev_cy[slot]) <= jump_cells) {
+            skn_heatmap_trail(heatmap, heatmap->prev_cx[slot], heatmap->prev_cy[slot], cx, cy);
+        } else {
+            heatmap->trail[cy * SKN_HEAT_W + cx] = 255;
+        }
+        heatmap->prev_cx[slot] = cx;
+        heatmap->prev_cy[slot] = cy;
+        seen[slot] = true;
+    }
+    memcpy(heatmap->prev_valid, seen, sizeof(seen));
+}
+
+static void skn_heatmap_render(skn_heatmap_t *heatmap)
+{
+    const uint8_t *heat = heatmap->heat;
+    const uint8_t *trail = heatmap->trail;
+    uint32_t *out = heatmap->pixels;
+
+    for (size_t i = 0; i < SKN_HEAT_CELLS; i++) {
+        out[i] = trail[i] ? heatmap->trail_lut[trail[i]] : heatmap->heat_lut[heat[i]];
+    }
+    lv_image_cache_drop(&heatmap->dsc);
+    lv_obj_invalidate(heatmap->image);
+}
+
+static void skn_heatmap_timer_cb(lv_timer_t *timer)
+{
+    skn_heatmap_t *heatmap = lv_timer_get_user_data(timer);
+    skn_target_frame_t frame;
+
+    if (skn_targets_latest(&frame) != heatmap->last_seq) {
+        heatmap->last_seq = frame.seq;
+        skn_heatmap_accumulate(heatmap, &frame);
+    }
+
+    uint32_t any = skn_heatmap_decay((uint32_t *)heatmap->heat, SKN_HEAT_CELLS / 4, CONFIG_SKN_HEATMAP_DECAY_SHIFT);
+    any |= skn_heatmap_decay((uint32_t *)heatmap->trail, SKN_HEAT_CELLS / 4, CONFIG_SKN_TRAIL_DECAY_SHIFT);
+
+    // An empty room costs two scans and no redraw
+    if (any || heatmap->visible) {
+        skn_heatmap_render(heatmap);
+    }
+    heatmap->visible = any != 0;
+}
+
+/**
+ * @brief Palette: heat fades in from transparent blue through red to yellow,
+ * trails are opaque green
+ */
+static void skn_heatmap_build_luts(skn_heatmap_t *heatmap)
+{
+    for (uint32_t v = 0; v < 256; v++) {
+        uint32_t a = v * 160 / 255;
+        uint32_t r = v < 128 ? v * 2 : 255;
+        uint32_t g = v < 128 ? 0 : (v - 128) * 2;
+        uint32_t b = v < 128 ? 255 - v * 2 : 0;
+        heatmap->heat_lut[v] = v ? (a << 24) | (r << 16) | (g << 8) | b : 0;
+        heatmap->trail_lut[v] = (v << 24) | (0x40 << 16) | (0xFF << 8) | 0x40;
+    }
+}
+
+static void skn_heatmap_free(skn_heatmap_t *heatmap)
+{
+    heap_caps_free(heatmap->heat);
+    heap_caps_free(heatmap->trail);
+    heap_caps_free(heatmap->pixels);
+    heap_caps_free(heatmap);
+}
+
+static void skn_heatmap_geometry_cb(lv_event_t *e);
+
+static void skn_heatmap_delete_cb(lv_event_t *e)
+{
+    skn_heatmap_t *heatmap = lv_event_get_user_data(e);
+
+    lv_obj_remove_event_cb_with_user_data(lv_obj_get_parent(heatmap->image), skn_heatmap_geometry_cb, heatmap);
+    lv_timer_delete(heatmap->timer);
+    lv_image_cache_drop(&heatmap->dsc);
+    skn_heatmap_free(heatmap);
+}
+
+/**
+ * @brief Stretch the grid over the sensor field at the radar's current scale
+ */
+static void skn_heatmap_layout(skn_heatmap_t *heatmap, lv_obj_t *radar)
+{
+    lv_point_t top_left, bottom_right;
+
+    lv_radar_mm_to_point(radar, -SKN_HEAT_FIELD_MM, SKN_HEAT_FIELD_MM, &top_left);
+    lv_radar_mm_to_point(radar, SKN_HEAT_FIELD_MM, 0, &bottom_right);
+    lv_obj_set_pos(heatmap->image, top_left.x, top_left.y);
+    lv_obj_set_size(heatmap->image, bottom_right.x - top_left.x, bottom_right.y - top_left.y);
+}
+
+static void skn_heatmap_geometry_cb(lv_event_t *e)
+{
+    skn_heatmap_layout(lv_event_get_user_data(e), lv_event_get_current_target(e));
+}
+
+/**
+ * @brief Create the heat map layer over the radar background
+ *
+ * Call after lv_radar_screen_create() so the layer sits above the grid and
+ * below zones, sweep and markers.
+ *
+ * @param radar The radar container
+ * @return The layer's image object, or NULL when disabled or out of memory
+ */
+lv_obj_t *lv_radar_heatmap_create(lv_obj_t *radar)
+{
+    skn_heatmap_t *heatmap = heap_caps_calloc(1, sizeof(skn_heatmap_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (heatmap != NULL) {
+        heatmap->heat = heap_caps_calloc(SKN_HEAT_CELLS, 1, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        heatmap->trail = heap_caps_calloc(SKN_HEAT_CELLS, 1, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        heatmap->pixels = heap_caps_calloc(SKN_HEAT_CELLS, sizeof(uint32_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+    if (heatmap == NULL || heatmap->heat == NULL || heatmap->trail == NULL || heatmap->pixels == NULL) {
+        ESP_LOGE(HEAT_TAG, "Unable to allocate %dx%d heat map", SKN_HEAT_W, SKN_HEAT_H);
+        if (heatmap != NULL) {
+            skn_heatmap_free(heatmap);
+        }
+        return NULL;
+    }
+    skn_heatmap_build_luts(heatmap);
+
+    heatmap->dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+    heatmap->dsc.header.cf = LV_COLOR_FORMAT_ARGB8888;
+    heatmap->dsc.header.w = SKN_HEAT_W;
+    heatmap->dsc.header.h = SKN_HEAT_H;
+    heatmap->dsc.header.stride = SKN_HEAT_W * sizeof(uint32_t);
+    heatmap->dsc.data_size = SKN_HEAT_CELLS * sizeof(uint32_t);
+    heatmap->dsc.data = (const uint8_t *)heatmap->pixels;
+
+    // Nearest-neighbour keeps the upscale cheap
+    heatmap->image = lv_image_create(radar);
+    lv_image_set_src(heatmap->image, &heatmap->dsc);
+    lv_image_set_inner_align(heatmap->image, LV_IMAGE_ALIGN_STRETCH);
+    lv_image_set_antialias(heatmap->image, false);
+    lv_obj_remove_flag(heatmap->image, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(heatmap->image, skn_heatmap_delete_cb, LV_EVENT_DELETE, heatmap);
+    lv_obj_add_event_cb(radar, skn_heatmap_geometry_cb, lv_radar_geometry_event(), heatmap);
+    skn_heatmap_layout(heatmap, radar);
+
+    heatmap->timer = lv_timer_create(skn_heatmap_timer_cb, CONFIG_SKN_HEATMAP_PERIOD_MS, heatmap);
+    ESP_LOGI(HEAT_TAG, "Heat map %dx%d stretched to %ldx%ld px", SKN_HEAT_W, SKN_HEAT_H,
+             (long)lv_obj_get_width(heatmap->image), (long)lv_obj_get_height(heatmap->image));
+    return heatmap->image;
+}
+
+#else
+
+lv_obj_t *lv_radar_heatmap_create(lv_obj_t *radar)
+{
+    return NULL;
+}
+
+#endif
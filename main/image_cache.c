@@ -0,0 +1,238 @@
+/*
+ * image_cache.c
+ * PSRAM-backed cache of decoded LVGL images with a byte budget and LRU eviction.
+ *
+ * LVGL's own cache is disabled (LV_CACHE_DEF_SIZE=0) and its allocator is a
+ * small internal pool, so file images would otherwise be decoded on every
+ * draw. Images are decoded once here, copied into PSRAM and handed to LVGL
+ * as native lv_image_dsc_t sources.
+ */
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lvgl.h"
+#include <string.h>
+#include "image_cache.h"
+
+#define SKN_IMAGE_CACHE_MAX_ENTRIES 16
+#define SKN_IMAGE_CACHE_PATH_LEN    48
+
+static const char *CACHE_TAG = "ImageCache";
+
+typedef struct
+{
+    char path[SKN_IMAGE_CACHE_PATH_LEN];
+    lv_image_dsc_t dsc;
+    uint8_t *data;
+    size_t size;
+    uint32_t last_use;
+    uint16_t refs;
+    bool used;
+} skn_image_cache_entry_t;
+
+static skn_image_cache_entry_t cache_entries[SKN_IMAGE_CACHE_MAX_ENTRIES];
+static skn_image_cache_stats_t cache_stats;
+static uint32_t cache_clock = 0;
+
+static void *skn_image_buf_malloc(size_t size, lv_color_format_t color_format)
+{
+    LV_UNUSED(color_format);
+    return heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+}
+
+static void skn_image_buf_free(void *buf)
+{
+    heap_caps_free(buf);
+}
+
+static void skn_image_cache_evict(skn_image_cache_entry_t *entry)
+{
+    lv_image_cache_drop(&entry->dsc);
+    heap_caps_free(entry->data);
+    cache_stats.bytes_used -= entry->size;
+    cache_stats.entries--;
+    cache_stats.evictions++;
+    memset(entry, 0, sizeof(*entry));
+}
+
+/**
+ * @brief Evict least recently used, unreferenced entries until size fits the budget
+ *
+ * @param size Number of bytes about to be added
+ * @return true when the budget can hold the new image
+ */
+static bool skn_image_cache_make_room(size_t size)
+{
+    while (cache_stats.bytes_used + size > cache_stats.bytes_budget) {
+        skn_image_cache_entry_t *victim = NULL;
+        for (int i = 0; i < SKN_IMAGE_CACHE_MAX_ENTRIES; i++) {
+            skn_image_cache_entry_t *entry = &cache_entries[i];
+            if (entry->used && entry->refs == 0 &&
+                (victim == NULL || entry->last_use < victim->last_use)) {
+                victim = entry;
+            }
+        }
+        if (victim == NULL) {
+            return false;
+        }
+        skn_image_cache_evict(victim);
+    }
+    return true;
+}
+
+/**
+ * @brief Initialize the image cache
+ *
+ * Also points LVGL's image draw buffers at PSRAM so transient decode buffers
+ * do not compete with widgets for the LVGL heap.
+ *
+ * @param budget_bytes Maximum bytes of decoded pixels kept resident
+ */
+esp_err_t skn_image_cache_init(size_t budget_bytes)
+{
+    memset(cache_entries, 0, sizeof(cache_entries));
+    memset(&cache_stats, 0, sizeof(cache_stats));
+    cache_stats.bytes_budget = budget_bytes;
+
+    lv_draw_buf_handlers_t *handlers = lv_draw_buf_get_image_handlers();
+    handlers->buf_malloc_cb = skn_image_buf_malloc;
+    handlers->buf_free_cb = skn_image_buf_free;
+
+    ESP_LOGI(CACHE_TAG, "Image cache budget: %u bytes in PSRAM", (unsigned)budget_bytes);
+    return ESP_OK;
+}
+
+/**
+ * @brief Get a decoded image for a file path, decoding it on a miss
+ *
+ * The returned descriptor stays valid until released; pass it directly to
+ * lv_image_set_src().
+ *
+ * @param path LVGL file path, e.g. "S:/spiffs/image.png", shorter than
+ *             SKN_IMAGE_CACHE_PATH_LEN
+ * @return Decoded image, or NULL when it could not be decoded or cached
+ */
+const lv_image_dsc_t *skn_image_cache_acquire(const char *path)
+{
+    skn_image_cache_entry_t *slot = NULL;
+
+    // A truncated key would alias other paths sharing its prefix
+    if (strlen(path) >= SKN_IMAGE_CACHE_PATH_LEN) {
+        ESP_LOGE(CACHE_TAG, "Path too long to cache: %s", path);
+        return NULL;
+    }
+
+    for (int i = 0; i < SKN_IMAGE_CACHE_MAX_ENTRIES; i++) {
+        skn_image_cache_entry_t *entry = &cache_entries[i];
+        if (entry->used && strcmp(entry->path, path) == 0) {
+            entry->refs++;
+            entry->last_use = ++cache_clock;
+            cache_stats.hits++;
+            return &entry->dsc;
+        }
+        if (!entry->used && slot == NULL) {
+            slot = entry;
+        }
+    }
+    cache_stats.misses++;
+
+    lv_image_decoder_dsc_t decoder_dsc;
+    lv_image_decoder_args_t args = {
+        .no_cache = true,
+    };
+
+    int64_t start_us = esp_timer_get_time();
+    if (lv_image_decoder_open(&decoder_dsc, path, &args) != LV_RESULT_OK) {
+        ESP_LOGE(CACHE_TAG, "Failed to decode %s", path);
+        return NULL;
+    }
+    uint32_t decode_us = (uint32_t)(esp_timer_get_time() - start_us);
+    cache_stats.decode_us_total += decode_us;
+    if (decode_us > cache_stats.decode_us_max) {
+        cache_stats.decode_us_max = decode_us;
+    }
+
+    const lv_draw_buf_t *decoded = decoder_dsc.decoded;
+    if (decoded == NULL) {
+        ESP_LOGE(CACHE_TAG, "Decoder for %s does not produce a full image", path);
+        lv_image_decoder_close(&decoder_dsc);
+        return NULL;
+    }
+
+    size_t size = decoded->data_size;
+    if (!skn_image_cache_make_room(size)) {
+        ESP_LOGW(CACHE_TAG, "Budget exhausted, %s (%u bytes) not cached", path, (unsigned)size);
+        lv_image_decoder_close(&decoder_dsc);
+        return NULL;
+    }
+    if (slot == NULL) {
+        // make_room may have freed a slot
+        for (int i = 0; i < SKN_IMAGE_CACHE_MAX_ENTRIES && slot == NULL; i++) {
+            if (!cache_entries[i].used) {
+                slot = &cache_entries[i];
+            }
+        }
+    }
+    uint8_t *data = slot ? heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT) : NULL;
+    if (data == NULL) {
+        ESP_LOGE(CACHE_TAG, "No room for %s (%u bytes)", path, (unsigned)size);
+        lv_image_decoder_close(&decoder_dsc);
+        return NULL;
+    }
+
+    memcpy(data, decoded->data, size);
+    strcpy(slot->path, path);
+    slot->dsc.header = decoded->header;
+    slot->dsc.header.flags &= LV_IMAGE_FLAGS_PREMULTIPLIED;
+    slot->dsc.data = data;
+    slot->dsc.data_size = size;
+    slot->data = data;
+    slot->size = size;
+    slot->refs = 1;
+    slot->last_use = ++cache_clock;
+    slot->used = true;
+    lv_image_decoder_close(&decoder_dsc);
+
+    cache_stats.bytes_used += size;
+    cache_stats.entries++;
+    ESP_LOGI(CACHE_TAG, "Decoded %s: %ux%u, %u bytes in %lu us", path,
+             slot->dsc.header.w, slot->dsc.header.h, (unsigned)size, decode_us);
+
+    return &slot->dsc;
+}
+
+/**
+ * @brief Drop a reference taken by skn_image_cache_acquire()
+ *
+ * The image stays cached and becomes a candidate for eviction.
+ */
+void skn_image_cache_release(const lv_image_dsc_t *dsc)
+{
+    for (int i = 0; i < SKN_IMAGE_CACHE_MAX_ENTRIES; i++) {
+        if (cache_entries[i].used && &cache_entries[i].dsc == dsc) {
+            if (cache_entries[i].refs > 0) {
+                cache_entries[i].refs--;
+            }
+            return;
+        }
+    }
+}
+
+void skn_image_cache_get_stats(skn_image_cache_stats_t *stats)
+{
+    *stats = cache_stats;
+}
+
+void skn_image_cache_log_stats(void)
+{
+    uint32_t lookups = cache_stats.hits + cache_stats.misses;
+
+    ESP_LOGI(CACHE_TAG, "Image cache: %u entries, %u/%u bytes, hits %lu, misses %lu (%lu%% hit), evictions %lu",
+             cache_stats.entries, (unsigned)cache_stats.bytes_used, (unsigned)cache_stats.bytes_budget,
+             cache_stats.hits, cache_stats.misses,
+             lookups ? (cache_stats.hits * 100) / lookups : 0, cache_stats.evictions);
+    ESP_LOGI(CACHE_TAG, "Image decode: avg %lu us, max %lu us",
+             cache_stats.misses ? cache_stats.decode_us_total / cache_stats.misses : 0,
+             cache_stats.decode_us_max);
+}
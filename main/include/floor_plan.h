@@ -0,0 +1,8 @@
+// floor_plan.h
+#pragma once
+
+#include "lvgl.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+bool skn_floor_plan_build(lv_obj_t *screen, uint8_t step);
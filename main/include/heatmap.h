@@ -0,0 +1,6 @@
+// heatmap.h
+#pragma once
+
+#include "lvgl.h"
+
+lv_obj_t *lv_radar_heatmap_create(lv_obj_t *radar);
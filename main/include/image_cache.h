@@ -0,0 +1,26 @@
+// image_cache.h
+#pragma once
+
+#include "esp_err.h"
+#include "lvgl.h"
+
+/**
+ * @brief Counters describing the decoded image cache
+ */
+typedef struct
+{
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t decode_us_total; // Accumulated decode time of all misses
+    uint32_t decode_us_max;   // Slowest single decode
+    size_t bytes_used;
+    size_t bytes_budget;
+    uint16_t entries;
+} skn_image_cache_stats_t;
+
+esp_err_t skn_image_cache_init(size_t budget_bytes);
+const lv_image_dsc_t *skn_image_cache_acquire(const char *path);
+void skn_image_cache_release(const lv_image_dsc_t *dsc);
+void skn_image_cache_get_stats(skn_image_cache_stats_t *stats);
+void skn_image_cache_log_stats(void);
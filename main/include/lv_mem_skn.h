@@ -0,0 +1,37 @@
+// lv_mem_skn.h
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief LVGL allocator arenas
+ *
+ * Everything from lv_malloc() lives in the large PSRAM arena; only layer draw
+ * buffers, which never outlive a frame, prefer the internal-RAM arena.
+ */
+typedef enum
+{
+    SKN_LV_ARENA_PSRAM = 0,
+    SKN_LV_ARENA_INTERNAL,
+    SKN_LV_ARENA_COUNT
+} skn_lv_arena_t;
+
+/**
+ * @brief Usage snapshot of one arena
+ */
+typedef struct
+{
+    size_t total;
+    size_t free;
+    size_t high_water;    // Peak bytes in use since boot
+    size_t largest_free;
+    uint32_t allocations; // Successful lv_malloc/lv_realloc served
+    uint32_t fallbacks;   // Requests this arena could not serve
+    uint8_t frag_pct;     // 100 - largest_free / free
+} skn_lv_arena_stats_t;
+
+void skn_lv_mem_init_draw_bufs(void);
+void skn_lv_mem_get_stats(skn_lv_arena_t arena, skn_lv_arena_stats_t *stats);
+void skn_lv_mem_log_stats(void);
@@ -0,0 +1,23 @@
+// marker_sprites.h
+#pragma once
+
+#include "esp_err.h"
+#include "lvgl.h"
+#include <stdint.h>
+
+#define SKN_SPRITE_SZ         24 // Square sprite edge in pixels
+#define SKN_SPRITE_TRACKS     4  // Distinct track colours
+#define SKN_SPRITE_HEADINGS   8  // Heading arrows in 45 degree steps
+#define SKN_SPRITE_NO_HEADING 0xFF
+
+typedef enum
+{
+    SKN_SPRITE_IDLE = 0, // Plain body, target not moving
+    SKN_SPRITE_SLOW,     // Body with heading arrow
+    SKN_SPRITE_FAST      // Body, heading arrow and speed ring
+} skn_sprite_speed_t;
+
+esp_err_t skn_sprites_init(void);
+const lv_image_dsc_t *skn_sprite_get(uint8_t track, uint8_t heading, skn_sprite_speed_t speed);
+uint8_t skn_sprite_heading(int32_t dx_mm, int32_t dy_mm);
+skn_sprite_speed_t skn_sprite_speed_class(int16_t speed_mms);
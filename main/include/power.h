@@ -0,0 +1,29 @@
+// power.h
+#pragma once
+
+#include "esp_err.h"
+#include "lvgl.h"
+#include <stdint.h>
+
+typedef enum
+{
+    SKN_POWER_ACTIVE = 0, // Full brightness, refresh rate and CPU clock
+    SKN_POWER_IDLE,       // Nobody detected for CONFIG_SKN_IDLE_TIMEOUT_S
+    SKN_POWER_STATES
+} skn_power_state_t;
+
+typedef enum
+{
+    SKN_POWER_BOOST_RENDER = 0, // LVGL rendering and flushing a frame
+    SKN_POWER_BOOST_SENSOR,     // Parsing and distributing a sensor report
+    SKN_POWER_BOOSTS
+} skn_power_boost_t;
+
+esp_err_t skn_power_init(void);
+void skn_power_boost_begin(skn_power_boost_t who);
+void skn_power_boost_end(skn_power_boost_t who);
+esp_err_t skn_backlight_init(void);
+void skn_backlight_set(uint8_t percent);
+void skn_power_governor_start(lv_obj_t *radar);
+skn_power_state_t skn_power_state(void);
+void skn_power_log(void);
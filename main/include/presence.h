@@ -0,0 +1,59 @@
+// presence.h
+#pragma once
+
+#include "radar_targets.h"
+#include <stdint.h>
+
+#define SKN_PRESENCE_MAX_ZONES 8
+
+typedef enum
+{
+    SKN_PRESENCE_ENTER = 1,
+    SKN_PRESENCE_EXIT,
+    SKN_PRESENCE_DWELL,
+    SKN_PRESENCE_APPROACH
+} skn_presence_event_type_t;
+
+/**
+ * @brief Discrete presence event emitted on a zone state edge
+ */
+typedef struct
+{
+    uint8_t type;          // skn_presence_event_type_t
+    uint8_t zone;
+    uint8_t slot;          // Sensor target slot that caused the edge
+    uint16_t distance_mm;
+    uint32_t duration_ms;  // Occupied time for EXIT/DWELL
+    int64_t timestamp_us;
+} skn_presence_event_t;
+
+/**
+ * @brief Per-zone debounce and hysteresis settings
+ */
+typedef struct
+{
+    uint8_t enter_frames;    // Consecutive frames inside before ENTER
+    uint16_t exit_hold_ms;   // Time empty before EXIT
+    uint32_t dwell_ms;       // Period of DWELL events while occupied, 0 disables
+    uint16_t approach_mm;    // Distance that triggers APPROACH, 0 disables
+    uint16_t hysteresis_mm;  // Extra margin a target must move out before it counts as gone
+} skn_presence_zone_params_t;
+
+/**
+ * @brief Zone membership test
+ *
+ * @param target Target to classify
+ * @param occupied_mask Zones currently occupied; those use their hysteresis bounds
+ * @return Bit mask of zones containing the target
+ */
+typedef uint8_t (*skn_presence_classify_fn)(const skn_target_t *target, uint8_t occupied_mask);
+
+void skn_presence_init(skn_presence_classify_fn classify);
+void skn_presence_set_zone_params(uint8_t zone, const skn_presence_zone_params_t *params);
+void skn_presence_get_zone_params(uint8_t zone, skn_presence_zone_params_t *params);
+void skn_presence_process(const skn_target_frame_t *frame);
+void skn_presence_set_range_mm(uint16_t limit_mm);
+uint16_t skn_presence_get_range_mm(void);
+uint8_t skn_presence_classify_range(const skn_target_t *target, uint8_t occupied_mask);
+uint8_t skn_presence_occupied_mask(void);
+const char *skn_presence_event_name(uint8_t type);
@@ -0,0 +1,51 @@
+// radar_geometry.h
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Pure radar geometry shared by the LVGL widgets and the host tests
+ *
+ * Nothing here depends on LVGL or ESP-IDF.
+ */
+
+/**
+ * @brief Angle of one trailing shadow line behind the sweep
+ *
+ * Shadows trail against the direction of travel and pile up at the 0 or 180
+ * degree edge instead of wrapping.
+ *
+ * @param angle Current sweep angle, 0-180 degrees
+ * @param direction +1 sweeping left to right, -1 on playback
+ * @param index Shadow line, 0 is the one closest to the sweep
+ * @param step_deg Angle between shadow lines
+ */
+static inline uint16_t skn_radar_trail_angle(uint16_t angle, int8_t direction, uint8_t index, uint8_t step_deg)
+{
+    int32_t shadow = (int32_t)angle - direction * (index + 1) * step_deg;
+
+    if (shadow < 0) {
+        return 0;
+    }
+    return shadow > 180 ? 180 : (uint16_t)shadow;
+}
+
+#define SKN_RADAR_XFORM_SHIFT 16 // Q16 pixels per millimetre
+
+/**
+ * @brief Pixels per millimetre in Q16 for a radar of radius_px showing range_mm
+ */
+static inline int32_t skn_radar_px_per_mm_q16(int32_t radius_px, uint32_t range_mm)
+{
+    return (int32_t)((((int64_t)radius_px << SKN_RADAR_XFORM_SHIFT) + range_mm / 2) / range_mm);
+}
+
+/**
+ * @brief Scale a sensor distance to a pixel offset, rounded to the nearest pixel
+ */
+static inline int32_t skn_radar_mm_to_px(int32_t mm, int32_t px_per_mm_q16)
+{
+    const int64_t half = 1 << (SKN_RADAR_XFORM_SHIFT - 1);
+
+    return (int32_t)(((int64_t)mm * px_per_mm_q16 + half) >> SKN_RADAR_XFORM_SHIFT);
+}
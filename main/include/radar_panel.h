@@ -1,8 +1,17 @@
 // radar_panel.h
 #pragma once
 
+#include "lvgl.h"
+#include "radar_targets.h"
+#include "zones.h"
+
+#define LV_RADAR_SWEEP_MAX_TRAIL 8
+#define LV_RADAR_MAX_MARKERS     SKN_MAX_TARGETS
+
 /**
  * @brief Structure to hold radar sweep state
+ *
+ * Every line owns its point array: lv_line keeps the pointer it is given.
  */
 typedef struct
 {
@@ -11,8 +20,16 @@ typedef struct
     int16_t center_y;
     int16_t radius;
     uint16_t current_angle;
+    int8_t direction;  // +1 sweeping left to right, -1 on playback
+    uint8_t trail_len; // Shadow lines in use
     lv_obj_t *sweep_line;
-    lv_obj_t *shadow_lines[5]; // Array for trailing shadow lines
+    lv_obj_t *shadow_lines[LV_RADAR_SWEEP_MAX_TRAIL]; // Array for trailing shadow lines
+    lv_point_precise_t sweep_points[2];
+    lv_point_precise_t shadow_points[LV_RADAR_SWEEP_MAX_TRAIL][2];
+    lv_timer_t *timer;    // Steps the sweep every CONFIG_SKN_SWEEP_PERIOD_MS
+    uint32_t duration_ms; // One pass across the field
+    uint32_t start_tick;
+    bool loop;
 } lv_radar_sweep_t;
 
 /**
@@ -21,14 +38,33 @@ typedef struct
 typedef struct
 {
     lv_obj_t *icon;
-    float distance;  // Distance in meters
-    uint16_t angle;  // Angle in degrees (0-180)
+    int16_t x_mm;    // Position in sensor millimetres
+    int16_t y_mm;
+    uint8_t track;   // Sprite colour index
+    uint8_t heading; // Sprite heading 0-7, SKN_SPRITE_NO_HEADING when unknown
+    int16_t speed_mms;
+    const lv_image_dsc_t *sprite; // Sprite currently shown
 } lv_radar_marker_t;
 
+extern const lv_obj_class_t lv_radar_class;
+
+lv_obj_t *lv_radar_create(lv_obj_t *parent);
+void lv_radar_set_range(lv_obj_t *obj, uint16_t range_mm);
+uint16_t lv_radar_get_range(const lv_obj_t *obj);
+void lv_radar_set_auto_range(lv_obj_t *obj, bool enable);
+void lv_radar_set_targets(lv_obj_t *obj, const skn_target_frame_t *frame);
+void lv_radar_set_live(lv_obj_t *obj, bool enable);
+uint32_t lv_radar_geometry_event(void);
+void lv_radar_mm_to_point(const lv_obj_t *obj, int16_t x_mm, int16_t y_mm, lv_point_t *point);
+void lv_radar_point_to_mm(const lv_obj_t *obj, const lv_point_t *point, int16_t *x_mm, int16_t *y_mm);
+
 lv_obj_t *lv_radar_screen_create(lv_obj_t *parent, int16_t width, int16_t height);
 lv_radar_sweep_t *lv_radar_sweep_create(lv_obj_t *parent, uint32_t duration_ms, bool loop);
+void lv_radar_set_sweep_running(lv_obj_t *obj, bool run);
+void lv_radar_sweep_update(lv_radar_sweep_t *sweep, uint16_t angle);
 void lv_radar_sweep_delete(lv_radar_sweep_t *sweep);
-void lv_radar_add_markers(lv_obj_t *parent,  uint8_t band_count, lv_radar_marker_t *markers, uint8_t marker_count);
-void lv_radar_update_markers(uint8_t band_count, lv_radar_marker_t *markers, uint8_t marker_count);
-void lv_radar_remove_markers(lv_radar_marker_t *markers, uint8_t marker_count);
-void lv_radar_panel_init(int16_t xRes, int16_t yRes);
\ No newline at end of file
+void lv_radar_update_markers(lv_obj_t *obj, lv_radar_marker_t *markers, uint8_t marker_count);
+void lv_radar_zones_draw(lv_obj_t *obj);
+void lv_radar_zone_overlay_set(lv_obj_t *obj, uint8_t index, const skn_zone_t *zone);
+void lv_radar_zone_overlay_update(lv_obj_t *obj, uint8_t index);
+bool lv_radar_panel_build(lv_obj_t *scr, uint8_t step);
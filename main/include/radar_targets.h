@@ -0,0 +1,31 @@
+// radar_targets.h
+#pragma once
+
+#include <stdint.h>
+
+#define SKN_MAX_TARGETS 3 // RD-03D tracks up to 3 targets
+
+/**
+ * @brief One tracked target in sensor coordinates
+ */
+typedef struct
+{
+    int16_t x_mm;         // Lateral offset, positive to the right of the sensor
+    int16_t y_mm;         // Distance in front of the sensor
+    int16_t speed_mms;    // Signed speed reported by the sensor
+    uint16_t distance_mm;
+} skn_target_t;
+
+/**
+ * @brief All targets reported by one sensor update
+ */
+typedef struct
+{
+    uint32_t seq;
+    int64_t timestamp_us; // esp_timer time the frame was parsed
+    uint8_t count;
+    skn_target_t targets[SKN_MAX_TARGETS];
+} skn_target_frame_t;
+
+void skn_targets_publish(const skn_target_frame_t *frame);
+uint32_t skn_targets_latest(skn_target_frame_t *frame);
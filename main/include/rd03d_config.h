@@ -0,0 +1,45 @@
+// rd03d_config.h
+#pragma once
+
+#include "driver/uart.h"
+#include "esp_err.h"
+#include "radar_targets.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SKN_RD03D_CMD_READ_VERSION  0x0000
+#define SKN_RD03D_CMD_SINGLE_TARGET 0x0080
+#define SKN_RD03D_CMD_MULTI_TARGET  0x0090
+#define SKN_RD03D_CMD_END_CONFIG    0x00FE
+#define SKN_RD03D_CMD_ENABLE_CONFIG 0x00FF
+#define SKN_RD03D_ACK_MAX           32
+
+/**
+ * @brief Sensor configuration, persisted in NVS and applied at boot
+ */
+typedef struct
+{
+    bool multi_target;      // Track up to three targets instead of the strongest one
+    uint16_t min_mm;        // Range gate: targets closer than this are dropped
+    uint16_t max_mm;        // Range gate: targets farther than this are dropped
+    uint8_t half_angle_deg; // Angle gate either side of boresight, 90 disables it
+    uint32_t tan_q16;       // tan(half_angle_deg) in Q16, derived by skn_rd03d_load_config(), never stored
+} skn_rd03d_config_t;
+
+/**
+ * @brief What the module reported while being configured
+ */
+typedef struct
+{
+    uint16_t protocol;      // From the enable-configuration ACK
+    uint16_t buffer_size;
+    char firmware[24];      // e.g. "V1.02.22062416", empty when not answered
+} skn_rd03d_info_t;
+
+esp_err_t skn_rd03d_load_config(skn_rd03d_config_t *config);
+esp_err_t skn_rd03d_save_config(const skn_rd03d_config_t *config);
+esp_err_t skn_rd03d_command(uart_port_t port, uint16_t command, const uint8_t *value, size_t value_len,
+                            uint8_t *ack, size_t *ack_len);
+esp_err_t skn_rd03d_apply(uart_port_t port, const skn_rd03d_config_t *config, skn_rd03d_info_t *info);
+bool skn_rd03d_gate(const skn_rd03d_config_t *config, const skn_target_t *target);
@@ -0,0 +1,32 @@
+// screen_manager.h
+#pragma once
+
+#include "lvgl.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum
+{
+    SKN_SCREEN_INTRO = 0,
+    SKN_SCREEN_RADAR,
+    SKN_SCREEN_PLAN,
+    SKN_SCREEN_COUNT
+} skn_screen_id_t;
+
+/**
+ * @brief Build one step of a screen
+ *
+ * Called with step 0, 1, 2, ... on successive idle frames. Each step should
+ * create a small, bounded part of the screen.
+ *
+ * @param screen The screen object, created by the manager
+ * @param step Step number
+ * @return true once the screen is complete
+ */
+typedef bool (*skn_screen_build_cb_t)(lv_obj_t *screen, uint8_t step);
+
+void skn_screen_manager_init(lv_display_t *disp);
+void skn_screen_register(skn_screen_id_t id, const char *name, skn_screen_build_cb_t build, bool resident);
+void skn_screen_preload(skn_screen_id_t id);
+void skn_screen_show(skn_screen_id_t id);
+lv_obj_t *skn_screen_switch_add(lv_obj_t *screen, skn_screen_id_t target, const char *text);
@@ -0,0 +1,26 @@
+// sensor_fusion.h
+#pragma once
+
+#include "radar_targets.h"
+#include <stdint.h>
+
+#define SKN_MAX_SENSORS 2 // ESP32-S3 has two UARTs besides the console
+
+/**
+ * @brief Where a sensor is mounted in the room frame
+ *
+ * The room frame is the first sensor's frame when it sits at the origin with
+ * no yaw: x to the right, y away from the wall.
+ */
+typedef struct
+{
+    int16_t x_mm;    // Sensor position in the room
+    int16_t y_mm;
+    int16_t cos_q14; // Boresight rotation, counter-clockwise seen from above
+    int16_t sin_q14;
+} skn_sensor_pose_t;
+
+void skn_fusion_pose_init(skn_sensor_pose_t *pose, int16_t x_mm, int16_t y_mm, int16_t yaw_deg);
+void skn_fusion_to_room(const skn_sensor_pose_t *pose, skn_target_frame_t *frame);
+uint32_t skn_fusion_merge(const skn_target_frame_t *frames, uint8_t frame_count, int64_t now_us,
+                          skn_target_frame_t *out);
@@ -0,0 +1,14 @@
+// target_stream.h
+#pragma once
+
+#include "esp_err.h"
+#include "presence.h"
+#include "radar_targets.h"
+
+#define SKN_STREAM_MAGIC       0x524E4B53 // "SKNR" little-endian
+#define SKN_STREAM_EVENT_MAGIC 0x454E4B53 // "SKNE" little-endian
+#define SKN_STREAM_VERSION     1
+
+esp_err_t skn_stream_start(void);
+void skn_stream_submit(const skn_target_frame_t *frame);
+void skn_stream_submit_event(const skn_presence_event_t *event);
@@ -0,0 +1,63 @@
+// telemetry.h
+#pragma once
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SKN_TELEMETRY_MAX_TASKS      24
+#define SKN_TELEMETRY_RENDER_BUCKETS 64  // Render-time histogram buckets
+#define SKN_TELEMETRY_RENDER_BUCKET_US 500
+
+/**
+ * @brief Per-task figures over the last collection period
+ */
+typedef struct
+{
+    char name[configMAX_TASK_NAME_LEN];
+    uint8_t core;          // Core affinity, 0/1, or 2 for no affinity
+    uint8_t priority;
+    uint16_t cpu_permille; // Share of one core, 0-1000
+    uint32_t stack_free;   // Stack high-water mark: minimum free bytes ever
+} skn_task_metrics_t;
+
+/**
+ * @brief Fixed-size metrics snapshot, refreshed every collection period
+ */
+typedef struct
+{
+    uint32_t seq;
+    int64_t timestamp_us;
+    uint32_t period_ms;
+    uint16_t task_count;
+    uint16_t tasks_running;    // Tasks alive; task figures are skipped above SKN_TELEMETRY_MAX_TASKS
+    uint16_t idle_permille[2]; // Idle share per core, 0-1000
+    skn_task_metrics_t tasks[SKN_TELEMETRY_MAX_TASKS];
+    uint32_t heap_internal_free;
+    uint32_t heap_internal_min;
+    uint32_t heap_psram_free;
+    uint32_t heap_psram_min;
+    uint16_t fps_x10;          // Rendered frames per second x10
+    uint16_t ui_frames_x10;    // Sensor frames applied by the UI per second x10
+    uint32_t redraw_kpx;       // Thousands of pixels flushed per second
+    uint32_t sensor_wake_avg_us; // Sensor task wakeup lateness versus its schedule
+    uint32_t sensor_wake_max_us;
+    uint32_t render_avg_us;
+    uint32_t render_max_us;
+    uint32_t render_p50_us;    // Percentiles at bucket resolution
+    uint32_t render_p95_us;
+    uint32_t render_p99_us;
+} skn_telemetry_t;
+
+esp_err_t skn_telemetry_start(void);
+void skn_telemetry_render_begin(void);
+void skn_telemetry_render_end(void);
+void skn_telemetry_flush(uint32_t pixels);
+void skn_telemetry_ui_frame(void);
+void skn_telemetry_sensor_wake(int64_t late_us);
+void skn_telemetry_get(skn_telemetry_t *out);
+uint32_t skn_telemetry_get_idle(uint16_t idle_permille[2]);
+void skn_telemetry_log(void);
+int skn_telemetry_to_json(char *buf, size_t len);
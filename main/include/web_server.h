@@ -0,0 +1,8 @@
+// web_server.h
+#pragma once
+
+#include "esp_err.h"
+#include "radar_targets.h"
+
+esp_err_t skn_web_start(void);
+void skn_web_submit(const skn_target_frame_t *frame);
@@ -0,0 +1,8 @@
+// zone_editor.h
+#pragma once
+
+#include "lvgl.h"
+#include <stdbool.h>
+
+bool lv_radar_zone_editor_create(lv_obj_t *radar);
+bool lv_radar_zone_editor_active(void);
@@ -0,0 +1,41 @@
+// zones.h
+#pragma once
+
+#include "esp_err.h"
+#include "presence.h"
+#include "radar_targets.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SKN_ZONE_MAX_ZONES    SKN_PRESENCE_MAX_ZONES
+#define SKN_ZONE_MAX_VERTICES 8
+#define SKN_ZONE_NAME_LEN     12
+
+/**
+ * @brief Polygon vertex in sensor coordinates
+ */
+typedef struct
+{
+    int16_t x_mm;
+    int16_t y_mm;
+} skn_zone_point_t;
+
+/**
+ * @brief User-defined detection zone, persisted in NVS
+ */
+typedef struct
+{
+    uint8_t vertex_count; // 0 marks an unused zone
+    uint8_t sensitivity;  // 1 (sluggish) .. 10 (twitchy)
+    char name[SKN_ZONE_NAME_LEN];
+    skn_zone_point_t vertices[SKN_ZONE_MAX_VERTICES];
+} skn_zone_t;
+
+esp_err_t skn_zones_init(void);
+void skn_zones_get(uint8_t index, skn_zone_t *zone);
+esp_err_t skn_zones_set(uint8_t index, const skn_zone_t *zone);
+esp_err_t skn_zones_save(uint8_t index);
+esp_err_t skn_zones_save_range(void);
+uint8_t skn_zones_active_mask(void);
+uint8_t skn_zones_lookup(int16_t x_mm, int16_t y_mm, uint8_t occupied_mask);
+uint8_t skn_zones_classify(const skn_target_t *target, uint8_t occupied_mask);
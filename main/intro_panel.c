@@ -5,18 +5,38 @@
  */
 
 #include <math.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
 #include "esp_lv_decoder.h"
+#include "esp_mmap_assets.h"
+#include "esp_timer.h"
 #include "lvgl.h"
+#include "image_cache.h"
 
 #ifndef PI
 #define PI  (3.14159f)
 #endif
 
+#define INTRO_ASSETS_PARTITION  "assets"
+#define INTRO_ASSETS_MAX_FILES  2
+#define INTRO_LOGO_ASSET        "skoona-devel-icon.bin"
+#define INTRO_TEXT_ASSET        "skoonallc.bin"
+
+static const char *INTRO_TAG = "Intro";
+
 typedef struct {
     lv_obj_t *scr;
     int count_val;
 } anim_timer_context_t;
 
+static mmap_assets_handle_t intro_assets = NULL;
+static lv_image_dsc_t img_logo_dsc;
+static lv_image_dsc_t img_text_dsc;
+static const lv_image_dsc_t *intro_cached[INTRO_ASSETS_MAX_FILES]; // Released with the screen
+static uint8_t intro_cached_count = 0;
+static lv_timer_t *intro_timer = NULL;
+
 static lv_obj_t *arc[3];
 static lv_obj_t *img_logo;
 static lv_obj_t *img_text;
@@ -26,6 +46,92 @@ static lv_color_t arc_color[] = {
     LV_COLOR_MAKE(90, 202, 228),
 };
 
+/**
+ * @brief Decode a SPIFFS PNG once through the PSRAM image cache
+ */
+static const void *intro_fallback_src(const char *fallback)
+{
+    const lv_image_dsc_t *cached = skn_image_cache_acquire(fallback);
+    if (cached == NULL) {
+        return fallback;
+    }
+    if (intro_cached_count < INTRO_ASSETS_MAX_FILES) {
+        intro_cached[intro_cached_count++] = cached;
+    }
+    return cached;
+}
+
+/**
+ * @brief Intro screen deleted: stop the animation and release cached PNGs
+ *
+ * The intro is not resident, so its decoded images become evictable once it
+ * has been left.
+ */
+static void intro_delete_cb(lv_event_t *e)
+{
+    if (intro_timer != NULL) {
+        lv_timer_delete(intro_timer);
+        intro_timer = NULL;
+    }
+    for (uint8_t i = 0; i < intro_cached_count; i++) {
+        skn_image_cache_release(intro_cached[i]);
+    }
+    intro_cached_count = 0;
+}
+
+/**
+ * @brief Resolve an intro image from the memory-mapped assets partition
+ *
+ * The partition holds LVGL native RGB565A8 blobs produced by tools/png2lvgl.py,
+ * so the descriptor points straight into flash and LVGL draws it without a
+ * decoder. Falls back to the SPIFFS PNG when the asset is missing.
+ *
+ * @param name Asset file name inside the partition
+ * @param dsc Descriptor to fill in
+ * @param fallback LVGL path of the original PNG
+ * @return Image source suitable for lv_image_set_src()
+ */
+static const void *intro_asset_src(const char *name, lv_image_dsc_t *dsc, const char *fallback)
+{
+    if (intro_assets == NULL) {
+        const mmap_assets_config_t config = {
+            .partition_label = INTRO_ASSETS_PARTITION,
+            .max_files = INTRO_ASSETS_MAX_FILES,
+            .flags = {
+                .mmap_enable = true,
+            },
+        };
+        if (mmap_assets_new(&config, &intro_assets) != ESP_OK) {
+            ESP_LOGW(INTRO_TAG, "Assets partition unavailable, decoding PNGs from SPIFFS");
+            intro_assets = NULL;
+            return intro_fallback_src(fallback);
+        }
+    }
+
+    int files = mmap_assets_get_stored_files(intro_assets);
+    for (int i = 0; i < files; i++) {
+        if (strcmp(mmap_assets_get_name(intro_assets, i), name) != 0) {
+            continue;
+        }
+        const uint8_t *mem = mmap_assets_get_mem(intro_assets, i);
+        int size = mmap_assets_get_size(intro_assets, i);
+        if (mem == NULL || size <= (int)sizeof(lv_image_header_t)) {
+            break;
+        }
+
+        memcpy(&dsc->header, mem, sizeof(lv_image_header_t));
+        if (dsc->header.magic != LV_IMAGE_HEADER_MAGIC) {
+            break;
+        }
+        dsc->data = mem + sizeof(lv_image_header_t);
+        dsc->data_size = size - sizeof(lv_image_header_t);
+        return dsc;
+    }
+
+    ESP_LOGW(INTRO_TAG, "Asset %s not found, decoding %s", name, fallback);
+    return intro_fallback_src(fallback);
+}
+
 static void anim_timer_cb(lv_timer_t *timer)
 {
     anim_timer_context_t *timer_ctx = (anim_timer_context_t *) lv_timer_get_user_data(timer);
@@ -51,7 +157,7 @@ static void anim_timer_cb(lv_timer_t *timer)
 
         // Create new image and make it transparent
         img_text = lv_img_create(scr);
-		lv_img_set_src(img_text, "S:/spiffs/skoonallc.png"); 
+		lv_img_set_src(img_text, intro_asset_src(INTRO_TEXT_ASSET, &img_text_dsc, "S:/spiffs/skoonallc.png"));
 		lv_obj_set_style_img_opa(img_text, 0, 0);
     }
 
@@ -66,19 +172,21 @@ static void anim_timer_cb(lv_timer_t *timer)
     // Delete timer when all animation finished
     if ((count += 5) == 220) {
         lv_timer_del(timer);
+        intro_timer = NULL;
     } else {
         timer_ctx->count_val = count;
     }
 }
 
-void ui_skoona_panel_init(void) {
-    lv_obj_t *scr = lv_obj_create(NULL);
-    lv_obj_clean(scr);
-    lv_screen_load(scr);
+/**
+ * @brief Build the intro screen for the screen manager, in a single step
+ */
+bool ui_skoona_panel_build(lv_obj_t *scr, uint8_t step) {
+    int64_t start_us = esp_timer_get_time();
 
     // Create image
     img_logo = lv_img_create(scr);
-	lv_img_set_src(img_logo, "S:/spiffs/skoona-devel-icon.png"); 
+	lv_img_set_src(img_logo, intro_asset_src(INTRO_LOGO_ASSET, &img_logo_dsc, "S:/spiffs/skoona-devel-icon.png"));
 	lv_image_set_scale(img_logo, 448);
     lv_obj_center(img_logo);
 
@@ -105,5 +213,11 @@ void ui_skoona_panel_init(void) {
 		.count_val = -90,
     };
 	anim_timer_context.scr = scr;
-	lv_timer_create(anim_timer_cb, 20, &anim_timer_context);
+	intro_timer = lv_timer_create(anim_timer_cb, 20, &anim_timer_context);
+	lv_obj_add_event_cb(scr, intro_delete_cb, LV_EVENT_DELETE, NULL);
+
+    ESP_LOGI(INTRO_TAG, "Intro ready in %lld us, boot at %lld ms, min free heap %u bytes",
+             esp_timer_get_time() - start_us, esp_timer_get_time() / 1000,
+             (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_DEFAULT));
+    return true;
 }
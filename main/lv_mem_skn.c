@@ -0,0 +1,252 @@
+/*
+ * lv_mem_skn.c
+ * LVGL custom allocator (LV_USE_CUSTOM_MALLOC) backed by two TLSF arenas.
+ *
+ * - PSRAM arena: large, serves every lv_malloc(): widgets, styles, draw
+ *   tasks, decoded images and cache entries.
+ * - Internal arena: small, preferred only for draw buffers from LVGL's
+ *   default draw-buffer handler, i.e. layers and intermediate render targets,
+ *   which are freed again before the frame completes. Decoded images use the
+ *   separate image handlers and font glyphs the font handlers, so nothing
+ *   long-lived can pin the internal arena.
+ *
+ * Both arenas are ESP-IDF multi_heap (TLSF) instances carved out of a single
+ * block each, so LVGL churn never fragments the system heaps and each arena
+ * reports its own fragmentation and high-water mark.
+ *
+ * LVGL is only called with lv_lock() held, which also serializes this module.
+ */
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "multi_heap.h"
+#include "lvgl.h"
+#include <string.h>
+#include "lv_mem_skn.h"
+
+static const char *MEM_TAG = "LvMem";
+
+typedef struct
+{
+    const char *name;
+    uint8_t *base;
+    size_t size;
+    multi_heap_handle_t heap;
+    uint32_t allocations;
+    uint32_t fallbacks;
+} skn_lv_arena_state_t;
+
+static skn_lv_arena_state_t arenas[SKN_LV_ARENA_COUNT] = {
+    [SKN_LV_ARENA_PSRAM] = {.name = "psram"},
+    [SKN_LV_ARENA_INTERNAL] = {.name = "internal"},
+};
+
+static bool skn_lv_arena_create(skn_lv_arena_state_t *arena, size_t size, uint32_t caps)
+{
+    arena->base = heap_caps_malloc(size, caps);
+    if (arena->base == NULL) {
+        ESP_LOGE(MEM_TAG, "Unable to reserve %u bytes for %s arena", (unsigned)size, arena->name);
+        return false;
+    }
+    arena->size = size;
+    arena->heap = multi_heap_register(arena->base, size);
+    return arena->heap != NULL;
+}
+
+static skn_lv_arena_state_t *skn_lv_arena_of(const void *p)
+{
+    for (int i = 0; i < SKN_LV_ARENA_COUNT; i++) {
+        skn_lv_arena_state_t *arena = &arenas[i];
+        if (arena->heap && (const uint8_t *)p >= arena->base && (const uint8_t *)p < arena->base + arena->size) {
+            return arena;
+        }
+    }
+    return NULL;
+}
+
+static void *skn_lv_arena_malloc(skn_lv_arena_state_t *arena, size_t size)
+{
+    if (arena->heap == NULL) {
+        return NULL;
+    }
+    void *p = multi_heap_malloc(arena->heap, size);
+    if (p) {
+        arena->allocations++;
+    } else {
+        arena->fallbacks++;
+    }
+    return p;
+}
+
+/**
+ * @brief Draw buffers for layers: internal RAM first, PSRAM when it is full
+ *
+ * Mirrors LVGL's default handler, which over-allocates so the buffer can be
+ * aligned to LV_DRAW_BUF_ALIGN; lv_free_core() finds the owning arena.
+ */
+static void *skn_lv_draw_buf_malloc(size_t size, lv_color_format_t cf)
+{
+    LV_UNUSED(cf);
+    size += LV_DRAW_BUF_ALIGN - 1;
+
+    void *p = skn_lv_arena_malloc(&arenas[SKN_LV_ARENA_INTERNAL], size);
+    if (p == NULL) {
+        p = skn_lv_arena_malloc(&arenas[SKN_LV_ARENA_PSRAM], size);
+    }
+    return p;
+}
+
+/**
+ * @brief Route layer draw buffers to the internal arena; call after lv_init()
+ *
+ * lv_init() installs the default draw-buffer handlers after lv_mem_init(),
+ * so this cannot happen in lv_mem_init() itself.
+ */
+void skn_lv_mem_init_draw_bufs(void)
+{
+    lv_draw_buf_get_handlers()->buf_malloc_cb = skn_lv_draw_buf_malloc;
+}
+
+void lv_mem_init(void)
+{
+    skn_lv_arena_create(&arenas[SKN_LV_ARENA_PSRAM], CONFIG_SKN_LV_MEM_PSRAM_KB * 1024,
+                        MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    skn_lv_arena_create(&arenas[SKN_LV_ARENA_INTERNAL], CONFIG_SKN_LV_MEM_INTERNAL_KB * 1024,
+                        MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+}
+
+void lv_mem_deinit(void)
+{
+    for (int i = 0; i < SKN_LV_ARENA_COUNT; i++) {
+        heap_caps_free(arenas[i].base);
+        arenas[i].base = NULL;
+        arenas[i].heap = NULL;
+        arenas[i].size = 0;
+    }
+}
+
+lv_mem_pool_t lv_mem_add_pool(void *mem, size_t bytes)
+{
+    LV_UNUSED(mem);
+    LV_UNUSED(bytes);
+    return NULL;
+}
+
+void lv_mem_remove_pool(lv_mem_pool_t pool)
+{
+    LV_UNUSED(pool);
+}
+
+void *lv_malloc_core(size_t size)
+{
+    return skn_lv_arena_malloc(&arenas[SKN_LV_ARENA_PSRAM], size);
+}
+
+void *lv_realloc_core(void *p, size_t new_size)
+{
+    if (p == NULL) {
+        return lv_malloc_core(new_size);
+    }
+
+    skn_lv_arena_state_t *arena = skn_lv_arena_of(p);
+    if (arena == NULL) {
+        return NULL;
+    }
+
+    void *resized = multi_heap_realloc(arena->heap, p, new_size);
+    if (resized) {
+        arena->allocations++;
+        return resized;
+    }
+    arena->fallbacks++;
+
+    // Owning arena is full: move the block to the PSRAM arena, the only one
+    // lv_malloc_core() serves; a full PSRAM arena fails here as well
+    resized = lv_malloc_core(new_size);
+    if (resized) {
+        size_t old_size = multi_heap_get_allocated_size(arena->heap, p);
+        memcpy(resized, p, old_size < new_size ? old_size : new_size);
+        multi_heap_free(arena->heap, p);
+    }
+    return resized;
+}
+
+void lv_free_core(void *p)
+{
+    skn_lv_arena_state_t *arena = skn_lv_arena_of(p);
+    if (arena) {
+        multi_heap_free(arena->heap, p);
+    }
+}
+
+void skn_lv_mem_get_stats(skn_lv_arena_t which, skn_lv_arena_stats_t *stats)
+{
+    skn_lv_arena_state_t *arena = &arenas[which];
+    multi_heap_info_t info = {0};
+
+    memset(stats, 0, sizeof(*stats));
+    if (arena->heap == NULL) {
+        return;
+    }
+    multi_heap_get_info(arena->heap, &info);
+
+    stats->total = info.total_free_bytes + info.total_allocated_bytes;
+    stats->free = info.total_free_bytes;
+    stats->high_water = stats->total - info.minimum_free_bytes;
+    stats->largest_free = info.largest_free_block;
+    stats->allocations = arena->allocations;
+    stats->fallbacks = arena->fallbacks;
+    stats->frag_pct = info.total_free_bytes ? 100 - (info.largest_free_block * 100) / info.total_free_bytes : 0;
+}
+
+void lv_mem_monitor_core(lv_mem_monitor_t *mon_p)
+{
+    skn_lv_arena_stats_t stats;
+
+    memset(mon_p, 0, sizeof(*mon_p));
+    for (int i = 0; i < SKN_LV_ARENA_COUNT; i++) {
+        multi_heap_info_t info = {0};
+        if (arenas[i].heap == NULL) {
+            continue;
+        }
+        multi_heap_get_info(arenas[i].heap, &info);
+        skn_lv_mem_get_stats(i, &stats);
+
+        mon_p->total_size += stats.total;
+        mon_p->free_size += stats.free;
+        mon_p->max_used += stats.high_water;
+        mon_p->free_cnt += info.free_blocks;
+        mon_p->used_cnt += info.allocated_blocks;
+        if (stats.largest_free > mon_p->free_biggest_size) {
+            mon_p->free_biggest_size = stats.largest_free;
+        }
+    }
+    if (mon_p->total_size) {
+        mon_p->used_pct = 100 - (mon_p->free_size * 100) / mon_p->total_size;
+    }
+    if (mon_p->free_size) {
+        mon_p->frag_pct = 100 - (mon_p->free_biggest_size * 100) / mon_p->free_size;
+    }
+}
+
+lv_result_t lv_mem_test_core(void)
+{
+    for (int i = 0; i < SKN_LV_ARENA_COUNT; i++) {
+        if (arenas[i].heap && !multi_heap_check(arenas[i].heap, true)) {
+            return LV_RESULT_INVALID;
+        }
+    }
+    return LV_RESULT_OK;
+}
+
+void skn_lv_mem_log_stats(void)
+{
+    skn_lv_arena_stats_t stats;
+
+    for (int i = 0; i < SKN_LV_ARENA_COUNT; i++) {
+        skn_lv_mem_get_stats(i, &stats);
+        ESP_LOGI(MEM_TAG, "LVGL %-8s arena: free %u/%u, high-water %u, largest %u, frag %u%%, allocs %lu, fallbacks %lu",
+                 arenas[i].name, (unsigned)stats.free, (unsigned)stats.total, (unsigned)stats.high_water,
+                 (unsigned)stats.largest_free, stats.frag_pct, stats.allocations, stats.fallbacks);
+    }
+}
@@ -24,9 +24,17 @@
 #include <string.h>
 #include <sys/stat.h>
 #include "wifi_network.h"
+#include "image_cache.h"
+#include "lv_mem_skn.h"
+#include "telemetry.h"
+#include "target_stream.h"
+#include "web_server.h"
+#include "presence.h"
+#include "zones.h"
+#include "power.h"
 
-#define SKN_LVGL_PRIORITY 4
 #define SKN_LVGL_STACK_SZ 9216 // 8192
+#define SKN_SENSOR_STACK_SZ 4096
 #define BEEP_DURATION_MS 500
 
 #define BUZZER_GPIO   20
@@ -139,16 +147,15 @@ void skn_beep(uint32_t duration_ms) {
 	ledc_update_duty(LEDC_MODE, LEDC_CHANNEL);
 }
 void logMemoryStats(char *message) {
-	char buffer[1024] = {0};
-
-	vTaskList(buffer);
-
 	ESP_LOGI(TAG, "[APP] %s...", message);
 	ESP_LOGI(TAG, "[APP] Free memory: %" PRIu32 " bytes", esp_get_free_heap_size());
 	ESP_LOGI(TAG, "Internal free heap size: %ld bytes", esp_get_free_internal_heap_size());
     ESP_LOGI(TAG, "PSRAM    free heap size: %ld bytes", esp_get_free_heap_size() - esp_get_free_internal_heap_size());
     ESP_LOGI(TAG, "Total    free heap size: %ld bytes", esp_get_free_heap_size());
-	ESP_LOGI(TAG, "Task List:\n%s", buffer);
+	skn_telemetry_log();
+	skn_image_cache_log_stats();
+	skn_lv_mem_log_stats();
+	skn_power_log();
 }
 
 void app_main(void) {
@@ -160,13 +167,28 @@ void app_main(void) {
 	esp_log_level_set("transport", ESP_LOG_VERBOSE);
 
 	ESP_ERROR_CHECK(esp_event_loop_create_default());
+	ESP_ERROR_CHECK(skn_telemetry_start());
+	ESP_ERROR_CHECK(skn_power_init());
 
 	ESP_ERROR_CHECK(skn_wifi_service());
+	// The network stream is optional; the display keeps running without it
+	if (skn_stream_start() != ESP_OK) {
+		ESP_LOGW(TAG, "Target stream unavailable, continuing without it");
+	}
+
+	skn_presence_init(skn_zones_classify);
+	ESP_ERROR_CHECK(skn_zones_init());
+
 	ESP_ERROR_CHECK(skn_spiffs_mount());
+	// So is the web view
+	if (skn_web_start() != ESP_OK) {
+		ESP_LOGW(TAG, "Web server unavailable, continuing without it");
+	}
 	ESP_ERROR_CHECK(skn_beep_init());
 	
-	xTaskCreatePinnedToCore(vDisplayServiceTask, "SKN Display", SKN_LVGL_STACK_SZ, NULL, (SKN_LVGL_PRIORITY), NULL, 0);
-	xTaskCreatePinnedToCore(sensor_task, "RD-03D Sensor", 4096, NULL, 8, NULL, tskNO_AFFINITY );
+	// Task topology: LVGL render/flush own the UI core, sensor ingest and networking share the IO core with WiFi
+	xTaskCreatePinnedToCore(vDisplayServiceTask, "SKN Display", SKN_LVGL_STACK_SZ, NULL, CONFIG_SKN_DISPLAY_PRIORITY, NULL, CONFIG_SKN_UI_CORE);
+	xTaskCreatePinnedToCore(sensor_task, "RD-03D Sensor", SKN_SENSOR_STACK_SZ, NULL, CONFIG_SKN_SENSOR_PRIORITY, NULL, CONFIG_SKN_IO_CORE);
 
 	skn_beep(BEEP_DURATION_MS);
 	logMemoryStats("Startup Complete...");
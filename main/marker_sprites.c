@@ -0,0 +1,201 @@
+/*
+ * marker_sprites.c
+ * Pre-rendered target marker sprites.
+ *
+ * Every marker variant is drawn once at start-up into a single ARGB8888 atlas
+ * in PSRAM: one row per track colour, one column per state (idle, then eight
+ * heading arrows without and with a speed ring). Each sprite is an
+ * lv_image_dsc_t pointing into the atlas with the atlas stride, so a marker
+ * changes state by switching image source and never re-runs text layout or
+ * shape drawing.
+ */
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <math.h>
+#include <stdlib.h>
+#include "marker_sprites.h"
+
+#define SKN_SPRITE_COLS       (1 + 2 * SKN_SPRITE_HEADINGS)
+#define SKN_ATLAS_W           (SKN_SPRITE_COLS * SKN_SPRITE_SZ)
+#define SKN_ATLAS_H           (SKN_SPRITE_TRACKS * SKN_SPRITE_SZ)
+#define SKN_ATLAS_STRIDE      (SKN_ATLAS_W * sizeof(uint32_t))
+#define SKN_SPRITE_BODY_R     6.0f
+#define SKN_SPRITE_RING_R     10.5f
+#define SKN_SPRITE_SLOW_MMS   50  // Below this a target counts as standing still
+#define SKN_SPRITE_FAST_MMS   600 // Walking pace and above gets the speed ring
+
+static const char *SPRITE_TAG = "Sprites";
+
+static const uint32_t track_colors[SKN_SPRITE_TRACKS] = {0xFFD000, 0x00E0FF, 0xFF50A0, 0x80FF40};
+
+static uint32_t *atlas = NULL;
+static lv_image_dsc_t sprites[SKN_SPRITE_TRACKS][SKN_SPRITE_COLS];
+
+/**
+ * @brief Source-over blend of a straight-alpha colour onto a straight-alpha pixel
+ */
+static void skn_sprite_blend(uint32_t *dst, uint32_t rgb, float alpha)
+{
+    if (alpha <= 0.0f) {
+        return;
+    }
+    alpha = alpha > 1.0f ? 1.0f : alpha;
+
+    float da = (*dst >> 24) / 255.0f;
+    float oa = alpha + da * (1.0f - alpha);
+    uint32_t out = (uint32_t)(oa * 255.0f + 0.5f) << 24;
+    for (int shift = 0; shift <= 16; shift += 8) {
+        float s = (rgb >> shift) & 0xFF;
+        float d = (*dst >> shift) & 0xFF;
+        float c = (s * alpha + d * da * (1.0f - alpha)) / oa;
+        out |= (uint32_t)(c + 0.5f) << shift;
+    }
+    *dst = out;
+}
+
+static float skn_sprite_edge(float ax, float ay, float bx, float by, float px, float py)
+{
+    return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+}
+
+/**
+ * @brief Draw one sprite: speed ring, filled body with white rim, heading arrow
+ */
+static void skn_sprite_render(uint32_t *origin, uint32_t rgb, uint8_t heading, bool ring)
+{
+    const float c = SKN_SPRITE_SZ / 2.0f;
+    float tip_x = 0, tip_y = 0, l_x = 0, l_y = 0, r_x = 0, r_y = 0;
+
+    if (heading != SKN_SPRITE_NO_HEADING) {
+        // Heading 0 points right, 2 away from the sensor (screen up)
+        float a = heading * (float)M_PI / 4.0f;
+        float ux = cosf(a), uy = -sinf(a);
+        tip_x = c + ux * 11.5f;
+        tip_y = c + uy * 11.5f;
+        l_x = c + ux * 5.0f - uy * 4.5f;
+        l_y = c + uy * 5.0f + ux * 4.5f;
+        r_x = c + ux * 5.0f + uy * 4.5f;
+        r_y = c + uy * 5.0f - ux * 4.5f;
+    }
+
+    for (int y = 0; y < SKN_SPRITE_SZ; y++) {
+        uint32_t *row = origin + y * SKN_ATLAS_W;
+        for (int x = 0; x < SKN_SPRITE_SZ; x++) {
+            float px = x + 0.5f, py = y + 0.5f;
+            float d = sqrtf((px - c) * (px - c) + (py - c) * (py - c));
+
+            row[x] = 0;
+            if (ring) {
+                skn_sprite_blend(&row[x], rgb, 0.7f * (1.0f - fabsf(d - SKN_SPRITE_RING_R)));
+            }
+            skn_sprite_blend(&row[x], rgb, SKN_SPRITE_BODY_R + 0.5f - d);
+            skn_sprite_blend(&row[x], 0xFFFFFF, 0.9f * (1.0f - fabsf(d - SKN_SPRITE_BODY_R - 0.5f)));
+            if (heading != SKN_SPRITE_NO_HEADING) {
+                float e0 = skn_sprite_edge(tip_x, tip_y, l_x, l_y, px, py);
+                float e1 = skn_sprite_edge(l_x, l_y, r_x, r_y, px, py);
+                float e2 = skn_sprite_edge(r_x, r_y, tip_x, tip_y, px, py);
+                if ((e0 >= 0 && e1 >= 0 && e2 >= 0) || (e0 <= 0 && e1 <= 0 && e2 <= 0)) {
+                    skn_sprite_blend(&row[x], 0xFFFFFF, 1.0f);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Render the sprite atlas; call once before creating markers
+ */
+esp_err_t skn_sprites_init(void)
+{
+    if (atlas != NULL) {
+        return ESP_OK;
+    }
+
+    int64_t start_us = esp_timer_get_time();
+    atlas = heap_caps_malloc(SKN_ATLAS_STRIDE * SKN_ATLAS_H, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (atlas == NULL) {
+        ESP_LOGE(SPRITE_TAG, "Unable to allocate %dx%d sprite atlas", SKN_ATLAS_W, SKN_ATLAS_H);
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (uint8_t track = 0; track < SKN_SPRITE_TRACKS; track++) {
+        for (uint8_t col = 0; col < SKN_SPRITE_COLS; col++) {
+            uint32_t *origin = atlas + track * SKN_SPRITE_SZ * SKN_ATLAS_W + col * SKN_SPRITE_SZ;
+            uint8_t heading = col == 0 ? SKN_SPRITE_NO_HEADING : (col - 1) % SKN_SPRITE_HEADINGS;
+            skn_sprite_render(origin, track_colors[track], heading, col > SKN_SPRITE_HEADINGS);
+
+            lv_image_dsc_t *dsc = &sprites[track][col];
+            dsc->header.magic = LV_IMAGE_HEADER_MAGIC;
+            dsc->header.cf = LV_COLOR_FORMAT_ARGB8888;
+            dsc->header.w = SKN_SPRITE_SZ;
+            dsc->header.h = SKN_SPRITE_SZ;
+            dsc->header.stride = SKN_ATLAS_STRIDE;
+            dsc->data = (const uint8_t *)origin;
+            dsc->data_size = SKN_ATLAS_STRIDE * (SKN_SPRITE_SZ - 1) + SKN_SPRITE_SZ * sizeof(uint32_t);
+        }
+    }
+
+    ESP_LOGI(SPRITE_TAG, "%d marker sprites rendered in %lld us (%u bytes)", SKN_SPRITE_TRACKS * SKN_SPRITE_COLS,
+             esp_timer_get_time() - start_us, (unsigned)(SKN_ATLAS_STRIDE * SKN_ATLAS_H));
+    return ESP_OK;
+}
+
+/**
+ * @brief Sprite for a marker state
+ *
+ * @param track Track index, wraps over the available colours
+ * @param heading Heading from skn_sprite_heading(), ignored for idle targets
+ * @param speed Speed class from skn_sprite_speed_class()
+ * @return Sprite descriptor, NULL before skn_sprites_init()
+ */
+const lv_image_dsc_t *skn_sprite_get(uint8_t track, uint8_t heading, skn_sprite_speed_t speed)
+{
+    uint8_t col = 0;
+
+    if (atlas == NULL) {
+        return NULL;
+    }
+    if (speed != SKN_SPRITE_IDLE && heading < SKN_SPRITE_HEADINGS) {
+        col = 1 + heading + (speed == SKN_SPRITE_FAST ? SKN_SPRITE_HEADINGS : 0);
+    }
+    return &sprites[track % SKN_SPRITE_TRACKS][col];
+}
+
+/**
+ * @brief Quantise a motion vector to one of eight headings without trig
+ *
+ * @param dx_mm Lateral motion, positive to the right
+ * @param dy_mm Radial motion, positive away from the sensor
+ * @return 0 (right) .. 7, counter-clockwise, or SKN_SPRITE_NO_HEADING for no motion
+ */
+uint8_t skn_sprite_heading(int32_t dx_mm, int32_t dy_mm)
+{
+    int32_t ax = abs(dx_mm), ay = abs(dy_mm);
+
+    if (ax == 0 && ay == 0) {
+        return SKN_SPRITE_NO_HEADING;
+    }
+    // tan(22.5 deg) ~= 106/256 separates axis-aligned from diagonal sectors
+    if (ay * 256 <= ax * 106) {
+        return dx_mm > 0 ? 0 : 4;
+    }
+    if (ax * 256 <= ay * 106) {
+        return dy_mm > 0 ? 2 : 6;
+    }
+    if (dx_mm > 0) {
+        return dy_mm > 0 ? 1 : 7;
+    }
+    return dy_mm > 0 ? 3 : 5;
+}
+
+skn_sprite_speed_t skn_sprite_speed_class(int16_t speed_mms)
+{
+    int32_t speed = abs(speed_mms);
+
+    if (speed < SKN_SPRITE_SLOW_MMS) {
+        return SKN_SPRITE_IDLE;
+    }
+    return speed < SKN_SPRITE_FAST_MMS ? SKN_SPRITE_SLOW : SKN_SPRITE_FAST;
+}
@@ -1,56 +1,178 @@
 #include "esp_log.h"
 #include "esp_system.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "driver/gpio.h"
+#include <math.h>
 
 #include "esp_rd-03d.h"
+#include "power.h"
+#include "presence.h"
+#include "radar_targets.h"
+#include "rd03d_config.h"
+#include "sensor_fusion.h"
+#include "target_stream.h"
+#include "telemetry.h"
+#include "web_server.h"
 
-radar_sensor_t radar;
+/**
+ * @brief One RD-03D module on its own UART, with its mounting pose
+ */
+typedef struct
+{
+    radar_sensor_t dev;
+    uart_port_t port;
+    int rx_gpio;
+    int tx_gpio;
+    skn_sensor_pose_t pose;
+    uint32_t seq; // Per-sensor report count
+} skn_sensor_t;
 
-void sensor_task(void *pvParameters) {
-    // Initialize the radar sensor
-    esp_err_t ret = radar_sensor_init(&radar, UART_NUM_1, 39, 38);
+static skn_sensor_t sensors[CONFIG_SKN_SENSOR_COUNT] = {
+    {.port = UART_NUM_1, .rx_gpio = 39, .tx_gpio = 38},
+#if CONFIG_SKN_SENSOR_COUNT > 1
+    {.port = UART_NUM_2, .rx_gpio = CONFIG_SKN_SENSOR2_RX_GPIO, .tx_gpio = CONFIG_SKN_SENSOR2_TX_GPIO},
+#endif
+};
+static skn_target_frame_t sensor_frames[CONFIG_SKN_SENSOR_COUNT]; // Latest of each sensor, room frame
+static skn_rd03d_config_t sensor_config;
+static uint32_t frame_seq = 0;
+
+/**
+ * @brief Convert the driver's float report into an integer target frame
+ *
+ * This is the only place floats enter; everything downstream, down to the
+ * marker pixels, works in integer millimetres. Targets outside the configured
+ * range and angle gates are dropped here, in the sensor's own frame.
+ */
+static void sensor_build_frame(skn_sensor_t *sensor, const radar_target_t *target, skn_target_frame_t *frame)
+{
+    frame->seq = ++sensor->seq;
+    frame->timestamp_us = esp_timer_get_time();
+    frame->count = 0;
+
+    if (target->detected) {
+        skn_target_t *t = &frame->targets[frame->count++];
+        t->x_mm = (int16_t)lroundf(target->x);
+        t->y_mm = (int16_t)lroundf(target->y);
+        t->speed_mms = (int16_t)lroundf(target->speed);
+        t->distance_mm = (uint16_t)lroundf(target->distance);
+        if (!skn_rd03d_gate(&sensor_config, t)) {
+            frame->count--;
+        }
+    }
+    skn_fusion_to_room(&sensor->pose, frame);
+}
+
+/**
+ * @brief Bring up one module: UART, driver and the NVS configuration
+ */
+static esp_err_t sensor_start(skn_sensor_t *sensor, uint8_t index)
+{
+    skn_rd03d_info_t sensor_info;
+
+    esp_err_t ret = radar_sensor_init(&sensor->dev, sensor->port, sensor->rx_gpio, sensor->tx_gpio);
     if (ret != ESP_OK) {
         switch (ret)
         {
-        case ESP_OK:
-            ESP_LOGI("RD-03D", "Initialization successful");
-            break;
         case ESP_ERR_INVALID_ARG:
-            ESP_LOGE("RD-03D", "Invalid arguments provided");
+            ESP_LOGE("RD-03D", "Sensor %u: invalid arguments provided", index + 1);
             break;
         default:
-            ESP_LOGE("RD-03D", "Initialization failed: %s", esp_err_to_name(ret));
+            ESP_LOGE("RD-03D", "Sensor %u: initialization failed: %s", index + 1, esp_err_to_name(ret));
             break;
         }
-        vTaskDelete(NULL);
+        return ret;
     }
 
     // Start UART communication
-    ret = radar_sensor_begin(&radar, 256000);
+    ret = radar_sensor_begin(&sensor->dev, 256000);
     if (ret != ESP_OK)
     {
-        ESP_LOGE("RD-03D", "Failed to start radar sensor");
-        vTaskDelete(NULL);
+        ESP_LOGE("RD-03D", "Sensor %u: failed to start radar sensor", index + 1);
+        return ret;
     }
 
     // Configure for security application (longer retention)
-    radar_sensor_set_retention_times(&radar, 10000, 500); // 10s detection, 0.5s absence
+    radar_sensor_set_retention_times(&sensor->dev, 10000, 500); // 10s detection, 0.5s absence
+
+    // Module settings from NVS, before the first report is parsed
+    skn_rd03d_apply(sensor->port, &sensor_config, &sensor_info);
+    return ESP_OK;
+}
+
+void sensor_task(void *pvParameters) {
+    static const int16_t poses[][3] = {
+        {CONFIG_SKN_SENSOR1_X_MM, CONFIG_SKN_SENSOR1_Y_MM, CONFIG_SKN_SENSOR1_YAW_DEG},
+#if CONFIG_SKN_SENSOR_COUNT > 1
+        {CONFIG_SKN_SENSOR2_X_MM, CONFIG_SKN_SENSOR2_Y_MM, CONFIG_SKN_SENSOR2_YAW_DEG},
+#endif
+    };
+    uint8_t active = 0;
+
+    skn_rd03d_load_config(&sensor_config);
+    for (uint8_t i = 0; i < CONFIG_SKN_SENSOR_COUNT; i++) {
+        skn_fusion_pose_init(&sensors[i].pose, poses[i][0], poses[i][1], poses[i][2]);
+        if (sensor_start(&sensors[i], i) == ESP_OK) {
+            active |= 1 << i;
+        }
+    }
+    if (active == 0) {
+        vTaskDelete(NULL);
+    }
+
+    ESP_LOGI("RD-03D", "%d sensor(s) active, starting main loop.", __builtin_popcount(active));
+
+    // Wake on a fixed period and report how late each wakeup is against the first one
+    TickType_t last_wake = xTaskGetTickCount();
+    TickType_t base_tick = last_wake;
+    int64_t base_us = esp_timer_get_time();
 
-    ESP_LOGI("RD-03D", "Sensor is active, starting main loop.");
     // Main loop
     while (1)
     {
-        if (radar_sensor_update(&radar))
+        bool updated = false;
+
+        // Full clock only while reports are parsed, fused and handed on
+        skn_power_boost_begin(SKN_POWER_BOOST_SENSOR);
+        for (uint8_t i = 0; i < CONFIG_SKN_SENSOR_COUNT; i++)
         {
-            radar_target_t target = radar_sensor_get_target(&radar);
+            if (!(active & (1 << i)) || !radar_sensor_update(&sensors[i].dev)) {
+                continue;
+            }
+
+            radar_target_t target = radar_sensor_get_target(&sensors[i].dev);
+            sensor_build_frame(&sensors[i], &target, &sensor_frames[i]);
+            updated = true;
 
             if (target.detected)
             {
-                ESP_LOGI("RD-03D", "Target detected at (%.1f, %.1f) mm, distance: %.1f mm",target.x, target.y, target.distance);
-                ESP_LOGI("RD-03D", "Position: %s", target.position_description);
-                ESP_LOGI("RD-03D", "Angle: %.1f degrees, Distance: %.1f mm, Speed: %.1f mm/s", target.angle, target.distance, target.speed );
+                ESP_LOGD("RD-03D", "Sensor %u: target at (%.1f, %.1f) mm, distance: %.1f mm", i + 1, target.x, target.y, target.distance);
+                ESP_LOGD("RD-03D", "Position: %s", target.position_description);
+                ESP_LOGD("RD-03D", "Angle: %.1f degrees, Distance: %.1f mm, Speed: %.1f mm/s", target.angle, target.distance, target.speed );
             }
         }
-        vTaskDelay(pdMS_TO_TICKS(500));
+
+        if (updated)
+        {
+            skn_target_frame_t frame;
+
+#if CONFIG_SKN_SENSOR_COUNT > 1
+            skn_fusion_merge(sensor_frames, CONFIG_SKN_SENSOR_COUNT, esp_timer_get_time(), &frame);
+#else
+            // A single sensor has nothing to fuse with: publish its frame as is
+            frame = sensor_frames[0];
+#endif
+            frame.seq = ++frame_seq;
+            skn_targets_publish(&frame);
+            skn_presence_process(&frame);
+            skn_stream_submit(&frame);
+            skn_web_submit(&frame);
+        }
+        skn_power_boost_end(SKN_POWER_BOOST_SENSOR);
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(CONFIG_SKN_SENSOR_POLL_MS));
+        skn_telemetry_sensor_wake(esp_timer_get_time() - base_us -
+                                  (int64_t)(last_wake - base_tick) * portTICK_PERIOD_MS * 1000);
     }
 }
@@ -0,0 +1,295 @@
+/*
+ * power.c
+ * LEDC backlight and the idle power governor.
+ *
+ * The governor runs as an LVGL timer on the sensor frame clock. Once nothing
+ * has been detected or touched for CONFIG_SKN_IDLE_TIMEOUT_S it dims the
+ * backlight, slows LVGL's refresh timer, parks the radar sweep, lets WiFi use
+ * modem sleep and, when power management is built in, lowers the CPU clock.
+ * The first frame with a target, or a touch, restores everything on the next
+ * tick. CPU idle share is accumulated per state as a current-draw proxy.
+ *
+ * With dynamic frequency scaling the CPU idles at CONFIG_SKN_DFS_MIN_FREQ_MHZ
+ * and only the render and sensor paths hold an ESP_PM_CPU_FREQ_MAX lock while
+ * they work. The time any lock is held is accumulated per state as the
+ * max-frequency residency.
+ */
+
+#include "driver/ledc.h"
+#include "esp_log.h"
+#include "esp_pm.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "freertos/FreeRTOS.h"
+#include <inttypes.h>
+#include "power.h"
+#include "radar_panel.h"
+#include "radar_targets.h"
+#include "telemetry.h"
+
+#define SKN_BACKLIGHT_TIMER    LEDC_TIMER_1 // Timer 0 drives the buzzer
+#define SKN_BACKLIGHT_CHANNEL  LEDC_CHANNEL_1
+#define SKN_BACKLIGHT_MODE     LEDC_LOW_SPEED_MODE
+#define SKN_BACKLIGHT_RES      LEDC_TIMER_10_BIT
+#define SKN_BACKLIGHT_MAX_DUTY ((1 << 10) - 1)
+#define SKN_BACKLIGHT_FREQ_HZ  5000
+
+static const char *POWER_TAG = "Power";
+
+static const char *state_names[SKN_POWER_STATES] = {"active", "idle"};
+
+typedef struct
+{
+    uint32_t entered;       // Times the state was entered
+    uint32_t time_ms;       // Total residency
+    uint32_t idle_sum;      // Sum of per-sample idle permille, both cores averaged
+    uint32_t idle_samples;
+    uint64_t boost_us;      // Time at least one max-frequency lock was held
+} skn_power_stats_t;
+
+static skn_power_state_t state = SKN_POWER_ACTIVE;
+static skn_power_stats_t stats[SKN_POWER_STATES];
+static lv_obj_t *governed_radar = NULL;
+static uint32_t state_tick = 0;
+static uint32_t detect_tick = 0;
+static uint32_t telemetry_seq = 0;
+
+#if CONFIG_PM_ENABLE
+static const char *boost_names[SKN_POWER_BOOSTS] = {"render", "sensor"};
+static esp_pm_lock_handle_t boost_locks[SKN_POWER_BOOSTS];
+#endif
+static portMUX_TYPE boost_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t boost_holders = 0;
+static int64_t boost_start_us = 0;
+
+/**
+ * @brief Configure DFS and create the max-frequency locks; call before the display and sensor tasks start
+ */
+esp_err_t skn_power_init(void)
+{
+#if CONFIG_PM_ENABLE
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = CONFIG_SKN_DFS_MIN_FREQ_MHZ,
+        .light_sleep_enable = false, // The i80 LCD bus and UART must keep their clocks
+    };
+    esp_err_t ret = esp_pm_configure(&pm_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(POWER_TAG, "DFS %d..%d MHz rejected: %s", CONFIG_SKN_DFS_MIN_FREQ_MHZ,
+                 CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ, esp_err_to_name(ret));
+        return ret;
+    }
+    for (int i = 0; i < SKN_POWER_BOOSTS; i++) {
+        ret = esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, boost_names[i], &boost_locks[i]);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+    ESP_LOGI(POWER_TAG, "DFS %d..%d MHz", CONFIG_SKN_DFS_MIN_FREQ_MHZ, CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ);
+#else
+    ESP_LOGW(POWER_TAG, "CONFIG_PM_ENABLE is off, CPU stays at %d MHz", CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ);
+#endif
+    return ESP_OK;
+}
+
+/**
+ * @brief Run at full CPU frequency until the matching skn_power_boost_end()
+ *
+ * Safe from any task; each user owns one lock, so begin/end must pair per user.
+ */
+void skn_power_boost_begin(skn_power_boost_t who)
+{
+#if CONFIG_PM_ENABLE
+    if (boost_locks[who] != NULL) {
+        esp_pm_lock_acquire(boost_locks[who]);
+    }
+#endif
+    taskENTER_CRITICAL(&boost_lock);
+    if (boost_holders++ == 0) {
+        boost_start_us = esp_timer_get_time();
+    }
+    taskEXIT_CRITICAL(&boost_lock);
+}
+
+void skn_power_boost_end(skn_power_boost_t who)
+{
+    taskENTER_CRITICAL(&boost_lock);
+    if (boost_holders > 0 && --boost_holders == 0) {
+        stats[state].boost_us += esp_timer_get_time() - boost_start_us;
+    }
+    taskEXIT_CRITICAL(&boost_lock);
+#if CONFIG_PM_ENABLE
+    if (boost_locks[who] != NULL) {
+        esp_pm_lock_release(boost_locks[who]);
+    }
+#else
+    LV_UNUSED(who);
+#endif
+}
+
+/**
+ * @brief Drive the LCD backlight from LEDC instead of a plain GPIO, initially off
+ */
+esp_err_t skn_backlight_init(void)
+{
+    ledc_timer_config_t timer_conf = {
+        .speed_mode = SKN_BACKLIGHT_MODE,
+        .timer_num = SKN_BACKLIGHT_TIMER,
+        .duty_resolution = SKN_BACKLIGHT_RES,
+        .freq_hz = SKN_BACKLIGHT_FREQ_HZ,
+        .clk_cfg = LEDC_AUTO_CLK,
+    };
+    esp_err_t ret = ledc_timer_config(&timer_conf);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ledc_channel_config_t channel_conf = {
+        .gpio_num = CONFIG_LCD_BACK_LIGHT_GPIO,
+        .speed_mode = SKN_BACKLIGHT_MODE,
+        .channel = SKN_BACKLIGHT_CHANNEL,
+        .intr_type = LEDC_INTR_DISABLE,
+        .timer_sel = SKN_BACKLIGHT_TIMER,
+        .duty = 0,
+        .flags.output_invert = !CONFIG_LCD_BACK_LIGHT_ON_LEVEL,
+    };
+    return ledc_channel_config(&channel_conf);
+}
+
+/**
+ * @brief Set backlight brightness
+ *
+ * @param percent 0 (off) .. 100 (full)
+ */
+void skn_backlight_set(uint8_t percent)
+{
+    percent = percent > 100 ? 100 : percent;
+    ledc_set_duty(SKN_BACKLIGHT_MODE, SKN_BACKLIGHT_CHANNEL, (SKN_BACKLIGHT_MAX_DUTY * percent) / 100);
+    ledc_update_duty(SKN_BACKLIGHT_MODE, SKN_BACKLIGHT_CHANNEL);
+}
+
+/**
+ * @brief Set the CPU clock limit for a state; a no-op without CONFIG_PM_ENABLE
+ */
+static void skn_power_set_cpu(skn_power_state_t next)
+{
+#if CONFIG_PM_ENABLE
+    // Idle also caps the render and sensor boosts
+    int freq_mhz = next == SKN_POWER_IDLE ? CONFIG_SKN_IDLE_CPU_FREQ_MHZ : CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = freq_mhz,
+        .min_freq_mhz = LV_MIN(freq_mhz, CONFIG_SKN_DFS_MIN_FREQ_MHZ),
+        .light_sleep_enable = false,
+    };
+    esp_err_t ret = esp_pm_configure(&pm_config);
+    if (ret != ESP_OK) {
+        ESP_LOGW(POWER_TAG, "CPU clock %d MHz not applied: %s", freq_mhz, esp_err_to_name(ret));
+    }
+#else
+    LV_UNUSED(next);
+#endif
+}
+
+/**
+ * @brief Average idle share of both cores from the latest telemetry snapshot, once per snapshot
+ */
+static void skn_power_sample(void)
+{
+    uint16_t idle_permille[2];
+    uint32_t seq = skn_telemetry_get_idle(idle_permille);
+
+    if (seq == telemetry_seq) {
+        return;
+    }
+    telemetry_seq = seq;
+    stats[state].idle_sum += (idle_permille[0] + idle_permille[1]) / 2;
+    stats[state].idle_samples++;
+}
+
+static void skn_power_enter(skn_power_state_t next)
+{
+    uint32_t elapsed = lv_tick_elaps(state_tick);
+    bool idle = next == SKN_POWER_IDLE;
+
+    taskENTER_CRITICAL(&boost_lock);
+    stats[state].time_ms += elapsed;
+    stats[next].entered++;
+    state_tick = lv_tick_get();
+    state = next;
+    taskEXIT_CRITICAL(&boost_lock);
+
+    // Restore in order of visibility: backlight and sweep first
+    skn_backlight_set(idle ? CONFIG_SKN_IDLE_BACKLIGHT_PCT : 100);
+    lv_radar_set_sweep_running(governed_radar, !idle);
+    lv_timer_set_period(lv_display_get_refr_timer(lv_display_get_default()),
+                        idle ? CONFIG_SKN_IDLE_REFR_PERIOD_MS : LV_DEF_REFR_PERIOD);
+    skn_power_set_cpu(next);
+    if (esp_wifi_set_ps(idle ? WIFI_PS_MIN_MODEM : WIFI_PS_NONE) != ESP_OK) {
+        ESP_LOGD(POWER_TAG, "WiFi power save unchanged, WiFi not started");
+    }
+
+    ESP_LOGI(POWER_TAG, "Entered %s after %" PRIu32 " ms", state_names[next], elapsed);
+    skn_power_log();
+}
+
+static void skn_power_timer_cb(lv_timer_t *timer)
+{
+    skn_target_frame_t frame;
+    LV_UNUSED(timer);
+
+    skn_targets_latest(&frame);
+    if (frame.count > 0) {
+        detect_tick = lv_tick_get();
+    }
+    skn_power_sample();
+
+    uint32_t quiet_ms = LV_MIN(lv_tick_elaps(detect_tick), lv_display_get_inactive_time(NULL));
+    if (state == SKN_POWER_IDLE && quiet_ms < CONFIG_SKN_SENSOR_POLL_MS * 2) {
+        skn_power_enter(SKN_POWER_ACTIVE);
+    } else if (state == SKN_POWER_ACTIVE && quiet_ms >= CONFIG_SKN_IDLE_TIMEOUT_S * 1000) {
+        skn_power_enter(SKN_POWER_IDLE);
+    }
+}
+
+/**
+ * @brief Start governing power from the LVGL thread
+ *
+ * Polls on the sensor frame clock, so a new detection restores the active
+ * state within one sensor frame.
+ *
+ * @param radar Radar widget whose sweep is parked while idle
+ */
+void skn_power_governor_start(lv_obj_t *radar)
+{
+    if (governed_radar != NULL) {
+        return;
+    }
+    governed_radar = radar;
+    state_tick = lv_tick_get();
+    detect_tick = state_tick;
+    stats[SKN_POWER_ACTIVE].entered = 1;
+    lv_timer_create(skn_power_timer_cb, CONFIG_SKN_SENSOR_POLL_MS, NULL);
+}
+
+skn_power_state_t skn_power_state(void)
+{
+    return state;
+}
+
+/**
+ * @brief Log residency and the current proxies (CPU idle, max-frequency share, backlight) per state
+ */
+void skn_power_log(void)
+{
+    for (int i = 0; i < SKN_POWER_STATES; i++) {
+        const skn_power_stats_t *s = &stats[i];
+        uint32_t idle = s->idle_samples ? s->idle_sum / s->idle_samples : 0;
+        uint32_t time_ms = s->time_ms + (i == state ? lv_tick_elaps(state_tick) : 0);
+        uint32_t boost = time_ms ? (uint32_t)(s->boost_us / time_ms) : 0; // us per ms = permille
+
+        ESP_LOGI(POWER_TAG, "%-6s entered %" PRIu32 "x, %" PRIu32 " s, CPU idle %" PRIu32 ".%" PRIu32
+                 "%%, at max clock %" PRIu32 ".%" PRIu32 "%%, backlight %u%%",
+                 state_names[i], s->entered, time_ms / 1000, idle / 10, idle % 10,
+                 boost / 10, boost % 10, i == SKN_POWER_IDLE ? CONFIG_SKN_IDLE_BACKLIGHT_PCT : 100);
+    }
+}
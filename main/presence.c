@@ -0,0 +1,207 @@
+/*
+ * presence.c
+ * Turns per-frame sensor targets into discrete zone events:
+ *   ENTER     a zone has held a target for enter_frames consecutive frames
+ *   EXIT      an occupied zone has been empty for exit_hold_ms
+ *   DWELL     repeated every dwell_ms while a zone stays occupied
+ *   APPROACH  a target inside the zone moved closer than approach_mm
+ *
+ * Occupied zones are tested with their hysteresis bounds, so targets on a
+ * boundary do not flap. Runs in the sensor task; events are logged and handed
+ * to the network stream.
+ */
+
+#include "esp_log.h"
+#include <string.h>
+#include "presence.h"
+#include "target_stream.h"
+
+static const char *PRESENCE_TAG = "Presence";
+
+typedef struct
+{
+    bool occupied;
+    uint8_t inside_frames;
+    int64_t entered_us;
+    int64_t last_seen_us;
+    int64_t last_dwell_us;
+    bool approached;
+} skn_presence_zone_state_t;
+
+static skn_presence_zone_params_t zone_params[SKN_PRESENCE_MAX_ZONES];
+static skn_presence_zone_state_t zone_state[SKN_PRESENCE_MAX_ZONES];
+static skn_presence_classify_fn zone_classify = NULL;
+static uint16_t range_mm = CONFIG_SKN_PRESENCE_RANGE_MM;
+
+/**
+ * @brief Default classifier: zone 0 is the sensor's whole field of view
+ */
+uint8_t skn_presence_classify_range(const skn_target_t *target, uint8_t occupied_mask)
+{
+    uint16_t limit = range_mm;
+    if (occupied_mask & 0x01) {
+        limit += zone_params[0].hysteresis_mm;
+    }
+    return (target->distance_mm > 0 && target->distance_mm <= limit) ? 0x01 : 0x00;
+}
+
+static void skn_presence_emit(uint8_t type, uint8_t zone, uint8_t slot, uint16_t distance_mm,
+                              uint32_t duration_ms, int64_t now_us)
+{
+    skn_presence_event_t event = {
+        .type = type,
+        .zone = zone,
+        .slot = slot,
+        .distance_mm = distance_mm,
+        .duration_ms = duration_ms,
+        .timestamp_us = now_us,
+    };
+
+    ESP_LOGI(PRESENCE_TAG, "%s zone %u, target %u at %u mm, %lu ms", skn_presence_event_name(type),
+             zone, slot, distance_mm, duration_ms);
+    skn_stream_submit_event(&event);
+}
+
+const char *skn_presence_event_name(uint8_t type)
+{
+    switch (type) {
+    case SKN_PRESENCE_ENTER:
+        return "ENTER";
+    case SKN_PRESENCE_EXIT:
+        return "EXIT";
+    case SKN_PRESENCE_DWELL:
+        return "DWELL";
+    case SKN_PRESENCE_APPROACH:
+        return "APPROACH";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+/**
+ * @brief Initialize the event engine
+ *
+ * @param classify Zone membership test, NULL selects the whole-field range zone
+ */
+void skn_presence_init(skn_presence_classify_fn classify)
+{
+    const skn_presence_zone_params_t defaults = {
+        .enter_frames = CONFIG_SKN_PRESENCE_ENTER_FRAMES,
+        .exit_hold_ms = CONFIG_SKN_PRESENCE_EXIT_HOLD_MS,
+        .dwell_ms = CONFIG_SKN_PRESENCE_DWELL_MS,
+        .approach_mm = CONFIG_SKN_PRESENCE_APPROACH_MM,
+        .hysteresis_mm = CONFIG_SKN_PRESENCE_HYSTERESIS_MM,
+    };
+
+    for (int i = 0; i < SKN_PRESENCE_MAX_ZONES; i++) {
+        zone_params[i] = defaults;
+    }
+    memset(zone_state, 0, sizeof(zone_state));
+    zone_classify = classify ? classify : skn_presence_classify_range;
+}
+
+void skn_presence_set_zone_params(uint8_t zone, const skn_presence_zone_params_t *params)
+{
+    if (zone < SKN_PRESENCE_MAX_ZONES) {
+        zone_params[zone] = *params;
+    }
+}
+
+void skn_presence_get_zone_params(uint8_t zone, skn_presence_zone_params_t *params)
+{
+    if (zone < SKN_PRESENCE_MAX_ZONES) {
+        *params = zone_params[zone];
+    }
+}
+
+/**
+ * @brief Set the reach of the whole-field range zone
+ */
+void skn_presence_set_range_mm(uint16_t limit_mm)
+{
+    range_mm = limit_mm;
+}
+
+uint16_t skn_presence_get_range_mm(void)
+{
+    return range_mm;
+}
+
+uint8_t skn_presence_occupied_mask(void)
+{
+    uint8_t mask = 0;
+    for (int i = 0; i < SKN_PRESENCE_MAX_ZONES; i++) {
+        if (zone_state[i].occupied) {
+            mask |= 1 << i;
+        }
+    }
+    return mask;
+}
+
+/**
+ * @brief Advance zone state machines with one sensor frame
+ */
+void skn_presence_process(const skn_target_frame_t *frame)
+{
+    int64_t now_us = frame->timestamp_us;
+    uint8_t occupied_mask = skn_presence_occupied_mask();
+    uint8_t inside_mask = 0;
+    uint8_t nearest_slot[SKN_PRESENCE_MAX_ZONES] = {0};
+    uint16_t nearest_mm[SKN_PRESENCE_MAX_ZONES];
+
+    memset(nearest_mm, 0xFF, sizeof(nearest_mm));
+    for (uint8_t slot = 0; slot < frame->count; slot++) {
+        const skn_target_t *target = &frame->targets[slot];
+        uint8_t zones = zone_classify(target, occupied_mask);
+        inside_mask |= zones;
+        for (uint8_t zone = 0; zone < SKN_PRESENCE_MAX_ZONES; zone++) {
+            if ((zones & (1 << zone)) && target->distance_mm < nearest_mm[zone]) {
+                nearest_mm[zone] = target->distance_mm;
+                nearest_slot[zone] = slot;
+            }
+        }
+    }
+
+    for (uint8_t zone = 0; zone < SKN_PRESENCE_MAX_ZONES; zone++) {
+        skn_presence_zone_state_t *state = &zone_state[zone];
+        const skn_presence_zone_params_t *params = &zone_params[zone];
+        bool inside = inside_mask & (1 << zone);
+
+        if (inside) {
+            state->last_seen_us = now_us;
+            if (!state->occupied) {
+                if (++state->inside_frames >= params->enter_frames) {
+                    state->occupied = true;
+                    state->entered_us = now_us;
+                    state->last_dwell_us = now_us;
+                    skn_presence_emit(SKN_PRESENCE_ENTER, zone, nearest_slot[zone], nearest_mm[zone], 0, now_us);
+                }
+                continue;
+            }
+
+            if (params->approach_mm) {
+                if (!state->approached && nearest_mm[zone] <= params->approach_mm) {
+                    state->approached = true;
+                    skn_presence_emit(SKN_PRESENCE_APPROACH, zone, nearest_slot[zone], nearest_mm[zone],
+                                      (now_us - state->entered_us) / 1000, now_us);
+                } else if (state->approached && nearest_mm[zone] > params->approach_mm + params->hysteresis_mm) {
+                    state->approached = false;
+                }
+            }
+
+            if (params->dwell_ms && now_us - state->last_dwell_us >= (int64_t)params->dwell_ms * 1000) {
+                state->last_dwell_us = now_us;
+                skn_presence_emit(SKN_PRESENCE_DWELL, zone, nearest_slot[zone], nearest_mm[zone],
+                                  (now_us - state->entered_us) / 1000, now_us);
+            }
+            continue;
+        }
+
+        state->inside_frames = 0;
+        if (state->occupied && now_us - state->last_seen_us >= (int64_t)params->exit_hold_ms * 1000) {
+            state->occupied = false;
+            state->approached = false;
+            skn_presence_emit(SKN_PRESENCE_EXIT, zone, 0, 0, (state->last_seen_us - state->entered_us) / 1000, now_us);
+        }
+    }
+}
@@ -1,377 +1,1125 @@
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
 #include "lvgl.h"
 #include <stdio.h>
-#include <math.h>
+#include <stdlib.h>
 #include "radar_panel.h"
+#include "radar_geometry.h"
+#include "zone_editor.h"
+#include "heatmap.h"
+#include "screen_manager.h"
+#include "marker_sprites.h"
+#include "telemetry.h"
+#include "power.h"
 
-static int16_t center_x, center_y, radius;
-    /**
-     * @brief Draw a semi-circle radar grid with 4 horizontal arches and 9 vertical lines
-     *
-     * The radar screen consists of:
-     * - A semi-circle arc (180 to 360 degrees - top half)
-     * - 4 horizontal semi-circular arches representing 2 meter divisions
-     * - 9 vertical radial lines representing 20-degree increments (180°, 200°, 220°, ..., 360°)
-     *
-     * @param parent The parent LVGL object to draw on
-     * @param center_x The X coordinate of the radar center
-     * @param center_y The Y coordinate of the radar center
-     * @param radius The radius of the semi-circle in pixels
-     * @param band_count Number of horizontal semi-circular arches (typically 4)
-     * @param line_count Number of vertical radial lines (typically 9)
-     */
-void lv_radar_screen_draw(lv_obj_t *parent, uint8_t band_count, uint8_t line_count) {
-    // Create style for radar lines
-    static lv_style_t style_line;
-    lv_style_init(&style_line);
-    lv_style_set_line_width(&style_line, 2);
-    lv_style_set_line_color(&style_line, lv_color_hex(0x4080FF));  // Light blue
-    lv_style_set_line_rounded(&style_line, false);
-
-    int16_t band_radius = radius / band_count;
-    
-
-    // Draw 7 vertical radial lines (180°, 200°, 220°, ..., 360°)
-    static lv_point_precise_t points[10][2];
-    for (uint8_t i = 0; i < line_count; i++) {
-        
-        // Calculate angle in degrees (180 to 360)
-        float angle_deg = (180.0f / (line_count - 1)) * i;
-
-        // Convert angle to radians (LVGL uses standard mathematical angle system)
-        // Note: LVGL arc angles: 0° is right, 90° is down, 180° is left, 270° is up
-        // For radar: 180° is left, 270° is up, 360° is right (top half sweep)
-        float angle_rad = (angle_deg * M_PI) / 180.0f;
-
-        // Calculate end point of the line on the semi-circle
-        int16_t end_x = center_x + (int16_t)(radius * cosf(angle_rad));
-        int16_t end_y = center_y - (int16_t)(radius * sinf(angle_rad));
-
-        // Create a line object for each radial line
-        lv_obj_t *line = lv_line_create(parent);
-                
-        // Define line points (from center to radius)
-        points[i][0].x = center_x;
-        points[i][0].y = center_y;
-        points[i][1].x = end_x;
-        points[i][1].y = end_y;
-        lv_line_set_points(line, points[i], 2);
-        lv_obj_add_style(line, &style_line, 0);
-    }
-
-    // Draw horizontal reference arcs at band boundaries
-    static lv_style_t style_band_arc;
-    lv_style_init(&style_band_arc);
-    lv_style_set_arc_width(&style_band_arc, 1);
-    lv_style_set_arc_color(&style_band_arc, lv_color_hex(0x4080FF)); // , lv_color_hex(0x2060CC));  // Darker blue
-
-    for (uint8_t band = 1; band <= band_count; band++) {
-        int16_t current_arc_radius = band_radius * band;
-
-        // Draw semi-circular arc at each band level
-        lv_obj_t *h_arc = lv_arc_create(parent);
-        lv_obj_set_size(h_arc, current_arc_radius * 2, current_arc_radius * 2);
-        lv_obj_set_pos(h_arc, center_x - current_arc_radius, center_y - current_arc_radius);
-        lv_arc_set_range(h_arc, 180, 360);  // Semi-circle: 180 to 360 degrees (top half)
-        lv_arc_set_bg_angles(h_arc, 180, 360);
-        lv_arc_set_value(h_arc, 180);
-        lv_obj_remove_style(h_arc, NULL, LV_PART_KNOB);  // Remove the knob
-        lv_obj_add_style(h_arc, &style_band_arc, 0);
-
-        // Remove fill
-        lv_obj_set_style_bg_opa(h_arc, LV_OPA_TRANSP, 0);
+#define LV_RADAR_BANDS     4
+#define LV_RADAR_LINES     9
+#define LV_RADAR_SCALES    3
+#define LV_RADAR_NO_SCALE  LV_RADAR_SCALES
+#define LV_RADAR_GRID_COLOR 0x4080FF // Light blue
+#define LV_RADAR_ZOOM_OUT_PCT 90 // Zoom out once a track passes this share of the range
+#define LV_RADAR_ZOOM_IN_PCT  75 // Zoom in only when all tracks fit well inside
+#define LV_RADAR_SWEEP_PAUSE_MS 500 // Rest at 0 degrees between passes
+#define LV_RADAR_TRACK_GAP_US   500000 // Older previous frames give no usable velocity
+#define LV_RADAR_TRACK_JUMP_MM  1500   // Longer moves are track swaps, not motion
+#define LV_RADAR_TRACK_MAX_MMS  4000   // Faster than a running person is noise
+
+static const char *RADAR_TAG = "Radar";
+
+// Full-scale range of each auto-range step, the last one is the sensor's reach
+static const uint16_t radar_scales_mm[LV_RADAR_SCALES] = {2000, 4000, 8000};
+
+/**
+ * @brief Dead-reckoning state of one marker between sensor frames
+ */
+typedef struct
+{
+    int16_t x_mm;     // Last measured position
+    int16_t y_mm;
+    int16_t vx_mms;   // Velocity from the last two frames, 0 when unknown
+    int16_t vy_mms;
+    int64_t time_us;  // Sensor timestamp of the last measurement
+    bool predicted;   // Marker currently shows an extrapolated position
+} lv_radar_track_t;
+
+/**
+ * @brief Radar widget instance
+ *
+ * Everything that depends on the widget's size lives here, so several radars
+ * can coexist and a resize only moves existing children.
+ */
+typedef struct
+{
+    lv_obj_t obj;
+    int16_t center_x;
+    int16_t center_y;
+    int16_t radius;
+    uint16_t range_mm;  // Distance shown at the outer band, animated while zooming
+    int32_t px_per_mm_q16;  // radius / range_mm in Q16, the whole mm -> pixel transform
+    lv_obj_t *grid;     // Canvas showing the cached grid closest to range_mm
+    lv_draw_buf_t grid_bufs[LV_RADAR_SCALES];
+    bool grid_ready[LV_RADAR_SCALES];
+    uint8_t scale;          // Auto-range step being shown or zoomed to
+    uint8_t pending_scale;  // Smaller/larger step waiting out the hold time
+    uint32_t pending_tick;
+    bool auto_range;
+    lv_obj_t *zone_lines[SKN_ZONE_MAX_ZONES];
+    lv_point_precise_t zone_points[SKN_ZONE_MAX_ZONES][SKN_ZONE_MAX_VERTICES + 1];
+    lv_radar_marker_t markers[LV_RADAR_MAX_MARKERS];
+    lv_radar_track_t tracks[LV_RADAR_MAX_MARKERS];
+    skn_target_frame_t frames[2];  // Double-buffered snapshot: front is on screen, back is the previous/next frame
+    uint8_t front;
+    lv_radar_sweep_t *sweep;
+    lv_timer_t *live_timer;
+    lv_timer_t *predict_timer;
+} lv_radar_t;
+
+static void lv_radar_constructor(const lv_obj_class_t *class_p, lv_obj_t *obj);
+static void lv_radar_destructor(const lv_obj_class_t *class_p, lv_obj_t *obj);
+static void lv_radar_event(const lv_obj_class_t *class_p, lv_event_t *e);
+static void lv_radar_apply_range(lv_radar_t *radar);
+
+const lv_obj_class_t lv_radar_class = {
+    .base_class = &lv_obj_class,
+    .constructor_cb = lv_radar_constructor,
+    .destructor_cb = lv_radar_destructor,
+    .event_cb = lv_radar_event,
+    .width_def = LV_PCT(100),
+    .height_def = LV_PCT(100),
+    .instance_size = sizeof(lv_radar_t),
+};
+
+static const uint32_t zone_colors[SKN_ZONE_MAX_ZONES] = {
+    0xFF8000, 0x00C0FF, 0xFF40C0, 0x80FF40, 0xFFFF80, 0xC080FF, 0x40FFC0, 0xFF6060,
+};
+
+static uint32_t geometry_event = 0;
+
+static lv_style_t style_sweep;
+static lv_style_t style_shadow;
+static bool styles_ready = false;
+
+/**
+ * @brief Initialise the styles shared by all radar instances on first use only
+ */
+static void lv_radar_styles_init(void) {
+    if (styles_ready) return;
+
+    lv_style_init(&style_sweep);
+    lv_style_set_line_width(&style_sweep, 3);
+    lv_style_set_line_color(&style_sweep, lv_color_hex(0x00FF00));  // Bright green
+    lv_style_set_line_rounded(&style_sweep, true);
+
+    lv_style_init(&style_shadow);
+    lv_style_set_line_width(&style_shadow, 2);
+    lv_style_set_line_color(&style_shadow, lv_color_hex(0x00AA00));  // Darker green
+    lv_style_set_line_rounded(&style_shadow, true);
+
+    geometry_event = lv_event_register_id();
+    styles_ready = true;
+}
+
+/**
+ * @brief Render the semi-circle radar grid of one scale into its cache buffer
+ *
+ * The grid consists of:
+ * - 4 horizontal semi-circular arches representing the range bands, labelled in metres
+ * - 9 vertical radial lines representing 22.5-degree increments across the top half
+ *
+ * The buffer lives in PSRAM and is drawn once per widget size, so showing a
+ * scale is a single image blit instead of 13 line and arc widgets.
+ *
+ * @return The cached grid, NULL if the buffer could not be allocated
+ */
+static lv_draw_buf_t *lv_radar_grid_render(lv_radar_t *radar, uint8_t scale) {
+    lv_draw_buf_t *buf = &radar->grid_bufs[scale];
+    int32_t width = lv_obj_get_content_width((lv_obj_t *)radar);
+    int32_t height = lv_obj_get_content_height((lv_obj_t *)radar);
+    int16_t band_radius = radar->radius / LV_RADAR_BANDS;
+    char text[LV_RADAR_BANDS][8];
+
+    if (radar->grid_ready[scale]) return buf;
+    if (width <= 0 || height <= 0) return NULL;
+
+    if (buf->data == NULL) {
+        uint32_t stride = lv_draw_buf_width_to_stride(width, LV_COLOR_FORMAT_RGB565);
+        void *data = heap_caps_aligned_alloc(LV_DRAW_BUF_ALIGN, stride * height, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (data == NULL) {
+            LV_LOG_WARN("No memory for a %" LV_PRId32 "x%" LV_PRId32 " radar grid", width, height);
+            return NULL;
+        }
+        lv_draw_buf_init(buf, width, height, LV_COLOR_FORMAT_RGB565, stride, data, stride * height);
+    }
+
+    lv_canvas_set_draw_buf(radar->grid, buf);
+    lv_canvas_fill_bg(radar->grid, lv_color_black(), LV_OPA_COVER);
+
+    lv_layer_t layer;
+    lv_canvas_init_layer(radar->grid, &layer);
+
+    lv_draw_line_dsc_t line;
+    lv_draw_line_dsc_init(&line);
+    line.width = 2;
+    line.color = lv_color_hex(LV_RADAR_GRID_COLOR);
+    for (uint8_t i = 0; i < LV_RADAR_LINES; i++) {
+        // 0° is right; the radar fans out over the top half
+        int16_t angle = (180 * i) / (LV_RADAR_LINES - 1);
+        line.p1.x = radar->center_x;
+        line.p1.y = radar->center_y;
+        line.p2.x = radar->center_x + ((radar->radius * lv_trigo_cos(angle)) >> LV_TRIGO_SHIFT);
+        line.p2.y = radar->center_y - ((radar->radius * lv_trigo_sin(angle)) >> LV_TRIGO_SHIFT);
+        lv_draw_line(&layer, &line);
     }
+
+    lv_draw_arc_dsc_t arc;
+    lv_draw_arc_dsc_init(&arc);
+    arc.width = 1;
+    arc.color = lv_color_hex(LV_RADAR_GRID_COLOR);
+    arc.center.x = radar->center_x;
+    arc.center.y = radar->center_y;
+    arc.start_angle = 180;  // LVGL arc angles: 90° is down, so 180..360 is the top half
+    arc.end_angle = 360;
+
+    lv_draw_label_dsc_t label;
+    lv_draw_label_dsc_init(&label);
+    label.color = lv_color_hex(LV_RADAR_GRID_COLOR);
+
+    for (uint8_t band = 0; band < LV_RADAR_BANDS; band++) {
+        uint32_t band_mm = (uint32_t)radar_scales_mm[scale] * (band + 1) / LV_RADAR_BANDS;
+
+        arc.radius = band_radius * (band + 1);
+        lv_draw_arc(&layer, &arc);
+
+        // Distance just inside each arch, right of the centre line
+        if (band_mm % 1000 == 0) {
+            lv_snprintf(text[band], sizeof(text[band]), "%um", (unsigned)(band_mm / 1000));
+        } else {
+            lv_snprintf(text[band], sizeof(text[band]), "%u.%um", (unsigned)(band_mm / 1000),
+                        (unsigned)(band_mm % 1000) / 100);
+        }
+        label.text = text[band];
+        lv_area_t area = {
+            .x1 = radar->center_x + 4,
+            .y1 = radar->center_y - arc.radius + 2,
+            .x2 = radar->center_x + 60,
+            .y2 = radar->center_y - arc.radius + 20,
+        };
+        lv_draw_label(&layer, &label, &area);
+    }
+
+    lv_canvas_finish_layer(radar->grid, &layer);
+    radar->grid_ready[scale] = true;
+    return buf;
+}
+
+/**
+ * @brief Release the cached grids, e.g. because the widget was resized
+ */
+static void lv_radar_grid_free(lv_radar_t *radar) {
+    for (uint8_t i = 0; i < LV_RADAR_SCALES; i++) {
+        lv_draw_buf_t *buf = &radar->grid_bufs[i];
+
+        if (buf->data != NULL) {
+            lv_image_cache_drop(buf);
+            heap_caps_free(buf->data);
+        }
+        lv_memzero(buf, sizeof(*buf));
+        radar->grid_ready[i] = false;
+    }
+}
+
+/**
+ * @brief Show the cached grid for the current range
+ *
+ * Between two steps, e.g. while a zoom animates, the next larger grid is
+ * scaled about the sensor position so the rings stay where the markers
+ * expect them.
+ */
+static void lv_radar_grid_fit(lv_radar_t *radar) {
+    uint8_t scale = LV_RADAR_SCALES - 1;
+
+    for (uint8_t i = 0; i < LV_RADAR_SCALES; i++) {
+        if (radar_scales_mm[i] >= radar->range_mm) {
+            scale = i;
+            break;
+        }
+    }
+
+    lv_draw_buf_t *buf = lv_radar_grid_render(radar, scale);
+    if (buf == NULL) {
+        lv_obj_add_flag(radar->grid, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+    if (lv_canvas_get_draw_buf(radar->grid) != buf) {
+        lv_canvas_set_draw_buf(radar->grid, buf);
+    }
+    lv_image_set_pivot(radar->grid, radar->center_x, radar->center_y);
+    lv_image_set_scale(radar->grid, (LV_SCALE_NONE * radar_scales_mm[scale]) / radar->range_mm);
+    lv_obj_remove_flag(radar->grid, LV_OBJ_FLAG_HIDDEN);
+}
+
+/**
+ * @brief Render the next grid that is not cached yet
+ *
+ * Lets a screen build spread the grids over several frames, so a later range
+ * switch is only a blit.
+ *
+ * @return true once every step is cached
+ */
+static bool lv_radar_grid_prerender(lv_radar_t *radar) {
+    for (uint8_t i = 0; i < LV_RADAR_SCALES; i++) {
+        if (!radar->grid_ready[i]) {
+            lv_radar_grid_render(radar, i);
+            lv_radar_grid_fit(radar);  // Rendering borrowed the canvas
+            return i == LV_RADAR_SCALES - 1;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Create the grid canvas; lv_radar_relayout() renders into it
+ */
+static void lv_radar_grid_create(lv_radar_t *radar) {
+    radar->grid = lv_canvas_create((lv_obj_t *)radar);
+    lv_obj_remove_flag(radar->grid, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_flag(radar->grid, LV_OBJ_FLAG_HIDDEN);
+}
+
+/**
+ * @brief Set a line's end point on the sweep circle
+ *
+ * Uses LVGL's integer sine table, so no float trig per frame.
+ */
+static void lv_radar_sweep_set_line(const lv_radar_sweep_t *sweep, lv_obj_t *line, lv_point_precise_t *points, int16_t angle) {
+    points[0].x = sweep->center_x;
+    points[0].y = sweep->center_y;
+    points[1].x = sweep->center_x + ((sweep->radius * lv_trigo_cos(angle)) >> LV_TRIGO_SHIFT);
+    points[1].y = sweep->center_y - ((sweep->radius * lv_trigo_sin(angle)) >> LV_TRIGO_SHIFT);
+    lv_line_set_points(line, points, 2);
 }
 
 /**
  * @brief Update the radar sweep line with trailing shadow effect
- * 
+ *
+ * Shadows trail behind the direction of travel, so they flip sides when the
+ * sweep plays back. Each line owns its point storage; nothing is allocated.
+ *
  * @param sweep Pointer to the radar sweep structure
  * @param angle The current sweep angle (0-180 degrees)
  */
 void lv_radar_sweep_update(lv_radar_sweep_t *sweep, uint16_t angle) {
     if (angle > 180) angle = 180;
-    
+
+    if (angle != sweep->current_angle) {
+        sweep->direction = angle > sweep->current_angle ? 1 : -1;
+    }
     sweep->current_angle = angle;
-    
-    // Convert angle to radians
-    float angle_rad = (angle * M_PI) / 180.0f;
-    
-    // Calculate sweep line end point
-    int16_t end_x = sweep->center_x + (int16_t)(sweep->radius * cosf(angle_rad));
-    int16_t end_y = sweep->center_y - (int16_t)(sweep->radius * sinf(angle_rad));
-    
-    // Update or create main sweep line
-    if (sweep->sweep_line == NULL) {
-        sweep->sweep_line = lv_line_create(sweep->parent);
-        static lv_style_t style_sweep;
-        lv_style_init(&style_sweep);
-        lv_style_set_line_width(&style_sweep, 3);
-        lv_style_set_line_color(&style_sweep, lv_color_hex(0x00FF00));  // Bright green
-        lv_style_set_line_rounded(&style_sweep, true);
-        lv_obj_add_style(sweep->sweep_line, &style_sweep, 0);
-    }
-    
-    static lv_point_precise_t sweep_points[2];
-    sweep_points[0].x = sweep->center_x;
-    sweep_points[0].y = sweep->center_y;
-    sweep_points[1].x = end_x;
-    sweep_points[1].y = end_y;
-    lv_line_set_points(sweep->sweep_line, sweep_points, 2);
-    
-    // Update trailing shadow lines (5 shadow trails with decreasing opacity)
-    int16_t shadow_count = 5;
-    for (int16_t i = 0; i < shadow_count; i++) {
-        float shadow_angle = angle - ((i + 1) * 8);  // 8-degree increments for shadow
-        if (shadow_angle < 0) shadow_angle = 0;
-        
-        float shadow_rad = (shadow_angle * M_PI) / 180.0f;
-        int16_t shadow_end_x = sweep->center_x + (int16_t)(sweep->radius * cosf(shadow_rad));
-        int16_t shadow_end_y = sweep->center_y - (int16_t)(sweep->radius * sinf(shadow_rad));
-        
-        // Create shadow line if it doesn't exist
-        if (sweep->shadow_lines[i] == NULL) {
-            sweep->shadow_lines[i] = lv_line_create(sweep->parent);
-            static lv_style_t style_shadow;
-            lv_style_init(&style_shadow);
-            lv_style_set_line_width(&style_shadow, 2);
-            lv_style_set_line_color(&style_shadow, lv_color_hex(0x00AA00));  // Darker green
-            lv_style_set_line_rounded(&style_shadow, true);
-            lv_obj_add_style(sweep->shadow_lines[i], &style_shadow, 0);
-        }
-        
-        // Set opacity based on shadow distance (fade effect)
-        uint8_t opacity = 255 - (i * 50);  // Decreasing opacity
-        lv_obj_set_style_line_opa(sweep->shadow_lines[i], opacity, 0);
 
-        static lv_point_precise_t shadow_points[2];
-        shadow_points[0].x = sweep->center_x;
-        shadow_points[0].y = sweep->center_y;
-        shadow_points[1].x = shadow_end_x;
-        shadow_points[1].y = shadow_end_y;
-        lv_line_set_points(sweep->shadow_lines[i], shadow_points, 2);
+    lv_radar_sweep_set_line(sweep, sweep->sweep_line, sweep->sweep_points, angle);
+
+    for (uint8_t i = 0; i < sweep->trail_len; i++) {
+        uint16_t shadow_angle = skn_radar_trail_angle(angle, sweep->direction, i, CONFIG_SKN_SWEEP_TRAIL_STEP_DEG);
+        lv_radar_sweep_set_line(sweep, sweep->shadow_lines[i], sweep->shadow_points[i], shadow_angle);
     }
 }
 
 /**
- * @brief Animation callback for radar sweep
+ * @brief Sweep clock: step the sweep from the elapsed time
  *
- * @param var Pointer to the animated variable
- * @param value The current animated value (0-180 for angle)
+ * Runs every CONFIG_SKN_SWEEP_PERIOD_MS instead of every display refresh, and
+ * touches nothing while the angle is unchanged (e.g. during the pause), so the
+ * sweep costs a bounded number of redraws per second.
  */
-static void lv_radar_sweep_anim_cb(void *var, int32_t value) {
-    lv_radar_sweep_t *sweep = (lv_radar_sweep_t *)var;
-    lv_radar_sweep_update(sweep, (uint16_t)value);
+static void lv_radar_sweep_timer_cb(lv_timer_t *timer) {
+    lv_radar_sweep_t *sweep = lv_timer_get_user_data(timer);
+    uint32_t cycle_ms = 2 * sweep->duration_ms + LV_RADAR_SWEEP_PAUSE_MS;
+    uint32_t elapsed = lv_tick_elaps(sweep->start_tick);
+    uint16_t angle = 0;
+
+    if (!sweep->loop && elapsed >= cycle_ms) {
+        lv_timer_pause(timer);
+    } else {
+        // Out and back like a playback animation, then rest at 0 degrees
+        uint32_t phase = elapsed % cycle_ms;
+        if (phase < sweep->duration_ms) {
+            angle = (180 * phase) / sweep->duration_ms;
+        } else if (phase < 2 * sweep->duration_ms) {
+            angle = 180 - (180 * (phase - sweep->duration_ms)) / sweep->duration_ms;
+        }
+    }
+
+    if (angle != sweep->current_angle) {
+        lv_radar_sweep_update(sweep, angle);
+    }
 }
 
 /**
  * @brief Create a radar sweep object with trailing shadow
- * 
- * @param parent The parent LVGL object (should be the radar container)
- * @param center_x The X coordinate of the radar center
- * @param center_y The Y coordinate of the radar center
- * @param radius The radius of the semi-circle
+ *
+ * All line objects and their point storage are created here; updates only
+ * move points. The trail length is CONFIG_SKN_SWEEP_TRAIL_LEN. The radar
+ * keeps the sweep on its geometry and frees it when the radar is deleted.
+ *
+ * @param parent The radar widget
  * @param duration_ms Duration of one complete sweep in milliseconds
- * @param loop Whether to loop the animation
- * @return Pointer to the created sweep structure (must be freed by user)
+ * @param loop Keep sweeping after the first pass
+ * @return Pointer to the created sweep structure
  */
 lv_radar_sweep_t *lv_radar_sweep_create(lv_obj_t *parent,  uint32_t duration_ms, bool loop) {
+    lv_radar_t *radar = (lv_radar_t *)parent;
+
+    LV_ASSERT_OBJ(parent, &lv_radar_class);
+    if (radar->sweep != NULL) return radar->sweep;
+
     // Allocate sweep structure
-    lv_radar_sweep_t *sweep = (lv_radar_sweep_t *)malloc(sizeof(lv_radar_sweep_t));
+    lv_radar_sweep_t *sweep = (lv_radar_sweep_t *)calloc(1, sizeof(lv_radar_sweep_t));
     if (sweep == NULL) return NULL;
-    
+
     sweep->parent = parent;
-    sweep->center_x = center_x;
-    sweep->center_y = center_y;
-    sweep->radius = radius;
+    sweep->center_x = radar->center_x;
+    sweep->center_y = radar->center_y;
+    sweep->radius = radar->radius;
     sweep->current_angle = 0;
-    sweep->sweep_line = NULL;
-    for (int i = 0; i < 5; i++) {
-        sweep->shadow_lines[i] = NULL;
+    sweep->direction = 1;
+    sweep->trail_len = CONFIG_SKN_SWEEP_TRAIL_LEN;
+
+    // Shadows first so the sweep line draws on top; opacity fades with distance
+    for (uint8_t i = 0; i < sweep->trail_len; i++) {
+        sweep->shadow_lines[i] = lv_line_create(parent);
+        lv_obj_add_style(sweep->shadow_lines[i], &style_shadow, 0);
+        lv_obj_set_style_line_opa(sweep->shadow_lines[i], LV_OPA_COVER - (i * LV_OPA_COVER) / (sweep->trail_len + 1), 0);
+        lv_obj_remove_flag(sweep->shadow_lines[i], LV_OBJ_FLAG_CLICKABLE);
     }
-    
+    sweep->sweep_line = lv_line_create(parent);
+    lv_obj_add_style(sweep->sweep_line, &style_sweep, 0);
+    lv_obj_remove_flag(sweep->sweep_line, LV_OBJ_FLAG_CLICKABLE);
+
     // Initialize the sweep line at 0 degrees
     lv_radar_sweep_update(sweep, 0);
-    
-    // Create animation for the sweep
-    lv_anim_t anim;
-    lv_anim_init(&anim);
-    lv_anim_set_exec_cb(&anim, lv_radar_sweep_anim_cb);
-    lv_anim_set_var(&anim, sweep);
-    lv_anim_set_values(&anim, 0, 180);
-    lv_anim_set_duration(&anim, duration_ms);
-    lv_anim_set_playback_duration(&anim, duration_ms);  // Enable back-and-forth motion
-    lv_anim_set_repeat_delay(&anim, 500);  // 500ms delay before next sweep
 
-    if (loop) {
-        lv_anim_set_repeat_count(&anim, LV_ANIM_REPEAT_INFINITE);
-    }
+    // Back-and-forth motion on its own clock, with a pause before the next pass
+    sweep->duration_ms = duration_ms > 0 ? duration_ms : 1;
+    sweep->loop = loop;
+    sweep->start_tick = lv_tick_get();
+    sweep->timer = lv_timer_create(lv_radar_sweep_timer_cb, CONFIG_SKN_SWEEP_PERIOD_MS, sweep);
 
-    lv_anim_start(&anim);
-    
+    radar->sweep = sweep;
     return sweep;
 }
 
+/**
+ * @brief Park or restart the sweep
+ *
+ * A parked sweep rests at 0 degrees and its timer no longer runs, so it
+ * causes no redraws at all.
+ *
+ * @param obj The radar widget
+ * @param run Restart from 0 degrees when true
+ */
+void lv_radar_set_sweep_running(lv_obj_t *obj, bool run)
+{
+    lv_radar_t *radar = (lv_radar_t *)obj;
+
+    LV_ASSERT_OBJ(obj, &lv_radar_class);
+    if (radar->sweep == NULL) return;
+
+    if (run) {
+        radar->sweep->start_tick = lv_tick_get();
+        lv_timer_resume(radar->sweep->timer);
+    } else {
+        lv_timer_pause(radar->sweep->timer);
+        lv_radar_sweep_update(radar->sweep, 0);
+    }
+}
+
 /**
  * @brief Delete a radar sweep object
- * 
+ *
  * @param sweep Pointer to the sweep structure to delete
  */
 void lv_radar_sweep_delete(lv_radar_sweep_t *sweep) {
     if (sweep == NULL) return;
-    
+
+    lv_timer_delete(sweep->timer);
+    ((lv_radar_t *)sweep->parent)->sweep = NULL;
+
     if (sweep->sweep_line != NULL) {
         lv_obj_del(sweep->sweep_line);
     }
-    
-    for (int i = 0; i < 5; i++) {
+
+    for (uint8_t i = 0; i < sweep->trail_len; i++) {
         if (sweep->shadow_lines[i] != NULL) {
             lv_obj_del(sweep->shadow_lines[i]);
         }
     }
-    
+
     free(sweep);
 }
 
 /**
- * @brief Add person markers to the radar screen
- * 
- * @param parent The parent LVGL object (radar container)
- * @param center_x The X coordinate of the radar center
- * @param center_y The Y coordinate of the radar center
- * @param radius The radius of the semi-circle in pixels
- * @param band_count Number of horizontal semi-circular arches (typically 4)
- * @param markers Array of marker structures
- * @param marker_count Number of markers to place
- */
-void lv_radar_add_markers(lv_obj_t *parent, uint8_t band_count, lv_radar_marker_t *markers, uint8_t marker_count) {
-    // Calculate meters per pixel
-    float total_meters = band_count * 2.0f;  // 4 arches * 2 meters each = 8 meters
-    float meters_per_pixel = total_meters / radius;
-    
-    // Create style for person icons
-    static lv_style_t style_marker;
-    lv_style_init(&style_marker);
-    lv_style_set_text_color(&style_marker, lv_color_hex(0xFFFF00));  // Yellow
-    lv_style_set_text_font(&style_marker, &lv_font_montserrat_16);
-    
-    for (uint8_t i = 0; i < marker_count; i++) {
-        lv_radar_marker_t *marker = &markers[i];
-        
-        // Convert distance to pixels
-        float pixel_distance = marker->distance / meters_per_pixel;
-        
-        // Convert angle to radians
-        float angle_rad = (marker->angle * M_PI) / 180.0f;
-        
-        // Calculate position
-        int16_t marker_x = center_x + (int16_t)(pixel_distance * cosf(angle_rad));
-        int16_t marker_y = center_y - (int16_t)(pixel_distance * sinf(angle_rad));
-        
-        // Create person icon (using Unicode person symbol)
-        lv_obj_t *icon = lv_label_create(parent);
-        lv_label_set_text(icon, "👤");  // Person emoji
-        lv_obj_add_style(icon, &style_marker, 0);
-        
-        // Position the icon (center it on the calculated position)
-        lv_obj_set_pos(icon, marker_x - 8, marker_y - 8);  // 16x16 icon, so offset by half
-        
-        // Store reference to icon in marker structure
-        marker->icon = icon;
-    }
-}
-
-/**
- * @brief Update marker positions (useful if radar parameters change)
- * 
- * @param center_x The X coordinate of the radar center
- * @param center_y The Y coordinate of the radar center
- * @param radius The radius of the semi-circle in pixels
- * @param band_count Number of horizontal semi-circular arches
+ * @brief Point a marker image at the sprite for its current state
+ *
+ * Switching sources between same-sized sprites only invalidates the marker.
+ */
+static void lv_radar_marker_set_sprite(lv_radar_marker_t *marker)
+{
+    const lv_image_dsc_t *sprite = skn_sprite_get(marker->track, marker->heading,
+                                                  skn_sprite_speed_class(marker->speed_mms));
+    if (sprite != NULL && sprite != marker->sprite) {
+        lv_image_set_src(marker->icon, sprite);
+        marker->sprite = sprite;
+    }
+}
+
+/**
+ * @brief Update marker positions and sprites
+ *
+ * @param obj The radar widget
  * @param markers Array of marker structures
  * @param marker_count Number of markers
  */
-void lv_radar_update_markers(uint8_t band_count, lv_radar_marker_t *markers, uint8_t marker_count)
+void lv_radar_update_markers(lv_obj_t *obj, lv_radar_marker_t *markers, uint8_t marker_count)
 {
-    // Calculate meters per pixel
-    float total_meters = band_count * 2.0f;
-    float meters_per_pixel = total_meters / radius;
-    
+    lv_point_t p;
+
     for (uint8_t i = 0; i < marker_count; i++) {
         lv_radar_marker_t *marker = &markers[i];
-        
-        // Convert distance to pixels
-        float pixel_distance = marker->distance / meters_per_pixel;
-        
-        // Convert angle to radians
-        float angle_rad = (marker->angle * M_PI) / 180.0f;
-        
-        // Calculate position
-        int16_t marker_x = center_x + (int16_t)(pixel_distance * cosf(angle_rad));
-        int16_t marker_y = center_y - (int16_t)(pixel_distance * sinf(angle_rad));
-        
-        // Update position
-        lv_obj_set_pos(marker->icon, marker_x - 8, marker_y - 8);
+
+        lv_radar_mm_to_point(obj, marker->x_mm, marker->y_mm, &p);
+
+        // Update position, centring the sprite on the target
+        lv_obj_set_pos(marker->icon, p.x - SKN_SPRITE_SZ / 2, p.y - SKN_SPRITE_SZ / 2);
+        lv_radar_marker_set_sprite(marker);
     }
 }
 
 /**
- * @brief Remove all radar markers
- * 
- * @param markers Array of marker structures
- * @param marker_count Number of markers
+ * @brief Create the widget's marker pool, one hidden sprite image per track
+ *
+ * Sprites come from the atlas lv_radar_panel_build() renders first; a marker
+ * without one picks it up on its next update.
  */
-void lv_radar_remove_markers(lv_radar_marker_t *markers, uint8_t marker_count)
+static void lv_radar_markers_create(lv_radar_t *radar) {
+    for (uint8_t i = 0; i < LV_RADAR_MAX_MARKERS; i++) {
+        lv_radar_marker_t *marker = &radar->markers[i];
+
+        // Marker is a sprite image; state changes swap the source, never the object
+        *marker = (lv_radar_marker_t){.track = i, .heading = SKN_SPRITE_NO_HEADING};
+        marker->icon = lv_image_create((lv_obj_t *)radar);
+        lv_obj_remove_flag(marker->icon, LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_add_flag(marker->icon, LV_OBJ_FLAG_HIDDEN);
+        lv_radar_marker_set_sprite(marker);
+    }
+}
+
+static void lv_radar_zoom_anim_cb(void *var, int32_t value) {
+    lv_radar_t *radar = (lv_radar_t *)var;
+
+    radar->range_mm = (uint16_t)value;
+    lv_radar_apply_range(radar);
+}
+
+/**
+ * @brief Animate the range to an auto-range step
+ *
+ * The grid is a scaled blit of the cached grids while the zoom runs; only
+ * markers, zone outlines and attached layers move.
+ */
+static void lv_radar_zoom_to(lv_radar_t *radar, uint8_t scale) {
+    lv_anim_t anim;
+
+    radar->scale = scale;
+    radar->pending_scale = LV_RADAR_NO_SCALE;
+    lv_anim_delete(radar, lv_radar_zoom_anim_cb);
+    if (CONFIG_SKN_RADAR_ZOOM_MS == 0) {
+        lv_radar_zoom_anim_cb(radar, radar_scales_mm[scale]);
+        return;
+    }
+
+    lv_anim_init(&anim);
+    lv_anim_set_exec_cb(&anim, lv_radar_zoom_anim_cb);
+    lv_anim_set_var(&anim, radar);
+    lv_anim_set_values(&anim, radar->range_mm, radar_scales_mm[scale]);
+    lv_anim_set_duration(&anim, CONFIG_SKN_RADAR_ZOOM_MS);
+    lv_anim_set_path_cb(&anim, lv_anim_path_ease_in_out);
+    lv_anim_start(&anim);
+}
+
+/**
+ * @brief Pick the auto-range step for the farthest active track
+ *
+ * Zooming out happens at once so a track never leaves the screen; zooming in,
+ * or back to full range once the room is empty, waits for
+ * CONFIG_SKN_RADAR_ZOOM_HOLD_MS so a track hovering at a boundary does not
+ * make the view pump.
+ */
+static void lv_radar_auto_range(lv_radar_t *radar, const skn_target_frame_t *frame) {
+    uint32_t farthest = 0;
+    uint8_t zoom_out = LV_RADAR_SCALES - 1;
+    uint8_t zoom_in = LV_RADAR_SCALES - 1;
+
+    // Keep the scale still while zone handles are being dragged
+    if (!radar->auto_range || lv_radar_zone_editor_active()) return;
+
+    for (uint8_t i = 0; i < frame->count; i++) {
+        farthest = LV_MAX(farthest, frame->targets[i].distance_mm);
+    }
+    for (int8_t i = LV_RADAR_SCALES - 2; i >= 0; i--) {
+        if (farthest * 100 <= (uint32_t)radar_scales_mm[i] * LV_RADAR_ZOOM_OUT_PCT) zoom_out = i;
+        if (frame->count > 0 && farthest * 100 <= (uint32_t)radar_scales_mm[i] * LV_RADAR_ZOOM_IN_PCT) zoom_in = i;
+    }
+
+    if (zoom_out > radar->scale) {
+        lv_radar_zoom_to(radar, zoom_out);
+    } else if (zoom_in != radar->scale) {
+        if (radar->pending_scale != zoom_in) {
+            radar->pending_scale = zoom_in;
+            radar->pending_tick = lv_tick_get();
+        } else if (lv_tick_elaps(radar->pending_tick) >= CONFIG_SKN_RADAR_ZOOM_HOLD_MS) {
+            lv_radar_zoom_to(radar, zoom_in);
+        }
+    } else {
+        radar->pending_scale = LV_RADAR_NO_SCALE;
+    }
+}
+
+/**
+ * @brief Enable or disable automatic range selection
+ *
+ * @param obj The radar widget
+ * @param enable Follow the farthest track over the 2/4/8 m steps; when
+ *               disabled the range stays where it is until lv_radar_set_range()
+ */
+void lv_radar_set_auto_range(lv_obj_t *obj, bool enable)
 {
-    for (uint8_t i = 0; i < marker_count; i++) {
-        if (markers[i].icon != NULL) {
-            lv_obj_del(markers[i].icon);
-            markers[i].icon = NULL;
+    lv_radar_t *radar = (lv_radar_t *)obj;
+
+    LV_ASSERT_OBJ(obj, &lv_radar_class);
+    radar->auto_range = enable;
+    radar->pending_scale = LV_RADAR_NO_SCALE;
+}
+
+/**
+ * @brief Put a marker at a position in sensor millimetres
+ */
+static void lv_radar_marker_place(lv_radar_t *radar, lv_radar_marker_t *marker, int32_t x_mm, int32_t y_mm)
+{
+    marker->x_mm = (int16_t)LV_CLAMP(INT16_MIN, x_mm, INT16_MAX);
+    marker->y_mm = (int16_t)LV_CLAMP(INT16_MIN, y_mm, INT16_MAX);
+    lv_radar_update_markers((lv_obj_t *)radar, marker, 1);
+}
+
+/**
+ * @brief Take a new measurement into a track and estimate its velocity
+ *
+ * Velocity comes from the displacement over the sensor timestamps of two
+ * consecutive frames; gaps, track swaps and implausible speeds reset it.
+ */
+static void lv_radar_track_measure(lv_radar_track_t *track, const skn_target_t *t, const skn_target_t *p,
+                                   int64_t time_us, int64_t prev_time_us)
+{
+    int64_t dt_us = time_us - prev_time_us;
+
+    track->vx_mms = 0;
+    track->vy_mms = 0;
+    if (p != NULL && dt_us > 0 && dt_us <= LV_RADAR_TRACK_GAP_US &&
+        abs(t->x_mm - p->x_mm) + abs(t->y_mm - p->y_mm) <= LV_RADAR_TRACK_JUMP_MM) {
+        int32_t vx = (int32_t)(((int64_t)(t->x_mm - p->x_mm) * 1000000) / dt_us);
+        int32_t vy = (int32_t)(((int64_t)(t->y_mm - p->y_mm) * 1000000) / dt_us);
+        if (abs(vx) + abs(vy) <= LV_RADAR_TRACK_MAX_MMS) {
+            track->vx_mms = vx;
+            track->vy_mms = vy;
+        }
+    }
+    track->x_mm = t->x_mm;
+    track->y_mm = t->y_mm;
+    track->time_us = time_us;
+}
+
+/**
+ * @brief Put the back snapshot on screen and keep the old one for comparison
+ *
+ * Only markers whose target moved or changed state are touched, so LVGL
+ * invalidates just their old and new rectangles; an empty room redraws
+ * nothing at all. A marker that was extrapolated snaps to the measurement.
+ */
+static void lv_radar_frame_swap(lv_radar_t *radar)
+{
+    radar->front ^= 1;
+    const skn_target_frame_t *frame = &radar->frames[radar->front];
+    const skn_target_frame_t *prev = &radar->frames[radar->front ^ 1];
+
+    for (uint8_t i = 0; i < LV_RADAR_MAX_MARKERS; i++) {
+        lv_radar_marker_t *marker = &radar->markers[i];
+        lv_radar_track_t *track = &radar->tracks[i];
+        bool hidden = lv_obj_has_flag(marker->icon, LV_OBJ_FLAG_HIDDEN);
+
+        if (i >= frame->count) {
+            if (!hidden) lv_obj_add_flag(marker->icon, LV_OBJ_FLAG_HIDDEN);
+            continue;
+        }
+
+        const skn_target_t *t = &frame->targets[i];
+        const skn_target_t *p = i < prev->count ? &prev->targets[i] : NULL;
+        bool changed = hidden || p == NULL || t->x_mm != p->x_mm || t->y_mm != p->y_mm || t->speed_mms != p->speed_mms;
+
+        lv_radar_track_measure(track, t, p, frame->timestamp_us, prev->timestamp_us);
+        if (!changed && !track->predicted) continue;
+
+        if (p != NULL) {
+            uint8_t heading = skn_sprite_heading(t->x_mm - p->x_mm, t->y_mm - p->y_mm);
+            marker->heading = heading != SKN_SPRITE_NO_HEADING ? heading : marker->heading;
+        }
+
+        marker->speed_mms = t->speed_mms;
+        lv_radar_marker_place(radar, marker, t->x_mm, t->y_mm);
+        track->predicted = false;
+        if (hidden) lv_obj_remove_flag(marker->icon, LV_OBJ_FLAG_HIDDEN);
+    }
+
+    lv_radar_auto_range(radar, frame);
+}
+
+#if CONFIG_SKN_PREDICT_ENABLE
+/**
+ * @brief Dead-reckon moving markers between sensor frames
+ *
+ * Each marker advances from its last measurement along its last velocity up
+ * to the current time. The extrapolation stops after CONFIG_SKN_PREDICT_MAX_MS
+ * and never strays more than CONFIG_SKN_PREDICT_MAX_MM per axis, so a target
+ * that stopped or turned is off by a bounded amount until the next frame
+ * corrects it. Stationary markers are not touched.
+ */
+static void lv_radar_predict_timer_cb(lv_timer_t *timer)
+{
+    lv_radar_t *radar = lv_timer_get_user_data(timer);
+    int64_t now_us = esp_timer_get_time();
+
+    for (uint8_t i = 0; i < LV_RADAR_MAX_MARKERS; i++) {
+        lv_radar_marker_t *marker = &radar->markers[i];
+        lv_radar_track_t *track = &radar->tracks[i];
+
+        if ((track->vx_mms == 0 && track->vy_mms == 0) || lv_obj_has_flag(marker->icon, LV_OBJ_FLAG_HIDDEN)) {
+            continue;
+        }
+
+        int32_t dt_ms = (int32_t)LV_MIN((now_us - track->time_us) / 1000, CONFIG_SKN_PREDICT_MAX_MS);
+        if (dt_ms <= 0) continue;
+
+        int32_t dx = LV_CLAMP(-CONFIG_SKN_PREDICT_MAX_MM, track->vx_mms * dt_ms / 1000, CONFIG_SKN_PREDICT_MAX_MM);
+        int32_t dy = LV_CLAMP(-CONFIG_SKN_PREDICT_MAX_MM, track->vy_mms * dt_ms / 1000, CONFIG_SKN_PREDICT_MAX_MM);
+
+        lv_radar_marker_place(radar, marker, track->x_mm + dx, LV_MAX(track->y_mm + dy, 0));
+        track->predicted = true;
+    }
+}
+#endif
+
+/**
+ * @brief Show the targets of a sensor frame on the marker pool
+ *
+ * Heading comes from each track's motion since the previous frame.
+ *
+ * @param obj The radar widget
+ * @param frame Sensor frame; slots beyond frame->count are hidden
+ */
+void lv_radar_set_targets(lv_obj_t *obj, const skn_target_frame_t *frame)
+{
+    lv_radar_t *radar = (lv_radar_t *)obj;
+
+    LV_ASSERT_OBJ(obj, &lv_radar_class);
+    radar->frames[radar->front ^ 1] = *frame;
+    lv_radar_frame_swap(radar);
+}
+
+/**
+ * @brief Frame clock: act only when the sensor published a new frame
+ *
+ * The store is copied straight into the back snapshot; a frame that was
+ * already shown costs one sequence compare.
+ */
+static void lv_radar_live_timer_cb(lv_timer_t *timer)
+{
+    lv_radar_t *radar = lv_timer_get_user_data(timer);
+    skn_target_frame_t *back = &radar->frames[radar->front ^ 1];
+
+    if (skn_targets_latest(back) == radar->frames[radar->front].seq) {
+        return;
+    }
+    lv_radar_frame_swap(radar);
+    skn_telemetry_ui_frame();
+}
+
+/**
+ * @brief Feed the widget from the shared sensor target store
+ *
+ * @param obj The radar widget
+ * @param enable Poll for new frames every CONFIG_SKN_SENSOR_POLL_MS
+ */
+void lv_radar_set_live(lv_obj_t *obj, bool enable)
+{
+    lv_radar_t *radar = (lv_radar_t *)obj;
+
+    LV_ASSERT_OBJ(obj, &lv_radar_class);
+    if (enable && radar->live_timer == NULL) {
+        radar->live_timer = lv_timer_create(lv_radar_live_timer_cb, CONFIG_SKN_SENSOR_POLL_MS, radar);
+#if CONFIG_SKN_PREDICT_ENABLE
+        radar->predict_timer = lv_timer_create(lv_radar_predict_timer_cb, CONFIG_SKN_PREDICT_PERIOD_MS, radar);
+#endif
+    } else if (!enable && radar->live_timer != NULL) {
+        lv_timer_delete(radar->live_timer);
+        radar->live_timer = NULL;
+        if (radar->predict_timer != NULL) {
+            lv_timer_delete(radar->predict_timer);
+            radar->predict_timer = NULL;
+        }
+    }
+}
+
+/**
+ * @brief Recompute the mm -> pixel scale after the radius or range changed
+ */
+static void lv_radar_xform_update(lv_radar_t *radar) {
+    radar->px_per_mm_q16 = skn_radar_px_per_mm_q16(radar->radius, radar->range_mm);
+}
+
+/**
+ * @brief Convert sensor millimetres to radar widget pixels
+ *
+ * The sensor frame maps onto the screen by a scale and an offset with the y
+ * axis flipped, so this is one multiply and round per axis with no polar
+ * round-trip. Results are rounded to the nearest pixel.
+ */
+void lv_radar_mm_to_point(const lv_obj_t *obj, int16_t x_mm, int16_t y_mm, lv_point_t *point)
+{
+    const lv_radar_t *radar = (const lv_radar_t *)obj;
+
+    point->x = radar->center_x + skn_radar_mm_to_px(x_mm, radar->px_per_mm_q16);
+    point->y = radar->center_y - skn_radar_mm_to_px(y_mm, radar->px_per_mm_q16);
+}
+
+/**
+ * @brief Convert radar widget pixels to sensor millimetres, clamped to the range
+ */
+void lv_radar_point_to_mm(const lv_obj_t *obj, const lv_point_t *point, int16_t *x_mm, int16_t *y_mm)
+{
+    const lv_radar_t *radar = (const lv_radar_t *)obj;
+    int32_t range = radar->range_mm;
+    int32_t x = ((int32_t)(point->x - radar->center_x) * range) / radar->radius;
+    int32_t y = ((int32_t)(radar->center_y - point->y) * range) / radar->radius;
+
+    *x_mm = x < -range ? -range : (x > range ? range : x);
+    *y_mm = y < 0 ? 0 : (y > range ? range : y);
+}
+
+/**
+ * @brief Show a zone outline from an explicit polygon
+ *
+ * The line object is moved to the polygon's bounding box and its points made
+ * relative to it, so a change invalidates only the old and new outline areas
+ * instead of everything from the container origin to the polygon.
+ *
+ * @param obj The radar widget
+ * @param index Zone index
+ * @param zone Polygon to draw, e.g. one being edited
+ */
+void lv_radar_zone_overlay_set(lv_obj_t *obj, uint8_t index, const skn_zone_t *zone)
+{
+    lv_radar_t *radar = (lv_radar_t *)obj;
+    lv_point_t p[SKN_ZONE_MAX_VERTICES];
+    int32_t min_x = INT32_MAX, min_y = INT32_MAX;
+
+    if (index >= SKN_ZONE_MAX_ZONES || radar->zone_lines[index] == NULL) return;
+
+    lv_obj_t *line = radar->zone_lines[index];
+    if (zone->vertex_count < 3) {
+        lv_obj_add_flag(line, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+
+    for (uint8_t i = 0; i < zone->vertex_count; i++) {
+        lv_radar_mm_to_point(obj, zone->vertices[i].x_mm, zone->vertices[i].y_mm, &p[i]);
+        min_x = p[i].x < min_x ? p[i].x : min_x;
+        min_y = p[i].y < min_y ? p[i].y : min_y;
+    }
+    for (uint8_t i = 0; i <= zone->vertex_count; i++) {
+        const lv_point_t *v = &p[i % zone->vertex_count];  // Close the polygon
+        radar->zone_points[index][i].x = v->x - min_x;
+        radar->zone_points[index][i].y = v->y - min_y;
+    }
+    lv_obj_set_pos(line, min_x, min_y);
+    lv_line_set_points(line, radar->zone_points[index], zone->vertex_count + 1);
+    lv_obj_remove_flag(line, LV_OBJ_FLAG_HIDDEN);
+}
+
+/**
+ * @brief Refresh the outline of one detection zone from the zone store
+ *
+ * @param obj The radar widget
+ * @param index Zone index
+ */
+void lv_radar_zone_overlay_update(lv_obj_t *obj, uint8_t index)
+{
+    skn_zone_t zone;
+
+    if (index >= SKN_ZONE_MAX_ZONES) return;
+
+    skn_zones_get(index, &zone);
+    lv_radar_zone_overlay_set(obj, index, &zone);
+}
+
+/**
+ * @brief Create outline overlays for all detection zones
+ *
+ * @param obj The radar widget
+ */
+void lv_radar_zones_draw(lv_obj_t *obj)
+{
+    lv_radar_t *radar = (lv_radar_t *)obj;
+
+    for (uint8_t i = 0; i < SKN_ZONE_MAX_ZONES; i++) {
+        if (radar->zone_lines[i] == NULL) {
+            radar->zone_lines[i] = lv_line_create(obj);
+            lv_obj_set_style_line_width(radar->zone_lines[i], 2, 0);
+            lv_obj_set_style_line_color(radar->zone_lines[i], lv_color_hex(zone_colors[i]), 0);
+            lv_obj_set_style_line_opa(radar->zone_lines[i], LV_OPA_80, 0);
+            lv_obj_remove_flag(radar->zone_lines[i], LV_OBJ_FLAG_CLICKABLE);
         }
+        lv_radar_zone_overlay_update(obj, i);
     }
 }
 
+/**
+ * @brief Move everything that depends on range_mm: zones, markers, attached layers
+ */
+static void lv_radar_apply_range(lv_radar_t *radar) {
+    lv_obj_t *obj = (lv_obj_t *)radar;
+
+    lv_radar_xform_update(radar);
+    lv_radar_grid_fit(radar);
+
+    for (uint8_t i = 0; i < SKN_ZONE_MAX_ZONES; i++) {
+        if (radar->zone_lines[i] != NULL) lv_radar_zone_overlay_update(obj, i);
+    }
+
+    for (uint8_t i = 0; i < LV_RADAR_MAX_MARKERS; i++) {
+        if (!lv_obj_has_flag(radar->markers[i].icon, LV_OBJ_FLAG_HIDDEN)) {
+            lv_radar_update_markers(obj, &radar->markers[i], 1);
+        }
+    }
+
+    // Let attached layers (heat map, zone editor) follow
+    lv_obj_send_event(obj, geometry_event, NULL);
+}
+
+/**
+ * @brief Recompute geometry from the widget's size and move every child
+ *
+ * Nothing is created or deleted; the grid caches are re-rendered on demand.
+ */
+static void lv_radar_relayout(lv_radar_t *radar) {
+    lv_obj_t *obj = (lv_obj_t *)radar;
+    int32_t width = lv_obj_get_content_width(obj);
+    int32_t height = lv_obj_get_content_height(obj);
+
+    // Center at bottom for an upward-facing semi-circle; leave some padding
+    radar->center_x = width / 2;
+    radar->center_y = height;
+    radar->radius = LV_MIN(height - 10, width / 2);
+    if (radar->radius < 1) radar->radius = 1;
+
+    // The current step renders in lv_radar_apply_range(), the others on demand
+    // or ahead of time through lv_radar_grid_prerender()
+    lv_radar_grid_free(radar);
+
+    if (radar->sweep != NULL) {
+        radar->sweep->center_x = radar->center_x;
+        radar->sweep->center_y = radar->center_y;
+        radar->sweep->radius = radar->radius;
+        lv_radar_sweep_update(radar->sweep, radar->sweep->current_angle);
+    }
+
+    lv_radar_apply_range(radar);
+}
+
+/**
+ * @brief Event code sent by a radar after its geometry or range changed
+ */
+uint32_t lv_radar_geometry_event(void)
+{
+    lv_radar_styles_init();
+    return geometry_event;
+}
+
+static void lv_radar_constructor(const lv_obj_class_t *class_p, lv_obj_t *obj) {
+    LV_UNUSED(class_p);
+    lv_radar_t *radar = (lv_radar_t *)obj;
+
+    lv_radar_styles_init();
+    radar->scale = LV_RADAR_SCALES - 1;
+    radar->pending_scale = LV_RADAR_NO_SCALE;
+    radar->range_mm = radar_scales_mm[radar->scale];
+#if CONFIG_SKN_RADAR_AUTO_RANGE
+    radar->auto_range = true;
+#endif
+    radar->radius = 1;  // Real geometry arrives with the first LV_EVENT_SIZE_CHANGED
+    lv_radar_xform_update(radar);
+
+    lv_obj_set_style_bg_color(obj, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, 0);
+    lv_obj_set_style_border_width(obj, 0, 0);
+    lv_obj_set_style_radius(obj, 0, 0);
+    lv_obj_set_style_pad_all(obj, 0, 0);
+    lv_obj_remove_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+
+    lv_radar_grid_create(radar);
+    lv_radar_markers_create(radar);
+}
+
+static void lv_radar_destructor(const lv_obj_class_t *class_p, lv_obj_t *obj) {
+    LV_UNUSED(class_p);
+    lv_radar_t *radar = (lv_radar_t *)obj;
+
+    // Children are already gone; only release what LVGL does not own
+    if (radar->live_timer != NULL) {
+        lv_timer_delete(radar->live_timer);
+        radar->live_timer = NULL;
+    }
+    if (radar->predict_timer != NULL) {
+        lv_timer_delete(radar->predict_timer);
+        radar->predict_timer = NULL;
+    }
+    if (radar->sweep != NULL) {
+        lv_timer_delete(radar->sweep->timer);
+        free(radar->sweep);
+        radar->sweep = NULL;
+    }
+    lv_anim_delete(radar, lv_radar_zoom_anim_cb);
+    lv_radar_grid_free(radar);
+}
+
+static void lv_radar_event(const lv_obj_class_t *class_p, lv_event_t *e) {
+    LV_UNUSED(class_p);
+
+    if (lv_obj_event_base(&lv_radar_class, e) != LV_RESULT_OK) return;
+
+    if (lv_event_get_code(e) == LV_EVENT_SIZE_CHANGED) {
+        lv_radar_relayout((lv_radar_t *)lv_event_get_current_target(e));
+    }
+}
+
+/**
+ * @brief Create a radar widget
+ *
+ * @param parent The parent LVGL object
+ * @return The radar widget, sized to fill its parent by default
+ */
+lv_obj_t *lv_radar_create(lv_obj_t *parent)
+{
+    lv_obj_t *obj = lv_obj_class_create_obj(&lv_radar_class, parent);
+    lv_obj_class_init_obj(obj);
+    return obj;
+}
+
+/**
+ * @brief Set the distance represented by the outer band
+ *
+ * @param obj The radar widget
+ * @param range_mm Full-scale range in millimetres
+ */
+void lv_radar_set_range(lv_obj_t *obj, uint16_t range_mm)
+{
+    lv_radar_t *radar = (lv_radar_t *)obj;
+
+    LV_ASSERT_OBJ(obj, &lv_radar_class);
+    lv_anim_delete(radar, lv_radar_zoom_anim_cb);
+    if (range_mm == 0 || range_mm == radar->range_mm) return;
+
+    radar->range_mm = range_mm;
+    lv_radar_apply_range(radar);
+}
+
+uint16_t lv_radar_get_range(const lv_obj_t *obj)
+{
+    return ((const lv_radar_t *)obj)->range_mm;
+}
+
 /**
  * @brief Create a complete radar screen widget
- * 
+ *
  * @param parent The parent LVGL object
  * @param width Width of the radar screen
  * @param height Height of the radar screen
- * @return Pointer to the created container object
+ * @return Pointer to the created radar widget
  */
 lv_obj_t *lv_radar_screen_create(lv_obj_t *parent, int16_t width, int16_t height)
 {
-    // Create a container for the radar
-    lv_obj_t *radar_cont = lv_obj_create(parent);
-    lv_obj_set_size(radar_cont, width, height);
-    lv_obj_set_style_bg_color(radar_cont, lv_color_black(), 0);
-    lv_obj_set_style_border_width(radar_cont, 0, 0);
-    lv_obj_set_style_pad_all(radar_cont, 0, 0);
-
-    // Calculate center and radius
-    center_x = width / 2;
-    center_y = height;  // Center at bottom for upward-facing semi-circle
-    radius = height - 10;  // Leave some padding
+    lv_obj_t *radar = lv_radar_create(parent);
+    lv_obj_set_size(radar, width, height);
+    lv_obj_update_layout(radar);  // Resolve geometry before layers are attached
 
-    // Draw the radar grid
-    lv_radar_screen_draw(radar_cont, 4, 9);
-
-    return radar_cont;
+    return radar;
 }
 
-void lv_radar_panel_init( int16_t xRes, int16_t yRes) {
-    lv_obj_t *scr = lv_obj_create(NULL);
-    lv_screen_load(scr);
-    lv_obj_clean(scr);
-
-    // Draw radar screen
-    lv_obj_t *radar = lv_radar_screen_create(scr, xRes, yRes);
+/**
+ * @brief Build the radar screen for the screen manager, one part per step
+ *
+ * The sprite atlas comes first, then the widget with the grid for the
+ * current range, one step per remaining grid, and the layers, sweep, editor
+ * and live feed one at a time.
+ *
+ * @param scr Screen created by the screen manager
+ * @param step Build step
+ * @return true once the screen is complete
+ */
+bool lv_radar_panel_build(lv_obj_t *scr, uint8_t step) {
+    if (step == 0) {
+        // The widget's marker pool picks the atlas up
+        esp_err_t ret = skn_sprites_init();
+        if (ret != ESP_OK) {
+            ESP_LOGW(RADAR_TAG, "No marker sprites (%s), targets will not be shown", esp_err_to_name(ret));
+        }
+        return false;
+    }
+    if (step == 1) {
+        lv_radar_screen_create(scr, lv_obj_get_width(scr), lv_obj_get_height(scr));
+        return false;
+    }
 
-    lv_radar_sweep_create(radar, 4000, true);
+    // Later steps find the widget on their screen, so rebuilds never share one
+    lv_obj_t *radar = lv_obj_get_child_by_type(scr, 0, &lv_radar_class);
+    if (step < 1 + LV_RADAR_SCALES) {
+        lv_radar_grid_prerender((lv_radar_t *)radar);
+        return false;
+    }
 
-    // Add person markers
-    lv_radar_marker_t markers[2] = {
-        {.distance = 2.5f, .angle = 45, .icon = NULL}, // 2.5 meters at 45 degrees
-        {.distance = 4.5f, .angle = 120, .icon = NULL} // 4.5 meters at 120 degrees
-    };
-    lv_radar_add_markers(radar, 4, markers, 2);
-}
\ No newline at end of file
+    switch (step - 1 - LV_RADAR_SCALES) {
+    case 0:
+        lv_radar_heatmap_create(radar);
+        return false;
+    case 1:
+        lv_radar_zones_draw(radar);
+        return false;
+    case 2:
+        lv_radar_sweep_create(radar, 4000, true);
+        return false;
+    case 3:
+        // Markers above sweep and overlays, editor controls above everything
+        for (uint8_t i = 0; i < LV_RADAR_MAX_MARKERS; i++) {
+            lv_obj_move_foreground(((lv_radar_t *)radar)->markers[i].icon);
+        }
+        lv_radar_zone_editor_create(radar);
+        return false;
+    default:
+        lv_radar_set_live(radar, true);
+#if CONFIG_SKN_FLOOR_PLAN_ENABLE
+        skn_screen_switch_add(scr, SKN_SCREEN_PLAN, "Plan");
+#endif
+#if CONFIG_SKN_IDLE_ENABLE
+        skn_power_governor_start(radar);
+#endif
+        return true;
+    }
+}
@@ -0,0 +1,48 @@
+/*
+ * radar_targets.c
+ * Latest sensor frame shared between the sensor task and the UI.
+ *
+ * Lock-free triple buffer: the sensor task fills its private back buffer and
+ * swaps it with the shared middle slot in one atomic exchange, so publishing
+ * is wait-free and never waits on a reader. The reader side takes the middle
+ * slot only when it holds a fresher frame and otherwise keeps its front
+ * buffer, which nobody else touches. Neither side ever sees a half-written
+ * frame, and sensor latency no longer depends on how long a render takes.
+ *
+ * There is exactly one writer task and one reader task (the LVGL thread);
+ * several readers in that same task are fine.
+ */
+
+#include <stdatomic.h>
+#include "radar_targets.h"
+
+#define SKN_TARGETS_INDEX 0x3u
+#define SKN_TARGETS_FRESH 0x4u // Middle slot holds a frame the reader has not taken
+
+static skn_target_frame_t buffers[3];
+static atomic_uint middle = 2;
+static unsigned int back = 1;  // Owned by the writer
+static unsigned int front = 0; // Owned by the reader
+
+/**
+ * @brief Publish a frame from the sensor task
+ */
+void skn_targets_publish(const skn_target_frame_t *frame)
+{
+    buffers[back] = *frame;
+    back = atomic_exchange_explicit(&middle, back | SKN_TARGETS_FRESH, memory_order_acq_rel) & SKN_TARGETS_INDEX;
+}
+
+/**
+ * @brief Copy the most recently published frame; LVGL thread only
+ *
+ * @return Sequence number of the copied frame, 0 before the first frame
+ */
+uint32_t skn_targets_latest(skn_target_frame_t *frame)
+{
+    if (atomic_load_explicit(&middle, memory_order_relaxed) & SKN_TARGETS_FRESH) {
+        front = atomic_exchange_explicit(&middle, front, memory_order_acq_rel) & SKN_TARGETS_INDEX;
+    }
+    *frame = buffers[front];
+    return frame->seq;
+}
@@ -0,0 +1,286 @@
+/*
+ * rd03d_config.c
+ * RD-03D command channel and boot-time sensor configuration.
+ *
+ * Command frames are FD FC FB FA, a little-endian length, the command word
+ * and its value, then 04 03 02 01. The module answers with the same framing,
+ * the command word with bit 8 set and a 16-bit status (0 = success) ahead of
+ * any data. Commands are only accepted between ENABLE_CONFIG and END_CONFIG,
+ * during which the module stops reporting targets.
+ *
+ * The published protocol covers configuration mode, firmware version and
+ * single/multi-target tracking; it has no range or angle gate, so those gates
+ * are applied to each report here, before a frame reaches any consumer.
+ */
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rd03d_config.h"
+
+#define SKN_RD03D_NVS_NS      "rd03d"
+#define SKN_RD03D_NVS_KEY     "config"
+#define SKN_RD03D_ACK_TIMEOUT 200 // ms per command
+#define SKN_RD03D_FRAME_MAX   (4 + 2 + 2 + SKN_RD03D_ACK_MAX + 4)
+#define SKN_RD03D_TAN_SHIFT   16
+
+static const char *RD03D_TAG = "RD-03D";
+
+static const uint8_t frame_head[4] = {0xFD, 0xFC, 0xFB, 0xFA};
+static const uint8_t frame_tail[4] = {0x04, 0x03, 0x02, 0x01};
+
+/**
+ * @brief What NVS holds: the user settings only, the gate fields are derived
+ */
+typedef struct __attribute__((packed))
+{
+    uint8_t multi_target;
+    uint16_t min_mm;
+    uint16_t max_mm;
+    uint8_t half_angle_deg;
+} skn_rd03d_stored_t;
+
+/**
+ * @brief Fill the derived gate fields so the per-target test stays integer
+ */
+static void skn_rd03d_derive(skn_rd03d_config_t *config)
+{
+    config->tan_q16 = config->half_angle_deg < 90
+                          ? (uint32_t)lroundf(tanf(config->half_angle_deg * (float)M_PI / 180.0f) *
+                                              (1 << SKN_RD03D_TAN_SHIFT))
+                          : 0;
+}
+
+/**
+ * @brief Load the sensor configuration, Kconfig defaults when NVS has none
+ *
+ * A stored configuration outside the ranges /sensor accepts is ignored.
+ */
+esp_err_t skn_rd03d_load_config(skn_rd03d_config_t *config)
+{
+    nvs_handle_t nvs;
+    skn_rd03d_stored_t stored;
+    size_t len = sizeof(stored);
+
+    *config = (skn_rd03d_config_t){
+#if CONFIG_SKN_RD03D_MULTI_TARGET
+        .multi_target = true,
+#endif
+        .min_mm = CONFIG_SKN_RD03D_MIN_MM,
+        .max_mm = CONFIG_SKN_RD03D_MAX_MM,
+        .half_angle_deg = CONFIG_SKN_RD03D_HALF_ANGLE_DEG,
+    };
+
+    if (nvs_open(SKN_RD03D_NVS_NS, NVS_READONLY, &nvs) != ESP_OK) {
+        skn_rd03d_derive(config);
+        return ESP_ERR_NOT_FOUND;
+    }
+    esp_err_t ret = nvs_get_blob(nvs, SKN_RD03D_NVS_KEY, &stored, &len);
+    nvs_close(nvs);
+    if (ret == ESP_OK) {
+        if (len == sizeof(stored) && stored.multi_target <= 1 && stored.min_mm < stored.max_mm &&
+            stored.max_mm <= 8000 && stored.half_angle_deg >= 5 && stored.half_angle_deg <= 90) {
+            config->multi_target = stored.multi_target;
+            config->min_mm = stored.min_mm;
+            config->max_mm = stored.max_mm;
+            config->half_angle_deg = stored.half_angle_deg;
+        } else {
+            ESP_LOGW(RD03D_TAG, "Stored configuration invalid, using defaults");
+            ret = ESP_ERR_INVALID_STATE;
+        }
+    }
+    skn_rd03d_derive(config);
+    return ret;
+}
+
+esp_err_t skn_rd03d_save_config(const skn_rd03d_config_t *config)
+{
+    nvs_handle_t nvs;
+
+    esp_err_t ret = nvs_open(SKN_RD03D_NVS_NS, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    const skn_rd03d_stored_t stored = {
+        .multi_target = config->multi_target,
+        .min_mm = config->min_mm,
+        .max_mm = config->max_mm,
+        .half_angle_deg = config->half_angle_deg,
+    };
+    ret = nvs_set_blob(nvs, SKN_RD03D_NVS_KEY, &stored, sizeof(stored));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    return ret;
+}
+
+/**
+ * @brief Read bytes until a complete ACK frame arrives or the deadline passes
+ *
+ * Target reports still in flight are skipped by resynchronising on the header.
+ */
+static esp_err_t skn_rd03d_read_ack(uart_port_t port, uint8_t *frame, size_t *frame_len)
+{
+    int64_t deadline = esp_timer_get_time() + SKN_RD03D_ACK_TIMEOUT * 1000;
+    size_t have = 0;
+
+    while (esp_timer_get_time() < deadline) {
+        if (uart_read_bytes(port, &frame[have], 1, pdMS_TO_TICKS(10)) != 1) {
+            continue;
+        }
+        have++;
+
+        // Keep the buffer aligned on a frame header; a mismatch may itself start one
+        if (have <= sizeof(frame_head) && frame[have - 1] != frame_head[have - 1]) {
+            if (frame[have - 1] == frame_head[0]) {
+                frame[0] = frame_head[0];
+                have = 1;
+            } else {
+                have = 0;
+            }
+            continue;
+        }
+        if (have < 6) {
+            continue;
+        }
+        size_t body = frame[4] | (frame[5] << 8);
+        if (body < 4 || 6 + body + sizeof(frame_tail) > SKN_RD03D_FRAME_MAX) {
+            have = 0;
+            continue;
+        }
+        if (have == 6 + body + sizeof(frame_tail)) {
+            if (memcmp(&frame[6 + body], frame_tail, sizeof(frame_tail)) != 0) {
+                have = 0;
+                continue;
+            }
+            *frame_len = have;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_TIMEOUT;
+}
+
+/**
+ * @brief Send one command frame and wait for its ACK
+ *
+ * @param port UART the module is on, driver installed
+ * @param command Command word
+ * @param value Command value, may be NULL when value_len is 0
+ * @param ack Receives the ACK data after the status word, may be NULL
+ * @param ack_len In: size of ack. Out: bytes stored
+ * @return ESP_OK, ESP_ERR_TIMEOUT without an answer, ESP_FAIL on a non-zero status
+ */
+esp_err_t skn_rd03d_command(uart_port_t port, uint16_t command, const uint8_t *value, size_t value_len,
+                            uint8_t *ack, size_t *ack_len)
+{
+    uint8_t frame[SKN_RD03D_FRAME_MAX];
+    size_t len = 0;
+
+    if (value_len > SKN_RD03D_ACK_MAX) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(&frame[len], frame_head, sizeof(frame_head));
+    len += sizeof(frame_head);
+    frame[len++] = (uint8_t)(2 + value_len);
+    frame[len++] = (uint8_t)((2 + value_len) >> 8);
+    frame[len++] = (uint8_t)command;
+    frame[len++] = (uint8_t)(command >> 8);
+    if (value_len > 0) {
+        memcpy(&frame[len], value, value_len);
+        len += value_len;
+    }
+    memcpy(&frame[len], frame_tail, sizeof(frame_tail));
+    len += sizeof(frame_tail);
+
+    if (uart_write_bytes(port, frame, len) != (int)len) {
+        return ESP_FAIL;
+    }
+
+    // Skip ACKs of other commands, e.g. a late answer to a previous timeout
+    for (int attempt = 0; attempt < 3; attempt++) {
+        esp_err_t ret = skn_rd03d_read_ack(port, frame, &len);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        uint16_t word = frame[6] | (frame[7] << 8);
+        if (word != (command | 0x0100)) {
+            continue;
+        }
+        uint16_t status = frame[8] | (frame[9] << 8);
+        size_t data_len = len - 10 - sizeof(frame_tail);
+        if (ack != NULL && ack_len != NULL) {
+            *ack_len = data_len < *ack_len ? data_len : *ack_len;
+            memcpy(ack, &frame[10], *ack_len);
+        }
+        return status == 0 ? ESP_OK : ESP_FAIL;
+    }
+    return ESP_ERR_INVALID_RESPONSE;
+}
+
+/**
+ * @brief Configure the module; call after the UART is up and before polling reports
+ *
+ * Enters configuration mode, reads the firmware version, selects single or
+ * multi-target tracking and always leaves configuration mode again.
+ */
+esp_err_t skn_rd03d_apply(uart_port_t port, const skn_rd03d_config_t *config, skn_rd03d_info_t *info)
+{
+    const uint8_t enable_value[2] = {0x01, 0x00};
+    uint8_t ack[SKN_RD03D_ACK_MAX];
+    size_t ack_len = sizeof(ack);
+
+    memset(info, 0, sizeof(*info));
+    uart_flush_input(port);
+
+    esp_err_t ret = skn_rd03d_command(port, SKN_RD03D_CMD_ENABLE_CONFIG, enable_value, sizeof(enable_value),
+                                      ack, &ack_len);
+    if (ret != ESP_OK) {
+        ESP_LOGW(RD03D_TAG, "Module did not enter configuration mode: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    if (ack_len >= 4) {
+        info->protocol = ack[0] | (ack[1] << 8);
+        info->buffer_size = ack[2] | (ack[3] << 8);
+    }
+
+    // Version ACK: type, major (minor.major bytes), 32-bit build number
+    ack_len = sizeof(ack);
+    if (skn_rd03d_command(port, SKN_RD03D_CMD_READ_VERSION, NULL, 0, ack, &ack_len) == ESP_OK && ack_len >= 8) {
+        snprintf(info->firmware, sizeof(info->firmware), "V%u.%02u.%08" PRIx32, ack[3], ack[2],
+                 (uint32_t)ack[4] | ((uint32_t)ack[5] << 8) | ((uint32_t)ack[6] << 16) | ((uint32_t)ack[7] << 24));
+    }
+
+    ret = skn_rd03d_command(port, config->multi_target ? SKN_RD03D_CMD_MULTI_TARGET : SKN_RD03D_CMD_SINGLE_TARGET,
+                            NULL, 0, NULL, NULL);
+    if (ret != ESP_OK) {
+        ESP_LOGW(RD03D_TAG, "Tracking mode not accepted: %s", esp_err_to_name(ret));
+    }
+
+    esp_err_t end = skn_rd03d_command(port, SKN_RD03D_CMD_END_CONFIG, NULL, 0, NULL, NULL);
+    ESP_LOGI(RD03D_TAG, "Firmware %s, protocol %u, %s-target, gate %u..%u mm +/-%u deg",
+             info->firmware[0] ? info->firmware : "unknown", info->protocol,
+             config->multi_target ? "multi" : "single", config->min_mm, config->max_mm, config->half_angle_deg);
+    return ret != ESP_OK ? ret : end;
+}
+
+/**
+ * @brief Whether a target passes the configured range and angle gates
+ */
+bool skn_rd03d_gate(const skn_rd03d_config_t *config, const skn_target_t *target)
+{
+    if (target->distance_mm < config->min_mm || target->distance_mm > config->max_mm) {
+        return false;
+    }
+    if (config->half_angle_deg >= 90) {
+        return true;
+    }
+    // |angle from boresight| <= half angle  <=>  |x| <= y * tan(half angle)
+    return target->y_mm > 0 &&
+           ((int64_t)abs(target->x_mm) << SKN_RD03D_TAN_SHIFT) <= (int64_t)target->y_mm * config->tan_q16;
+}
@@ -18,7 +18,14 @@
 #include "jpeg_decoder.h"
 #include "lvgl.h"
 #include <stdio.h>
+#include "floor_plan.h"
 #include "radar_panel.h"
+#include "screen_manager.h"
+#include "image_cache.h"
+#include "lv_mem_skn.h"
+#include "power.h"
+#include "telemetry.h"
+#include "zone_editor.h"
 
 extern char *TAG; //  = "Display";
 
@@ -27,6 +34,7 @@ extern char *TAG; //  = "Display";
 #define SKN_BUFFER_BASE       (CONFIG_LCD_V_RES * CONFIG_LCD_BUFFER_SIZE_FACTOR)
 #define SKN_DRAW_BUFF_SZ      (SKN_BUFFER_BASE * sizeof(lv_color_t))
 #define SKN_TRANSFER_BUFF_SZ  (CONFIG_LCD_V_RES * (CONFIG_LCD_BUFFER_SIZE_FACTOR * 2) * sizeof(uint16_t))
+#define SKN_DISPLAY_MAX_WAIT_MS 50 // Upper bound on one display task sleep
 
 
 static esp_lcd_touch_handle_t touch_panel = NULL;
@@ -37,7 +45,7 @@ static lv_display_t *display; // contains callback functions
 const uint32_t panel_Hres = CONFIG_LCD_H_RES;
 const uint32_t panel_Vres = CONFIG_LCD_V_RES;
 extern void logMemoryStats(char *message);
-extern void ui_skoona_panel_init();
+extern bool ui_skoona_panel_build(lv_obj_t *scr, uint8_t step);
 extern esp_err_t skn_beep_init();
 extern esp_err_t skn_beep();
 extern esp_err_t fileList();
@@ -45,24 +53,18 @@ extern esp_err_t fileList();
 // Callback function to handle the switch
 void timer_switch_scr_cb(lv_timer_t *timer)
 {
-	lv_lock();
-		// Load the new screen
-		lv_obj_t *scr = lv_display_get_screen_active(NULL);		
-
-		lv_radar_panel_init(panel_Vres, panel_Hres);
-
-		// Delete this timer so it only happens once
-		lv_timer_del(timer);
+	// The radar was built on idle frames during the intro, so this is only a screen load
+	skn_screen_show(SKN_SCREEN_RADAR);
 
-		if (scr != NULL){
-			lv_obj_del(scr);
-			scr = NULL;
-		}
-	lv_unlock();
+	// Delete this timer so it only happens once
+	lv_timer_delete(timer);
 }
 
 void skn_touch_event_handler(lv_event_t *e) {
 	lv_point_t p;
+	if (lv_radar_zone_editor_active()) {
+		return; // Taps belong to the zone editor
+	}
 	lv_indev_get_point(e->user_data, &p);
 	int32_t screen_width = lv_obj_get_width(lv_scr_act());
 	int32_t screen_height = lv_obj_get_height(lv_scr_act());
@@ -91,8 +93,26 @@ static void skn_lvgl_flush_cb(lv_display_t *display, const lv_area_t *area, uint
 	int offsety2 = area->y2;
 	esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1,
 							  offsety2 + 1, color_map);
+	skn_telemetry_flush(lv_area_get_size(area));
 	lv_display_flush_ready(display);
 }
+static void skn_display_refr_event_cb(lv_event_t *e) {
+	lv_event_code_t code = lv_event_get_code(e);
+
+	if (code == LV_EVENT_RENDER_START) {
+		skn_power_boost_begin(SKN_POWER_BOOST_RENDER);
+		skn_telemetry_render_begin();
+	} else if (code == LV_EVENT_RENDER_READY) {
+		skn_telemetry_render_end();
+		skn_power_boost_end(SKN_POWER_BOOST_RENDER);
+	}
+}
+#if CONFIG_SKN_BENCH_RENDER_LOAD
+/* Scheduling-latency benchmark: redraw the whole screen every refresh */
+static void skn_bench_render_load_cb(lv_timer_t *timer) {
+	lv_obj_invalidate(lv_screen_active());
+}
+#endif
 static uint32_t skn_tick_cb(void) {
 	return (uint32_t)esp_timer_get_time() / 1000ULL;
 }
@@ -268,6 +288,7 @@ esp_err_t skn_lvgl_init() {
 
 	lv_init();
 	lv_tick_set_cb(skn_tick_cb);
+	skn_lv_mem_init_draw_bufs();
 
 	ESP_LOGI(TAG, "Register display driver to LVGL");
 	display = lv_display_create(CONFIG_LCD_V_RES, CONFIG_LCD_H_RES);
@@ -288,40 +309,54 @@ esp_err_t skn_lvgl_init() {
 
 	lv_display_set_flush_cb(display, skn_lvgl_flush_cb);
 	lv_display_set_user_data(display, lcd_panel);
+	lv_display_add_event_cb(display, skn_display_refr_event_cb, LV_EVENT_RENDER_START, NULL);
+	lv_display_add_event_cb(display, skn_display_refr_event_cb, LV_EVENT_RENDER_READY, NULL);
 
 	esp_lv_decoder_handle_t decoder_handle = NULL;
 	esp_lv_decoder_init(&decoder_handle); // Initialize this after lvgl starts
 
+	skn_image_cache_init(CONFIG_SKN_IMAGE_CACHE_BUDGET_KB * 1024);
+
 	return ESP_OK;
 }
 
 void vDisplayServiceTask(void *pvParameters) {
 
 	ESP_LOGI(TAG, "Configure and Turn off LCD backlight");
-	gpio_config_t bk_gpio_config = {.mode = GPIO_MODE_OUTPUT,
-									.pin_bit_mask =
-										1ULL << CONFIG_LCD_BACK_LIGHT_GPIO};
-	ESP_ERROR_CHECK(gpio_config(&bk_gpio_config));
-	gpio_set_level(CONFIG_LCD_BACK_LIGHT_GPIO, !CONFIG_LCD_BACK_LIGHT_ON_LEVEL);
+	ESP_ERROR_CHECK(skn_backlight_init());
 
 	ESP_ERROR_CHECK(skn_lcd_init());
 	ESP_ERROR_CHECK(skn_lvgl_init());
 	ESP_ERROR_CHECK(skn_touch_init());
 
 	ESP_LOGI(TAG, "Turn on LCD backlight");
-	gpio_set_level(CONFIG_LCD_BACK_LIGHT_GPIO, CONFIG_LCD_BACK_LIGHT_ON_LEVEL);
+	skn_backlight_set(100);
 
 	lv_lock();
+#if CONFIG_SKN_BENCH_RENDER_LOAD
+		lv_timer_create(skn_bench_render_load_cb, LV_DEF_REFR_PERIOD, NULL);
+#endif
+		skn_screen_manager_init(display);
+		skn_screen_register(SKN_SCREEN_INTRO, "Intro", ui_skoona_panel_build, false);
+		skn_screen_register(SKN_SCREEN_RADAR, "Radar", lv_radar_panel_build, true);
+#if CONFIG_SKN_FLOOR_PLAN_ENABLE
+		skn_screen_register(SKN_SCREEN_PLAN, "Floor plan", skn_floor_plan_build, true);
+#endif
+		skn_screen_show(SKN_SCREEN_INTRO);
+		skn_screen_preload(SKN_SCREEN_RADAR);
+		skn_screen_preload(SKN_SCREEN_PLAN);
 		lv_timer_create(timer_switch_scr_cb, 15000, NULL);
-		ui_skoona_panel_init();	
-		// lv_radar_panel_init(panel_Vres, panel_Hres);
 	lv_unlock();
 
 	while (1)
 	{
 		lv_lock();
-		lv_timer_periodic_handler();
+		uint32_t wait_ms = lv_timer_handler();
 		lv_unlock();
+
+		// Sleep until the next LVGL timer is due so lower priority work on this core can run
+		wait_ms = LV_CLAMP(1, wait_ms, SKN_DISPLAY_MAX_WAIT_MS);
+		vTaskDelay(LV_MAX(1, pdMS_TO_TICKS(wait_ms)));
 	}
 
 }
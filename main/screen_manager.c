@@ -0,0 +1,272 @@
+/*
+ * screen_manager.c
+ * Resident screens, built incrementally on idle frames.
+ *
+ * Every screen is registered with a step-wise build callback. Preloading a
+ * screen queues it, and a timer runs one build step at a time, only on a
+ * frame where the display has nothing to redraw, so building the radar no
+ * longer stalls whatever is on screen. Built screens stay resident and a
+ * switch is a single lv_screen_load_anim(); only screens registered as not
+ * resident (the intro) are deleted once they have been left.
+ *
+ * Each switch is measured from the call until the first frame that shows
+ * the new screen completes: the cost of the call itself, the number of
+ * rendered frames and the worst render time in that window are logged.
+ */
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "screen_manager.h"
+
+#define SKN_SCREEN_IDLE_WAIT_MS 1000 // Build anyway when the display is never idle this long
+
+static const char *SCREEN_TAG = "Screens";
+
+typedef struct
+{
+    const char *name;
+    skn_screen_build_cb_t build;
+    lv_obj_t *obj;
+    uint8_t step;       // Next build step
+    bool resident;      // Kept after it has been left
+    bool queued;        // Waiting for idle frames to be built
+    bool complete;
+    int64_t build_us;   // Total time spent in build steps
+    int64_t step_max_us; // Longest single step
+} skn_screen_t;
+
+/**
+ * @brief Frame timing of the switch in progress
+ */
+typedef struct
+{
+    bool active;
+    bool loaded;      // New screen is active, the next completed frame ends the window
+    skn_screen_id_t from;
+    skn_screen_id_t to;
+    int64_t start_us;
+    int64_t call_us;  // Time spent inside skn_screen_show()
+    int64_t render_start_us;
+    int64_t worst_us; // Longest rendered frame in the window
+    uint32_t frames;
+} skn_screen_switch_t;
+
+static skn_screen_t screens[SKN_SCREEN_COUNT];
+static skn_screen_switch_t sw = {.from = SKN_SCREEN_COUNT};
+static lv_timer_t *build_timer = NULL;
+static uint32_t last_render_tick = 0; // Last refresh that actually drew something
+static uint32_t idle_wait_tick = 0;
+
+static skn_screen_id_t skn_screen_find(const lv_obj_t *obj)
+{
+    for (uint8_t i = 0; i < SKN_SCREEN_COUNT; i++) {
+        if (obj != NULL && screens[i].obj == obj) {
+            return (skn_screen_id_t)i;
+        }
+    }
+    return SKN_SCREEN_COUNT;
+}
+
+static const char *skn_screen_name(skn_screen_id_t id)
+{
+    return id < SKN_SCREEN_COUNT && screens[id].name != NULL ? screens[id].name : "boot";
+}
+
+static void skn_screen_delete_cb(lv_event_t *e)
+{
+    skn_screen_t *s = lv_event_get_user_data(e);
+
+    s->obj = NULL;
+    s->step = 0;
+    s->complete = false;
+    s->queued = false;
+}
+
+static void skn_screen_loaded_cb(lv_event_t *e)
+{
+    if (sw.active && lv_event_get_user_data(e) == &screens[sw.to]) {
+        sw.loaded = true;
+    }
+}
+
+/**
+ * @brief Run the next build step of a screen, creating it first if needed
+ */
+static void skn_screen_build_step(skn_screen_t *s)
+{
+    int64_t start_us = esp_timer_get_time();
+
+    if (s->obj == NULL) {
+        s->obj = lv_obj_create(NULL);
+        lv_obj_add_event_cb(s->obj, skn_screen_delete_cb, LV_EVENT_DELETE, s);
+        lv_obj_add_event_cb(s->obj, skn_screen_loaded_cb, LV_EVENT_SCREEN_LOADED, s);
+    }
+    s->complete = s->build(s->obj, s->step++);
+
+    int64_t step_us = esp_timer_get_time() - start_us;
+    s->build_us += step_us;
+    s->step_max_us = step_us > s->step_max_us ? step_us : s->step_max_us;
+    if (s->complete) {
+        s->queued = false;
+        ESP_LOGI(SCREEN_TAG, "%s built in %u steps, %lld us total, longest step %lld us", s->name, s->step,
+                 s->build_us, s->step_max_us);
+    }
+}
+
+/**
+ * @brief Run one queued build step if the last refresh period drew nothing
+ *
+ * LV_EVENT_REFR_READY fires on every refresh tick, even with nothing
+ * invalidated; LV_EVENT_RENDER_READY only when areas were rendered, so a
+ * full period without it means the display is idle.
+ */
+static void skn_screen_build_timer_cb(lv_timer_t *timer)
+{
+    skn_screen_t *next = NULL;
+
+    for (uint8_t i = 0; i < SKN_SCREEN_COUNT && next == NULL; i++) {
+        if (screens[i].queued && !screens[i].complete) {
+            next = &screens[i];
+        }
+    }
+    if (next == NULL) {
+        lv_timer_pause(timer);
+        return;
+    }
+
+    // Leave busy frames (animations, a switch) alone unless they never stop
+    bool idle = lv_tick_elaps(last_render_tick) >= LV_DEF_REFR_PERIOD && !sw.active;
+    if (!idle && lv_tick_elaps(idle_wait_tick) < SKN_SCREEN_IDLE_WAIT_MS) {
+        return;
+    }
+    idle_wait_tick = lv_tick_get();
+    skn_screen_build_step(next);
+}
+
+/**
+ * @brief Time rendered frames; inside a switch window keep the worst one
+ */
+static void skn_screen_render_event_cb(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+
+    if (code == LV_EVENT_RENDER_START) {
+        sw.render_start_us = esp_timer_get_time();
+        return;
+    }
+
+    last_render_tick = lv_tick_get();
+    if (!sw.active || sw.render_start_us == 0) {
+        return;
+    }
+
+    int64_t render_us = esp_timer_get_time() - sw.render_start_us;
+    sw.worst_us = render_us > sw.worst_us ? render_us : sw.worst_us;
+    sw.frames++;
+    if (sw.loaded) {
+        ESP_LOGI(SCREEN_TAG, "Switch %s -> %s: call %lld us, %u frames in %lld us, worst frame %lld us",
+                 skn_screen_name(sw.from), skn_screen_name(sw.to), sw.call_us, (unsigned)sw.frames,
+                 esp_timer_get_time() - sw.start_us, sw.worst_us);
+        sw.active = false;
+    }
+}
+
+/**
+ * @brief Attach the manager to a display; call once before registering screens
+ */
+void skn_screen_manager_init(lv_display_t *disp)
+{
+    lv_display_add_event_cb(disp, skn_screen_render_event_cb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(disp, skn_screen_render_event_cb, LV_EVENT_RENDER_READY, NULL);
+    build_timer = lv_timer_create(skn_screen_build_timer_cb, CONFIG_SKN_SCREEN_BUILD_PERIOD_MS, NULL);
+    lv_timer_pause(build_timer);
+}
+
+/**
+ * @brief Register a screen; nothing is created until it is preloaded or shown
+ *
+ * @param id Screen slot
+ * @param name Name used in logs
+ * @param build Step-wise build callback
+ * @param resident Keep the screen after it has been left, otherwise delete it
+ */
+void skn_screen_register(skn_screen_id_t id, const char *name, skn_screen_build_cb_t build, bool resident)
+{
+    screens[id] = (skn_screen_t){.name = name, .build = build, .resident = resident};
+}
+
+/**
+ * @brief Queue a screen to be built on idle frames
+ */
+void skn_screen_preload(skn_screen_id_t id)
+{
+    if (screens[id].build == NULL || screens[id].complete) {
+        return;
+    }
+    screens[id].queued = true;
+    idle_wait_tick = lv_tick_get();
+    lv_timer_resume(build_timer);
+}
+
+/**
+ * @brief Make a screen active
+ *
+ * A preloaded screen only needs the load itself. A screen that is not built
+ * yet is finished on the spot, which is the hitch preloading avoids and is
+ * logged as such unless nothing managed is on screen yet, e.g. at boot. With CONFIG_SKN_SCREEN_ANIM_MS set the new screen fades in.
+ */
+void skn_screen_show(skn_screen_id_t id)
+{
+    skn_screen_t *s = &screens[id];
+    int64_t start_us = esp_timer_get_time();
+
+    lv_obj_t *active = lv_screen_active();
+    skn_screen_id_t from = skn_screen_find(active);
+
+    if (s->build == NULL) {
+        return;
+    }
+    if (!s->complete) {
+        if (from != SKN_SCREEN_COUNT) {
+            ESP_LOGW(SCREEN_TAG, "%s shown before it was preloaded, building now", s->name);
+        }
+        while (!s->complete) {
+            skn_screen_build_step(s);
+        }
+    }
+    if (active == s->obj) {
+        return;
+    }
+    bool auto_del = active != NULL && (from == SKN_SCREEN_COUNT || !screens[from].resident);
+
+    sw = (skn_screen_switch_t){.active = true, .from = from, .to = id, .start_us = start_us};
+    lv_screen_load_anim(s->obj, CONFIG_SKN_SCREEN_ANIM_MS > 0 ? LV_SCREEN_LOAD_ANIM_FADE_IN : LV_SCREEN_LOAD_ANIM_NONE,
+                        CONFIG_SKN_SCREEN_ANIM_MS, 0, auto_del);
+    sw.call_us = esp_timer_get_time() - start_us;
+}
+
+static void skn_screen_switch_cb(lv_event_t *e)
+{
+    skn_screen_show((skn_screen_id_t)(uintptr_t)lv_event_get_user_data(e));
+}
+
+/**
+ * @brief Add a button to a screen that switches to another screen
+ *
+ * @param screen Screen to put the button on, top right
+ * @param target Screen to show when the button is tapped
+ * @param text Button caption
+ * @return The button
+ */
+lv_obj_t *skn_screen_switch_add(lv_obj_t *screen, skn_screen_id_t target, const char *text)
+{
+    lv_obj_t *btn = lv_button_create(screen);
+    lv_obj_set_style_pad_all(btn, 6, 0);
+    lv_obj_align(btn, LV_ALIGN_TOP_RIGHT, -4, 4);
+    lv_obj_add_event_cb(btn, skn_screen_switch_cb, LV_EVENT_CLICKED, (void *)(uintptr_t)target);
+
+    lv_obj_t *label = lv_label_create(btn);
+    lv_label_set_text(label, text);
+    lv_obj_center(label);
+    return btn;
+}
@@ -0,0 +1,169 @@
+/*
+ * sensor_fusion.c
+ * Room-frame fusion of several RD-03D sensors.
+ *
+ * Each sensor's targets are rotated and shifted into the room frame with a
+ * Q14 rotation, then merged greedily: a target within CONFIG_SKN_FUSION_GATE_MM
+ * (|dx| + |dy|) of the nearest one already taken from another sensor is the
+ * same person seen by an overlapping sensor and is averaged into it, anything
+ * else becomes a new target. Two targets of one sensor are always two people,
+ * however close. The fused list never holds more than SKN_MAX_TARGETS, so both
+ * steps are linear in the number of reported targets.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "sensor_fusion.h"
+
+#define SKN_FUSION_Q14 14
+
+/**
+ * @brief Integer square root, for distances from the room origin
+ */
+static uint32_t skn_fusion_isqrt(uint32_t v)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1u << 30;
+
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+static uint16_t skn_fusion_distance(int16_t x_mm, int16_t y_mm)
+{
+    uint32_t d = skn_fusion_isqrt((uint32_t)x_mm * (uint32_t)x_mm + (uint32_t)y_mm * (uint32_t)y_mm);
+    return (uint16_t)(d > UINT16_MAX ? UINT16_MAX : d);
+}
+
+/**
+ * @brief Precompute a mounting pose
+ *
+ * @param x_mm Sensor position in the room
+ * @param y_mm Sensor position in the room
+ * @param yaw_deg Boresight rotation from the room's y axis, counter-clockwise
+ */
+void skn_fusion_pose_init(skn_sensor_pose_t *pose, int16_t x_mm, int16_t y_mm, int16_t yaw_deg)
+{
+    float yaw = yaw_deg * (float)M_PI / 180.0f;
+
+    pose->x_mm = x_mm;
+    pose->y_mm = y_mm;
+    pose->cos_q14 = (int16_t)lroundf(cosf(yaw) * (1 << SKN_FUSION_Q14));
+    pose->sin_q14 = (int16_t)lroundf(sinf(yaw) * (1 << SKN_FUSION_Q14));
+}
+
+/**
+ * @brief Move a sensor frame into the room frame in place
+ *
+ * Speed stays radial to the sensor that measured it.
+ */
+void skn_fusion_to_room(const skn_sensor_pose_t *pose, skn_target_frame_t *frame)
+{
+    const int32_t half = 1 << (SKN_FUSION_Q14 - 1);
+
+    for (uint8_t i = 0; i < frame->count; i++) {
+        skn_target_t *t = &frame->targets[i];
+        int32_t x = (((int32_t)t->x_mm * pose->cos_q14 - (int32_t)t->y_mm * pose->sin_q14 + half) >> SKN_FUSION_Q14);
+        int32_t y = (((int32_t)t->x_mm * pose->sin_q14 + (int32_t)t->y_mm * pose->cos_q14 + half) >> SKN_FUSION_Q14);
+
+        x += pose->x_mm;
+        y += pose->y_mm;
+        t->x_mm = (int16_t)(x < INT16_MIN ? INT16_MIN : (x > INT16_MAX ? INT16_MAX : x));
+        t->y_mm = (int16_t)(y < INT16_MIN ? INT16_MIN : (y > INT16_MAX ? INT16_MAX : y));
+        t->distance_mm = skn_fusion_distance(t->x_mm, t->y_mm);
+    }
+}
+
+/**
+ * @brief Fuse the latest room-frame frame of every sensor into one frame
+ *
+ * Frames older than CONFIG_SKN_FUSION_MAX_AGE_MS are ignored so a sensor that
+ * stopped reporting does not freeze its targets on screen. Earlier sensors
+ * win when more than SKN_MAX_TARGETS distinct targets are seen.
+ *
+ * @param frames Latest frame of each sensor, already in the room frame
+ * @param frame_count Number of sensors, at most 32
+ * @param now_us Current esp_timer time
+ * @param out Fused frame; seq is left to the caller
+ * @return Number of gate comparisons made, for cost accounting
+ */
+uint32_t skn_fusion_merge(const skn_target_frame_t *frames, uint8_t frame_count, int64_t now_us,
+                          skn_target_frame_t *out)
+{
+    int32_t sum_x[SKN_MAX_TARGETS], sum_y[SKN_MAX_TARGETS], sum_speed[SKN_MAX_TARGETS];
+    uint8_t seen[SKN_MAX_TARGETS];
+    uint32_t sources[SKN_MAX_TARGETS]; // Bit per sensor already averaged into the target
+    const int32_t gate = CONFIG_SKN_FUSION_GATE_MM;
+    uint32_t compares = 0;
+
+    out->count = 0;
+    out->timestamp_us = 0;
+
+    for (uint8_t s = 0; s < frame_count; s++) {
+        const skn_target_frame_t *frame = &frames[s];
+
+        if (frame->seq == 0 || now_us - frame->timestamp_us > CONFIG_SKN_FUSION_MAX_AGE_MS * 1000LL) {
+            continue;
+        }
+        out->timestamp_us = frame->timestamp_us > out->timestamp_us ? frame->timestamp_us : out->timestamp_us;
+
+        for (uint8_t i = 0; i < frame->count; i++) {
+            const skn_target_t *t = &frame->targets[i];
+            int32_t best_d = gate + 1;
+            uint8_t best = SKN_MAX_TARGETS;
+
+            for (uint8_t j = 0; j < out->count; j++) {
+                if (sources[j] & (1u << s)) {
+                    continue;
+                }
+                compares++;
+                int32_t d = abs(t->x_mm - out->targets[j].x_mm) + abs(t->y_mm - out->targets[j].y_mm);
+                if (d < best_d) {
+                    best_d = d;
+                    best = j;
+                }
+            }
+
+            if (best == SKN_MAX_TARGETS) {
+                if (out->count == SKN_MAX_TARGETS) {
+                    continue;
+                }
+                best = out->count++;
+                out->targets[best] = *t;
+                sum_x[best] = t->x_mm;
+                sum_y[best] = t->y_mm;
+                sum_speed[best] = t->speed_mms;
+                seen[best] = 1;
+                sources[best] = 1u << s;
+                continue;
+            }
+
+            // Same person from an overlapping sensor: average the sightings
+            skn_target_t *f = &out->targets[best];
+            sum_x[best] += t->x_mm;
+            sum_y[best] += t->y_mm;
+            sum_speed[best] += t->speed_mms;
+            seen[best]++;
+            sources[best] |= 1u << s;
+            f->x_mm = (int16_t)(sum_x[best] / seen[best]);
+            f->y_mm = (int16_t)(sum_y[best] / seen[best]);
+            f->speed_mms = (int16_t)(sum_speed[best] / seen[best]);
+            f->distance_mm = skn_fusion_distance(f->x_mm, f->y_mm);
+        }
+    }
+    if (out->timestamp_us == 0) {
+        out->timestamp_us = now_us;
+    }
+    return compares;
+}
@@ -0,0 +1,318 @@
+/*
+ * target_stream.c
+ * Publishes tracked targets as compact binary batches over UDP multicast or
+ * MQTT (QoS0).
+ *
+ * The sensor task hands frames to skn_stream_submit(), which only copies them
+ * into a ring under a spinlock and never touches the network. A publisher task
+ * drains the ring at CONFIG_SKN_STREAM_RATE_HZ, packs every pending frame into
+ * one datagram and sends it.
+ *
+ * Batch layout (little-endian):
+ *   u32 magic "SKNR", u8 version, u8 frame_count, u16 batch_seq,
+ *   u64 base_epoch_ms (wall clock of the first frame, 0 when unsynced)
+ *   per frame: u16 seq, u16 dt_ms from base, u8 count,
+ *              per target: i16 x_mm, i16 y_mm, i16 speed_mms
+ *
+ * Presence events go out in their own packet as soon as the publisher wakes:
+ *   u32 magic "SKNE", u8 version, u8 event_count, u16 reserved,
+ *   per event: u8 type, u8 zone, u8 slot, u16 distance_mm, u32 duration_ms
+ */
+
+#include "esp_log.h"
+#include "esp_netif_sntp.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lwip/sockets.h"
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include "target_stream.h"
+#include "telemetry.h"
+#if CONFIG_SKN_STREAM_TRANSPORT_MQTT
+#include "mqtt_client.h"
+#endif
+
+#define SKN_STREAM_STACK_SZ   5120
+#define SKN_STREAM_QUEUE_LEN  16
+#define SKN_STREAM_HEADER_SZ  16
+#define SKN_STREAM_FRAME_SZ   (5 + SKN_MAX_TARGETS * 6)
+#define SKN_STREAM_PACKET_SZ  (SKN_STREAM_HEADER_SZ + SKN_STREAM_QUEUE_LEN * SKN_STREAM_FRAME_SZ)
+#define SKN_STREAM_JSON_SZ    2048
+#define SKN_STREAM_EVENT_LEN  8
+#define SKN_STREAM_EVENT_PACKET_SZ (8 + SKN_STREAM_EVENT_LEN * 9)
+
+#if CONFIG_SKN_STREAM_FRAMES
+#define SKN_STREAM_SEND_FRAMES true
+#else
+#define SKN_STREAM_SEND_FRAMES false
+#endif
+
+static skn_target_frame_t pending[SKN_STREAM_QUEUE_LEN];
+static uint8_t pending_head = 0;
+static uint8_t pending_count = 0;
+static uint32_t pending_dropped = 0;
+static portMUX_TYPE pending_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static skn_presence_event_t pending_events[SKN_STREAM_EVENT_LEN];
+static uint8_t pending_event_count = 0;
+
+#if CONFIG_SKN_STREAM_ENABLE
+static const char *STREAM_TAG = "TargetStream";
+
+static skn_target_frame_t batch[SKN_STREAM_QUEUE_LEN];
+static skn_presence_event_t batch_events[SKN_STREAM_EVENT_LEN];
+static uint8_t event_packet[SKN_STREAM_EVENT_PACKET_SZ];
+static uint8_t packet[SKN_STREAM_PACKET_SZ];
+static char telemetry_json[SKN_STREAM_JSON_SZ];
+
+#if CONFIG_SKN_STREAM_TRANSPORT_MQTT
+static esp_mqtt_client_handle_t mqtt_client = NULL;
+#elif CONFIG_SKN_STREAM_TRANSPORT_UDP
+static int udp_socket = -1;
+static struct sockaddr_in udp_dest;
+#endif
+#endif // CONFIG_SKN_STREAM_ENABLE
+
+/**
+ * @brief Queue a sensor frame for publishing
+ *
+ * Safe to call from the sensor task: O(1), no blocking, no network access.
+ * When the publisher falls behind, the oldest pending frame is dropped.
+ */
+void skn_stream_submit(const skn_target_frame_t *frame)
+{
+    taskENTER_CRITICAL(&pending_lock);
+    uint8_t slot = (pending_head + pending_count) % SKN_STREAM_QUEUE_LEN;
+    if (pending_count == SKN_STREAM_QUEUE_LEN) {
+        pending_head = (pending_head + 1) % SKN_STREAM_QUEUE_LEN;
+        pending_dropped++;
+    } else {
+        pending_count++;
+    }
+    pending[slot] = *frame;
+    taskEXIT_CRITICAL(&pending_lock);
+}
+
+/**
+ * @brief Queue a presence event for publishing
+ *
+ * Same contract as skn_stream_submit(); events beyond the queue depth are dropped.
+ */
+void skn_stream_submit_event(const skn_presence_event_t *event)
+{
+    taskENTER_CRITICAL(&pending_lock);
+    if (pending_event_count < SKN_STREAM_EVENT_LEN) {
+        pending_events[pending_event_count++] = *event;
+    } else {
+        pending_dropped++;
+    }
+    taskEXIT_CRITICAL(&pending_lock);
+}
+
+#if CONFIG_SKN_STREAM_ENABLE
+static uint8_t skn_stream_drain_events(void)
+{
+    taskENTER_CRITICAL(&pending_lock);
+    uint8_t count = pending_event_count;
+    memcpy(batch_events, pending_events, count * sizeof(skn_presence_event_t));
+    pending_event_count = 0;
+    taskEXIT_CRITICAL(&pending_lock);
+    return count;
+}
+
+static uint8_t skn_stream_drain(void)
+{
+    taskENTER_CRITICAL(&pending_lock);
+    uint8_t count = pending_count;
+    for (uint8_t i = 0; i < count; i++) {
+        batch[i] = pending[(pending_head + i) % SKN_STREAM_QUEUE_LEN];
+    }
+    pending_head = 0;
+    pending_count = 0;
+    taskEXIT_CRITICAL(&pending_lock);
+    return count;
+}
+
+static uint8_t *put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+    return p + 2;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t v)
+{
+    p = put_u16(p, v & 0xFFFF);
+    return put_u16(p, v >> 16);
+}
+
+/**
+ * @brief Pack a batch of frames into the wire format
+ *
+ * @return Packet length in bytes
+ */
+static size_t skn_stream_encode(uint8_t *buf, const skn_target_frame_t *frames, uint8_t count, uint16_t batch_seq)
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+
+    // Map esp_timer capture times onto the wall clock; stays 0 until SNTP has synced
+    int64_t wall_us = (int64_t)now.tv_sec * 1000000 + now.tv_usec;
+    int64_t clock_offset_us = wall_us - esp_timer_get_time();
+    uint64_t base_epoch_ms = 0;
+    if (now.tv_sec > 1700000000) {
+        base_epoch_ms = (frames[0].timestamp_us + clock_offset_us) / 1000;
+    }
+
+    uint8_t *p = put_u32(buf, SKN_STREAM_MAGIC);
+    *p++ = SKN_STREAM_VERSION;
+    *p++ = count;
+    p = put_u16(p, batch_seq);
+    p = put_u32(p, base_epoch_ms & 0xFFFFFFFF);
+    p = put_u32(p, base_epoch_ms >> 32);
+
+    for (uint8_t i = 0; i < count; i++) {
+        const skn_target_frame_t *frame = &frames[i];
+        p = put_u16(p, frame->seq & 0xFFFF);
+        p = put_u16(p, (frame->timestamp_us - frames[0].timestamp_us) / 1000);
+        *p++ = frame->count;
+        for (uint8_t t = 0; t < frame->count; t++) {
+            p = put_u16(p, frame->targets[t].x_mm);
+            p = put_u16(p, frame->targets[t].y_mm);
+            p = put_u16(p, frame->targets[t].speed_mms);
+        }
+    }
+    return p - buf;
+}
+
+static size_t skn_stream_encode_events(uint8_t *buf, const skn_presence_event_t *events, uint8_t count)
+{
+    uint8_t *p = put_u32(buf, SKN_STREAM_EVENT_MAGIC);
+    *p++ = SKN_STREAM_VERSION;
+    *p++ = count;
+    p = put_u16(p, 0);
+
+    for (uint8_t i = 0; i < count; i++) {
+        *p++ = events[i].type;
+        *p++ = events[i].zone;
+        *p++ = events[i].slot;
+        p = put_u16(p, events[i].distance_mm);
+        p = put_u32(p, events[i].duration_ms);
+    }
+    return p - buf;
+}
+
+static void skn_stream_send(const void *data, size_t len, const char *subtopic)
+{
+#if CONFIG_SKN_STREAM_TRANSPORT_MQTT
+    char topic[96];
+    snprintf(topic, sizeof(topic), "%s%s", CONFIG_SKN_STREAM_MQTT_TOPIC, subtopic);
+    esp_mqtt_client_publish(mqtt_client, topic, data, len, 0, 0);
+#else
+    (void)subtopic;
+    if (sendto(udp_socket, data, len, MSG_DONTWAIT, (struct sockaddr *)&udp_dest, sizeof(udp_dest)) < 0) {
+        ESP_LOGD(STREAM_TAG, "sendto failed: errno %d", errno);
+    }
+#endif
+}
+
+static esp_err_t skn_stream_transport_init(void)
+{
+#if CONFIG_SKN_STREAM_TRANSPORT_MQTT
+    const esp_mqtt_client_config_t mqtt_cfg = {
+        .broker.address.uri = CONFIG_SKN_STREAM_MQTT_URI,
+    };
+    mqtt_client = esp_mqtt_client_init(&mqtt_cfg);
+    if (mqtt_client == NULL) {
+        return ESP_FAIL;
+    }
+    return esp_mqtt_client_start(mqtt_client);
+#else
+    udp_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    if (udp_socket < 0) {
+        ESP_LOGE(STREAM_TAG, "Unable to create socket: errno %d", errno);
+        return ESP_FAIL;
+    }
+    uint8_t ttl = CONFIG_SKN_STREAM_MULTICAST_TTL;
+    setsockopt(udp_socket, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+
+    memset(&udp_dest, 0, sizeof(udp_dest));
+    udp_dest.sin_family = AF_INET;
+    udp_dest.sin_port = htons(CONFIG_SKN_STREAM_PORT);
+    udp_dest.sin_addr.s_addr = inet_addr(CONFIG_SKN_STREAM_MULTICAST_ADDR);
+    return ESP_OK;
+#endif
+}
+
+static void skn_stream_task(void *pvParameters)
+{
+    TickType_t last_wake = xTaskGetTickCount();
+    TickType_t period = pdMS_TO_TICKS(1000 / CONFIG_SKN_STREAM_RATE_HZ);
+    int64_t next_telemetry_us = 0;
+    uint16_t batch_seq = 0;
+    bool last_had_targets = true;
+
+    while (1) {
+        vTaskDelayUntil(&last_wake, period);
+
+        uint8_t events = skn_stream_drain_events();
+        if (events > 0) {
+            size_t len = skn_stream_encode_events(event_packet, batch_events, events);
+            skn_stream_send(event_packet, len, "/events");
+        }
+
+        uint8_t count = skn_stream_drain();
+        bool has_targets = false;
+        for (uint8_t i = 0; i < count; i++) {
+            has_targets |= batch[i].count > 0;
+        }
+
+        // Coalesce an empty room: one empty batch announces the clear, then silence
+        if (SKN_STREAM_SEND_FRAMES && count > 0 && (has_targets || last_had_targets)) {
+            size_t len = skn_stream_encode(packet, batch, count, batch_seq++);
+            skn_stream_send(packet, len, "");
+            last_had_targets = has_targets;
+        }
+
+        if (CONFIG_SKN_STREAM_TELEMETRY_PERIOD_S > 0 && esp_timer_get_time() >= next_telemetry_us) {
+            next_telemetry_us = esp_timer_get_time() + CONFIG_SKN_STREAM_TELEMETRY_PERIOD_S * 1000000LL;
+            int len = skn_telemetry_to_json(telemetry_json, sizeof(telemetry_json));
+            if (len > 0) {
+                skn_stream_send(telemetry_json, len, "/telemetry");
+            }
+            taskENTER_CRITICAL(&pending_lock);
+            uint32_t dropped = pending_dropped;
+            pending_dropped = 0;
+            taskEXIT_CRITICAL(&pending_lock);
+            if (dropped) {
+                ESP_LOGW(STREAM_TAG, "%lu frames dropped, publisher behind", dropped);
+            }
+        }
+    }
+}
+
+#endif // CONFIG_SKN_STREAM_ENABLE
+
+esp_err_t skn_stream_start(void)
+{
+#if CONFIG_SKN_STREAM_ENABLE
+    esp_sntp_config_t sntp_cfg = ESP_NETIF_SNTP_DEFAULT_CONFIG(CONFIG_SKN_STREAM_SNTP_SERVER);
+    esp_netif_sntp_init(&sntp_cfg);
+
+    esp_err_t ret = skn_stream_transport_init();
+    if (ret != ESP_OK) {
+        ESP_LOGE(STREAM_TAG, "Transport init failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    if (xTaskCreatePinnedToCore(skn_stream_task, "SKN Stream", SKN_STREAM_STACK_SZ, NULL,
+                                CONFIG_SKN_STREAM_PRIORITY, NULL, CONFIG_SKN_IO_CORE) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(STREAM_TAG, "Publishing targets at %d Hz", CONFIG_SKN_STREAM_RATE_HZ);
+#endif
+    return ESP_OK;
+}
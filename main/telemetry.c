@@ -0,0 +1,348 @@
+/*
+ * telemetry.c
+ * Periodic, allocation-free runtime metrics: per-task CPU and stack high-water,
+ * heap levels and LVGL render rate.
+ *
+ * Task figures come from uxTaskGetSystemState() run-time counter deltas
+ * (FREERTOS_GENERATE_RUN_TIME_STATS) into static storage; render figures are
+ * fed by the display's render start/ready events. Readers copy the latest
+ * snapshot, they never trigger collection.
+ */
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/idf_additions.h"
+#include "freertos/task.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include "telemetry.h"
+
+#define SKN_TELEMETRY_PRIORITY 1
+#define SKN_TELEMETRY_STACK_SZ 3072
+
+static const char *TELEMETRY_TAG = "Telemetry";
+
+static TaskStatus_t task_status[SKN_TELEMETRY_MAX_TASKS];
+static TaskHandle_t prev_handle[SKN_TELEMETRY_MAX_TASKS];
+static uint32_t prev_runtime[SKN_TELEMETRY_MAX_TASKS];
+static uint16_t prev_count = 0;
+static uint32_t prev_total = 0;
+static bool tasks_overflowed = false; // Warned once about too many tasks
+
+static skn_telemetry_t collecting;
+static skn_telemetry_t published;
+static portMUX_TYPE telemetry_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Written by the LVGL and sensor tasks, read and reset by the collector; all
+// accesses hold counter_lock so no increment is lost between read and reset
+static portMUX_TYPE counter_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t render_frames = 0;
+static uint32_t render_us_total = 0;
+static uint32_t render_us_max = 0;
+static uint32_t render_hist[SKN_TELEMETRY_RENDER_BUCKETS];
+static uint32_t render_hist_period[SKN_TELEMETRY_RENDER_BUCKETS]; // Collector's copy
+static uint32_t flush_pixels = 0;
+static uint32_t ui_frames = 0;
+static uint32_t sensor_wakes = 0;
+static uint32_t sensor_late_total = 0;
+static uint32_t sensor_late_max = 0;
+static int64_t render_start_us = 0;
+
+void skn_telemetry_render_begin(void)
+{
+    render_start_us = esp_timer_get_time();
+}
+
+void skn_telemetry_render_end(void)
+{
+    uint32_t elapsed = (uint32_t)(esp_timer_get_time() - render_start_us);
+
+    uint32_t bucket = elapsed / SKN_TELEMETRY_RENDER_BUCKET_US;
+    taskENTER_CRITICAL(&counter_lock);
+    render_hist[bucket < SKN_TELEMETRY_RENDER_BUCKETS ? bucket : SKN_TELEMETRY_RENDER_BUCKETS - 1]++;
+    render_frames++;
+    render_us_total += elapsed;
+    if (elapsed > render_us_max) {
+        render_us_max = elapsed;
+    }
+    taskEXIT_CRITICAL(&counter_lock);
+}
+
+/**
+ * @brief Account for one flushed area; called from the display flush callback
+ */
+void skn_telemetry_flush(uint32_t pixels)
+{
+    taskENTER_CRITICAL(&counter_lock);
+    flush_pixels += pixels;
+    taskEXIT_CRITICAL(&counter_lock);
+}
+
+/**
+ * @brief Count a sensor frame that reached the screen
+ */
+void skn_telemetry_ui_frame(void)
+{
+    taskENTER_CRITICAL(&counter_lock);
+    ui_frames++;
+    taskEXIT_CRITICAL(&counter_lock);
+}
+
+/**
+ * @brief Record how late the sensor task woke up relative to its fixed schedule
+ */
+void skn_telemetry_sensor_wake(int64_t late_us)
+{
+    uint32_t late = late_us > 0 ? (uint32_t)late_us : 0;
+
+    taskENTER_CRITICAL(&counter_lock);
+    sensor_wakes++;
+    sensor_late_total += late;
+    if (late > sensor_late_max) {
+        sensor_late_max = late;
+    }
+    taskEXIT_CRITICAL(&counter_lock);
+}
+
+static uint32_t skn_telemetry_prev_runtime(TaskHandle_t handle, uint32_t fallback)
+{
+    for (uint16_t i = 0; i < prev_count; i++) {
+        if (prev_handle[i] == handle) {
+            return prev_runtime[i];
+        }
+    }
+    return fallback;
+}
+
+/**
+ * @brief Upper bucket edge below which pct percent of the frames rendered
+ */
+static uint32_t skn_telemetry_render_percentile(uint32_t frames, uint32_t pct)
+{
+    uint32_t rank = (frames * pct + 99) / 100;
+    uint32_t seen = 0;
+
+    for (int i = 0; i < SKN_TELEMETRY_RENDER_BUCKETS; i++) {
+        seen += render_hist_period[i];
+        if (seen >= rank) {
+            return (i + 1) * SKN_TELEMETRY_RENDER_BUCKET_US;
+        }
+    }
+    return SKN_TELEMETRY_RENDER_BUCKETS * SKN_TELEMETRY_RENDER_BUCKET_US;
+}
+
+static void skn_telemetry_collect(skn_telemetry_t *t, uint32_t period_ms)
+{
+    uint32_t total = prev_total;
+    UBaseType_t running = uxTaskGetNumberOfTasks();
+    UBaseType_t count = 0;
+
+    // uxTaskGetSystemState() fills nothing and returns 0 when the array is too small
+    if (running <= SKN_TELEMETRY_MAX_TASKS) {
+        count = uxTaskGetSystemState(task_status, SKN_TELEMETRY_MAX_TASKS, &total);
+    }
+    if (count == 0) {
+        if (!tasks_overflowed) {
+            ESP_LOGW(TELEMETRY_TAG, "%u tasks exceed %d task slots, task figures skipped", (unsigned)running,
+                     SKN_TELEMETRY_MAX_TASKS);
+        }
+        tasks_overflowed = true;
+    }
+    uint32_t delta_total = total - prev_total;
+
+    t->timestamp_us = esp_timer_get_time();
+    t->period_ms = period_ms;
+    t->task_count = count;
+    t->tasks_running = running;
+    t->idle_permille[0] = 0;
+    t->idle_permille[1] = 0;
+
+    for (UBaseType_t i = 0; i < count; i++) {
+        TaskStatus_t *status = &task_status[i];
+        skn_task_metrics_t *task = &t->tasks[i];
+        uint32_t delta = status->ulRunTimeCounter -
+                         skn_telemetry_prev_runtime(status->xHandle, status->ulRunTimeCounter);
+
+        strlcpy(task->name, status->pcTaskName, sizeof(task->name));
+        task->core = status->xCoreID == tskNO_AFFINITY ? 2 : status->xCoreID;
+        task->priority = status->uxCurrentPriority;
+        task->cpu_permille = delta_total ? (uint16_t)(((uint64_t)delta * 1000) / delta_total) : 0;
+        task->stack_free = status->usStackHighWaterMark;
+
+        for (int core = 0; core < 2; core++) {
+            if (status->xHandle == xTaskGetIdleTaskHandleForCore(core)) {
+                t->idle_permille[core] = task->cpu_permille;
+            }
+        }
+    }
+
+    // Keep the last full table so deltas resume once there are slots again
+    if (count > 0) {
+        for (UBaseType_t i = 0; i < count; i++) {
+            prev_handle[i] = task_status[i].xHandle;
+            prev_runtime[i] = task_status[i].ulRunTimeCounter;
+        }
+        prev_count = count;
+        prev_total = total;
+    }
+
+    t->heap_internal_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    t->heap_internal_min = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+    t->heap_psram_free = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    t->heap_psram_min = heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM);
+
+    taskENTER_CRITICAL(&counter_lock);
+    uint32_t frames = render_frames;
+    uint32_t frame_us = render_us_total;
+    uint32_t frame_max_us = render_us_max;
+    uint32_t pixels = flush_pixels;
+    uint32_t applied = ui_frames;
+    uint32_t wakes = sensor_wakes;
+    uint32_t late_us = sensor_late_total;
+    uint32_t late_max_us = sensor_late_max;
+    memcpy(render_hist_period, render_hist, sizeof(render_hist));
+    memset(render_hist, 0, sizeof(render_hist));
+    render_frames = 0;
+    render_us_total = 0;
+    render_us_max = 0;
+    flush_pixels = 0;
+    ui_frames = 0;
+    sensor_wakes = 0;
+    sensor_late_total = 0;
+    sensor_late_max = 0;
+    taskEXIT_CRITICAL(&counter_lock);
+
+    t->fps_x10 = period_ms ? (uint16_t)((frames * 10000) / period_ms) : 0;
+    t->render_avg_us = frames ? frame_us / frames : 0;
+    t->render_max_us = frame_max_us;
+    t->render_p50_us = frames ? skn_telemetry_render_percentile(frames, 50) : 0;
+    t->render_p95_us = frames ? skn_telemetry_render_percentile(frames, 95) : 0;
+    t->render_p99_us = frames ? skn_telemetry_render_percentile(frames, 99) : 0;
+    t->ui_frames_x10 = period_ms ? (uint16_t)((applied * 10000) / period_ms) : 0;
+    t->redraw_kpx = period_ms ? pixels / period_ms : 0;
+    t->sensor_wake_avg_us = wakes ? late_us / wakes : 0;
+    t->sensor_wake_max_us = late_max_us;
+}
+
+static void skn_telemetry_task(void *pvParameters)
+{
+    TickType_t last_wake = xTaskGetTickCount();
+    skn_telemetry_collect(&collecting, 0);
+
+    while (1) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(CONFIG_SKN_TELEMETRY_PERIOD_MS));
+        skn_telemetry_collect(&collecting, CONFIG_SKN_TELEMETRY_PERIOD_MS);
+
+        taskENTER_CRITICAL(&telemetry_lock);
+        collecting.seq = published.seq + 1;
+        memcpy(&published, &collecting, sizeof(published));
+        taskEXIT_CRITICAL(&telemetry_lock);
+    }
+}
+
+esp_err_t skn_telemetry_start(void)
+{
+    BaseType_t ret = xTaskCreatePinnedToCore(skn_telemetry_task, "SKN Telemetry", SKN_TELEMETRY_STACK_SZ,
+                                             NULL, SKN_TELEMETRY_PRIORITY, NULL, tskNO_AFFINITY);
+    return ret == pdPASS ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+/**
+ * @brief Copy the latest metrics snapshot
+ */
+void skn_telemetry_get(skn_telemetry_t *out)
+{
+    taskENTER_CRITICAL(&telemetry_lock);
+    memcpy(out, &published, sizeof(*out));
+    taskEXIT_CRITICAL(&telemetry_lock);
+}
+
+/**
+ * @brief Copy only the per-core idle share of the latest snapshot
+ *
+ * @return Snapshot sequence number, unchanged until the next collection
+ */
+uint32_t skn_telemetry_get_idle(uint16_t idle_permille[2])
+{
+    taskENTER_CRITICAL(&telemetry_lock);
+    uint32_t seq = published.seq;
+    idle_permille[0] = published.idle_permille[0];
+    idle_permille[1] = published.idle_permille[1];
+    taskEXIT_CRITICAL(&telemetry_lock);
+    return seq;
+}
+
+void skn_telemetry_log(void)
+{
+    static skn_telemetry_t snapshot;
+    skn_telemetry_get(&snapshot);
+
+    ESP_LOGI(TELEMETRY_TAG, "Snapshot #%" PRIu32 " over %" PRIu32 " ms, idle core0 %u.%u%%, core1 %u.%u%%",
+             snapshot.seq, snapshot.period_ms,
+             snapshot.idle_permille[0] / 10, snapshot.idle_permille[0] % 10,
+             snapshot.idle_permille[1] / 10, snapshot.idle_permille[1] % 10);
+    ESP_LOGI(TELEMETRY_TAG, "Heap internal %" PRIu32 " (min %" PRIu32 "), PSRAM %" PRIu32 " (min %" PRIu32 ")",
+             snapshot.heap_internal_free, snapshot.heap_internal_min,
+             snapshot.heap_psram_free, snapshot.heap_psram_min);
+    ESP_LOGI(TELEMETRY_TAG, "LVGL %u.%u fps, render avg %" PRIu32 " us, max %" PRIu32 " us, p50/p95/p99 %" PRIu32
+             "/%" PRIu32 "/%" PRIu32 " us", snapshot.fps_x10 / 10, snapshot.fps_x10 % 10, snapshot.render_avg_us,
+             snapshot.render_max_us, snapshot.render_p50_us, snapshot.render_p95_us, snapshot.render_p99_us);
+    ESP_LOGI(TELEMETRY_TAG, "UI %u.%u sensor frames/s, redraw %" PRIu32 " kpx/s",
+             snapshot.ui_frames_x10 / 10, snapshot.ui_frames_x10 % 10, snapshot.redraw_kpx);
+    ESP_LOGI(TELEMETRY_TAG, "Sensor wakeup late avg %" PRIu32 " us, max %" PRIu32 " us",
+             snapshot.sensor_wake_avg_us, snapshot.sensor_wake_max_us);
+    if (snapshot.task_count == 0) {
+        ESP_LOGW(TELEMETRY_TAG, "Task table skipped: %u tasks running, %d slots", snapshot.tasks_running,
+                 SKN_TELEMETRY_MAX_TASKS);
+    }
+    ESP_LOGI(TELEMETRY_TAG, "%-24s core prio   cpu%%  stack free", "task");
+    for (uint16_t i = 0; i < snapshot.task_count; i++) {
+        skn_task_metrics_t *task = &snapshot.tasks[i];
+        ESP_LOGI(TELEMETRY_TAG, "%-24s %4u %4u %3u.%u %11" PRIu32, task->name, task->core, task->priority,
+                 task->cpu_permille / 10, task->cpu_permille % 10, task->stack_free);
+    }
+}
+
+/**
+ * @brief Render the latest snapshot as compact JSON for network consumers
+ *
+ * The snapshot is copied onto the caller's stack (about 1.2 KB) so several
+ * network tasks may call this concurrently.
+ *
+ * @return Number of characters written, or -1 when buf is too small
+ */
+int skn_telemetry_to_json(char *buf, size_t len)
+{
+    skn_telemetry_t snapshot;
+    skn_telemetry_get(&snapshot);
+
+    int n = snprintf(buf, len,
+                     "{\"seq\":%" PRIu32 ",\"period_ms\":%" PRIu32 ",\"idle\":[%u,%u],"
+                     "\"heap\":{\"internal\":%" PRIu32 ",\"internal_min\":%" PRIu32 ",\"psram\":%" PRIu32 ",\"psram_min\":%" PRIu32 "},"
+                     "\"lvgl\":{\"fps_x10\":%u,\"render_avg_us\":%" PRIu32 ",\"render_max_us\":%" PRIu32 ","
+                     "\"render_p50_us\":%" PRIu32 ",\"render_p95_us\":%" PRIu32 ",\"render_p99_us\":%" PRIu32 ","
+                     "\"ui_frames_x10\":%u,\"redraw_kpx\":%" PRIu32 "},"
+                     "\"sensor\":{\"wake_avg_us\":%" PRIu32 ",\"wake_max_us\":%" PRIu32 "},"
+                     "\"tasks_running\":%u,\"tasks\":[",
+                     snapshot.seq, snapshot.period_ms, snapshot.idle_permille[0], snapshot.idle_permille[1],
+                     snapshot.heap_internal_free, snapshot.heap_internal_min,
+                     snapshot.heap_psram_free, snapshot.heap_psram_min,
+                     snapshot.fps_x10, snapshot.render_avg_us, snapshot.render_max_us,
+                     snapshot.render_p50_us, snapshot.render_p95_us, snapshot.render_p99_us,
+                     snapshot.ui_frames_x10, snapshot.redraw_kpx,
+                     snapshot.sensor_wake_avg_us, snapshot.sensor_wake_max_us, snapshot.tasks_running);
+
+    for (uint16_t i = 0; i < snapshot.task_count && n > 0 && (size_t)n < len; i++) {
+        skn_task_metrics_t *task = &snapshot.tasks[i];
+        n += snprintf(buf + n, len - n, "%s{\"name\":\"%s\",\"core\":%u,\"prio\":%u,\"cpu\":%u,\"stack\":%" PRIu32 "}",
+                      i ? "," : "", task->name, task->core, task->priority, task->cpu_permille, task->stack_free);
+    }
+    if (n > 0 && (size_t)n < len) {
+        n += snprintf(buf + n, len - n, "]}");
+    }
+
+    return (n > 0 && (size_t)n < len) ? n : -1;
+}
@@ -0,0 +1,442 @@
+/*
+ * web_server.c
+ * Serves the live radar page from SPIFFS and pushes target updates over a
+ * WebSocket.
+ *
+ * Each sensor frame is delta-encoded once against the state last sent to
+ * clients and the same buffer is fanned out to every connected socket from
+ * the httpd task. Only targets that appeared, vanished or moved more than
+ * CONFIG_SKN_WEB_DELTA_MM are sent. Newly connected clients receive one
+ * keyframe (a delta against an empty room) before joining the shared stream.
+ *
+ * GET /sensor shows the RD-03D configuration. POST /sensor changes it and
+ * saves it to NVS for the next boot; it needs CONFIG_SKN_WEB_TOKEN in an
+ * X-SKN-Token header, which a cross-site page cannot send.
+ *
+ * Delta message (little-endian):
+ *   u8 'D', u16 seq, u8 change_count,
+ *   per change: u8 slot (bit7 = present), present: i16 x_mm, i16 y_mm, i16 speed_mms
+ */
+
+#include "esp_http_server.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "rd03d_config.h"
+#include "telemetry.h"
+#include "web_server.h"
+
+#define SKN_WEB_MSG_DELTA 'D'
+#define SKN_WEB_MSG_SZ    (4 + SKN_MAX_TARGETS * 7)
+#define SKN_WEB_CHUNK_SZ  1024
+#define SKN_WEB_JSON_SZ   2048
+#define SKN_WEB_QUERY_SZ  96
+#define SKN_WEB_TOKEN_SZ  64
+
+static const char *WEB_TAG = "WebServer";
+
+typedef struct
+{
+    int fd;
+    bool needs_keyframe;
+} skn_web_client_t;
+
+static httpd_handle_t server = NULL;
+
+// Changed by the httpd task only, client_count is also read by the sensor task
+static skn_web_client_t clients[CONFIG_SKN_WEB_MAX_CLIENTS];
+static uint8_t client_count = 0;
+static portMUX_TYPE clients_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Latest frame handed over by the sensor task
+static skn_target_frame_t latest;
+static volatile bool broadcast_queued = false;
+static portMUX_TYPE latest_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Owned by the httpd task
+static skn_target_frame_t sent_state;
+static uint8_t delta_msg[SKN_WEB_MSG_SZ];
+static uint8_t keyframe_msg[SKN_WEB_MSG_SZ];
+#if CONFIG_SKN_WEB_ENABLE
+static char chunk[SKN_WEB_CHUNK_SZ];
+static char metrics_json[SKN_WEB_JSON_SZ];
+#endif
+
+static bool skn_web_target_changed(const skn_target_frame_t *prev, const skn_target_frame_t *cur, uint8_t slot)
+{
+    bool was = slot < prev->count;
+    bool is = slot < cur->count;
+    if (was != is) {
+        return true;
+    }
+    if (!is) {
+        return false;
+    }
+    const skn_target_t *a = &prev->targets[slot];
+    const skn_target_t *b = &cur->targets[slot];
+    return abs(a->x_mm - b->x_mm) > CONFIG_SKN_WEB_DELTA_MM || abs(a->y_mm - b->y_mm) > CONFIG_SKN_WEB_DELTA_MM;
+}
+
+/**
+ * @brief Encode the changes between two frames
+ *
+ * @return Message length, or 0 when nothing changed
+ */
+static size_t skn_web_encode_delta(uint8_t *buf, const skn_target_frame_t *prev, const skn_target_frame_t *cur)
+{
+    uint8_t *p = buf + 4;
+    uint8_t changes = 0;
+
+    for (uint8_t slot = 0; slot < SKN_MAX_TARGETS; slot++) {
+        if (!skn_web_target_changed(prev, cur, slot)) {
+            continue;
+        }
+        changes++;
+        if (slot >= cur->count) {
+            *p++ = slot;
+            continue;
+        }
+        const skn_target_t *t = &cur->targets[slot];
+        *p++ = slot | 0x80;
+        memcpy(p, &t->x_mm, 2);
+        memcpy(p + 2, &t->y_mm, 2);
+        memcpy(p + 4, &t->speed_mms, 2);
+        p += 6;
+    }
+    if (changes == 0) {
+        return 0;
+    }
+
+    buf[0] = SKN_WEB_MSG_DELTA;
+    buf[1] = cur->seq & 0xFF;
+    buf[2] = (cur->seq >> 8) & 0xFF;
+    buf[3] = changes;
+    return p - buf;
+}
+
+static void skn_web_remove_client(uint8_t index)
+{
+    taskENTER_CRITICAL(&clients_lock);
+    clients[index] = clients[--client_count];
+    taskEXIT_CRITICAL(&clients_lock);
+}
+
+static void skn_web_send(skn_web_client_t *client, uint8_t index, const uint8_t *msg, size_t len)
+{
+    httpd_ws_frame_t frame = {
+        .type = HTTPD_WS_TYPE_BINARY,
+        .payload = (uint8_t *)msg,
+        .len = len,
+    };
+    if (httpd_ws_get_fd_info(server, client->fd) != HTTPD_WS_CLIENT_WEBSOCKET ||
+        httpd_ws_send_frame_async(server, client->fd, &frame) != ESP_OK) {
+        ESP_LOGI(WEB_TAG, "WebSocket client fd %d gone", client->fd);
+        skn_web_remove_client(index);
+    }
+}
+
+/**
+ * @brief Fan the latest frame out to every client; runs in the httpd task
+ */
+static void skn_web_broadcast_work(void *arg)
+{
+    static const skn_target_frame_t empty = {0};
+    skn_target_frame_t cur;
+
+    taskENTER_CRITICAL(&latest_lock);
+    cur = latest;
+    broadcast_queued = false;
+    taskEXIT_CRITICAL(&latest_lock);
+
+    size_t delta_len = skn_web_encode_delta(delta_msg, &sent_state, &cur);
+    size_t keyframe_len = 0;
+    bool keyframe_encoded = false;
+
+    for (int i = client_count - 1; i >= 0; i--) {
+        skn_web_client_t *client = &clients[i];
+        if (client->needs_keyframe) {
+            if (!keyframe_encoded) {
+                keyframe_len = skn_web_encode_delta(keyframe_msg, &empty, &cur);
+                keyframe_encoded = true;
+            }
+            client->needs_keyframe = false;
+            if (keyframe_len) {
+                skn_web_send(client, i, keyframe_msg, keyframe_len);
+            }
+        } else if (delta_len) {
+            skn_web_send(client, i, delta_msg, delta_len);
+        }
+    }
+
+    // Unchanged slots keep their last sent position so small drifts accumulate
+    for (uint8_t slot = 0; slot < SKN_MAX_TARGETS; slot++) {
+        if (skn_web_target_changed(&sent_state, &cur, slot) && slot < cur.count) {
+            sent_state.targets[slot] = cur.targets[slot];
+        }
+    }
+    sent_state.count = cur.count;
+    sent_state.seq = cur.seq;
+}
+
+/**
+ * @brief Hand a sensor frame to the WebSocket fan-out
+ *
+ * Non-blocking: copies the frame and queues at most one broadcast on the
+ * httpd task; frames arriving before it runs replace the pending one.
+ */
+void skn_web_submit(const skn_target_frame_t *frame)
+{
+    bool queue = false;
+
+    taskENTER_CRITICAL(&clients_lock);
+    uint8_t listeners = client_count;
+    taskEXIT_CRITICAL(&clients_lock);
+    if (server == NULL || listeners == 0) {
+        return;
+    }
+
+    taskENTER_CRITICAL(&latest_lock);
+    latest = *frame;
+    if (!broadcast_queued) {
+        broadcast_queued = queue = true;
+    }
+    taskEXIT_CRITICAL(&latest_lock);
+
+    if (queue && httpd_queue_work(server, skn_web_broadcast_work, NULL) != ESP_OK) {
+        broadcast_queued = false;
+    }
+}
+
+#if CONFIG_SKN_WEB_ENABLE
+static esp_err_t skn_web_ws_handler(httpd_req_t *req)
+{
+    if (req->method == HTTP_GET) {
+        int fd = httpd_req_to_sockfd(req);
+        if (client_count >= CONFIG_SKN_WEB_MAX_CLIENTS) {
+            // Failing the handler makes httpd close the session
+            ESP_LOGW(WEB_TAG, "WebSocket client limit reached, fd %d rejected", fd);
+            return ESP_FAIL;
+        }
+        taskENTER_CRITICAL(&clients_lock);
+        clients[client_count].fd = fd;
+        clients[client_count].needs_keyframe = true;
+        client_count++;
+        taskEXIT_CRITICAL(&clients_lock);
+        ESP_LOGI(WEB_TAG, "WebSocket client fd %d connected (%u total)", fd, client_count);
+        return ESP_OK;
+    }
+
+    // Clients only listen; drain whatever they send
+    httpd_ws_frame_t frame = {0};
+    esp_err_t ret = httpd_ws_recv_frame(req, &frame, 0);
+    if (ret == ESP_OK && frame.len > 0 && frame.len < sizeof(chunk)) {
+        frame.payload = (uint8_t *)chunk;
+        ret = httpd_ws_recv_frame(req, &frame, frame.len);
+    }
+    return ret;
+}
+
+/**
+ * @brief Session close hook: forget the socket before httpd reuses its fd
+ *
+ * Installing close_fn makes us responsible for closing the socket.
+ */
+static void skn_web_close_fn(httpd_handle_t hd, int sockfd)
+{
+    for (uint8_t i = 0; i < client_count; i++) {
+        if (clients[i].fd == sockfd) {
+            ESP_LOGI(WEB_TAG, "WebSocket client fd %d disconnected", sockfd);
+            skn_web_remove_client(i);
+            break;
+        }
+    }
+    close(sockfd);
+}
+
+static esp_err_t skn_web_index_handler(httpd_req_t *req)
+{
+    FILE *fp = fopen("/spiffs/index.html", "r");
+    if (fp == NULL) {
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "index.html missing from storage");
+        return ESP_FAIL;
+    }
+
+    httpd_resp_set_type(req, "text/html");
+    size_t len;
+    while ((len = fread(chunk, 1, sizeof(chunk), fp)) > 0) {
+        if (httpd_resp_send_chunk(req, chunk, len) != ESP_OK) {
+            fclose(fp);
+            return ESP_FAIL;
+        }
+    }
+    fclose(fp);
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+static esp_err_t skn_web_metrics_handler(httpd_req_t *req)
+{
+    int len = skn_telemetry_to_json(metrics_json, sizeof(metrics_json));
+    if (len < 0) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "metrics too large");
+        return ESP_FAIL;
+    }
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_send(req, metrics_json, len);
+}
+
+/**
+ * @brief Read an integer from a query string or form body, clamped to min..max
+ */
+static bool skn_web_query_int(const char *query, const char *key, int min, int max, int *value)
+{
+    char text[8];
+
+    if (httpd_query_key_value(query, key, text, sizeof(text)) != ESP_OK) {
+        return false;
+    }
+    *value = atoi(text);
+    *value = *value < min ? min : (*value > max ? max : *value);
+    return true;
+}
+
+static esp_err_t skn_web_sensor_reply(httpd_req_t *req, const skn_rd03d_config_t *config, bool saved)
+{
+    int len = snprintf(chunk, sizeof(chunk),
+                       "{\"multi_target\":%s,\"min_mm\":%u,\"max_mm\":%u,\"half_angle_deg\":%u,\"saved\":%s}",
+                       config->multi_target ? "true" : "false", config->min_mm, config->max_mm,
+                       config->half_angle_deg, saved ? "true" : "false");
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_send(req, chunk, len);
+}
+
+/**
+ * @brief Show the sensor configuration; never changes it
+ */
+static esp_err_t skn_web_sensor_get_handler(httpd_req_t *req)
+{
+    skn_rd03d_config_t config;
+
+    skn_rd03d_load_config(&config);
+    return skn_web_sensor_reply(req, &config, false);
+}
+
+/**
+ * @brief Whether the request carries the configured token
+ *
+ * An empty CONFIG_SKN_WEB_TOKEN disables all changes. The comparison takes
+ * the same time wherever the first mismatch is.
+ */
+static bool skn_web_authorized(httpd_req_t *req)
+{
+    static const char expected[] = CONFIG_SKN_WEB_TOKEN;
+    char token[SKN_WEB_TOKEN_SZ];
+    size_t len = httpd_req_get_hdr_value_len(req, "X-SKN-Token");
+    uint8_t diff = 0;
+
+    if (sizeof(expected) == 1 || len != sizeof(expected) - 1 ||
+        httpd_req_get_hdr_value_str(req, "X-SKN-Token", token, sizeof(token)) != ESP_OK) {
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        diff |= token[i] ^ expected[i];
+    }
+    return diff == 0;
+}
+
+/**
+ * @brief Change and save the sensor configuration
+ *
+ * Form-encoded body, e.g. multi=1&min_mm=300&max_mm=6000&half_angle=45;
+ * omitted keys keep their value. The module picks the saved settings up at
+ * the next boot.
+ */
+static esp_err_t skn_web_sensor_post_handler(httpd_req_t *req)
+{
+    skn_rd03d_config_t config;
+    char body[SKN_WEB_QUERY_SZ];
+    size_t have = 0;
+    int value;
+
+    if (!skn_web_authorized(req)) {
+        ESP_LOGW(WEB_TAG, "Sensor configuration change refused, bad or missing token");
+        httpd_resp_send_err(req, HTTPD_403_FORBIDDEN, "X-SKN-Token required");
+        return ESP_FAIL;
+    }
+    if (req->content_len >= sizeof(body)) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "body too long");
+        return ESP_FAIL;
+    }
+    while (have < req->content_len) {
+        int got = httpd_req_recv(req, body + have, req->content_len - have);
+        if (got <= 0) {
+            return ESP_FAIL;
+        }
+        have += got;
+    }
+    body[have] = '\0';
+
+    skn_rd03d_load_config(&config);
+    if (skn_web_query_int(body, "multi", 0, 1, &value)) {
+        config.multi_target = value != 0;
+    }
+    if (skn_web_query_int(body, "min_mm", 0, 8000, &value)) {
+        config.min_mm = value;
+    }
+    if (skn_web_query_int(body, "max_mm", 100, 8000, &value)) {
+        config.max_mm = value;
+    }
+    if (skn_web_query_int(body, "half_angle", 5, 90, &value)) {
+        config.half_angle_deg = value;
+    }
+    if (config.min_mm >= config.max_mm) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "min_mm must be below max_mm");
+        return ESP_FAIL;
+    }
+
+    esp_err_t ret = skn_rd03d_save_config(&config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(WEB_TAG, "Saving sensor configuration failed: %s", esp_err_to_name(ret));
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "saving to NVS failed");
+        return ESP_FAIL;
+    }
+    ESP_LOGI(WEB_TAG, "Sensor configuration saved, applied at next boot");
+    return skn_web_sensor_reply(req, &config, true);
+}
+
+#endif // CONFIG_SKN_WEB_ENABLE
+
+esp_err_t skn_web_start(void)
+{
+#if CONFIG_SKN_WEB_ENABLE
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.lru_purge_enable = true;
+    config.stack_size = 6144;
+    config.task_priority = CONFIG_SKN_WEB_PRIORITY;
+    config.core_id = CONFIG_SKN_IO_CORE;
+    config.close_fn = skn_web_close_fn;
+
+    esp_err_t ret = httpd_start(&server, &config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(WEB_TAG, "httpd_start failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    const httpd_uri_t index_uri = {.uri = "/", .method = HTTP_GET, .handler = skn_web_index_handler};
+    const httpd_uri_t metrics_uri = {.uri = "/metrics", .method = HTTP_GET, .handler = skn_web_metrics_handler};
+    const httpd_uri_t sensor_uri = {.uri = "/sensor", .method = HTTP_GET, .handler = skn_web_sensor_get_handler};
+    const httpd_uri_t sensor_post_uri = {.uri = "/sensor", .method = HTTP_POST,
+                                         .handler = skn_web_sensor_post_handler};
+    const httpd_uri_t ws_uri = {.uri = "/ws", .method = HTTP_GET, .handler = skn_web_ws_handler, .is_websocket = true};
+    httpd_register_uri_handler(server, &index_uri);
+    httpd_register_uri_handler(server, &metrics_uri);
+    httpd_register_uri_handler(server, &sensor_uri);
+    httpd_register_uri_handler(server, &sensor_post_uri);
+    httpd_register_uri_handler(server, &ws_uri);
+
+    ESP_LOGI(WEB_TAG, "Live radar served on port %d", config.server_port);
+#endif
+    return ESP_OK;
+}
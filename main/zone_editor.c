@@ -0,0 +1,293 @@
+/*
+ * zone_editor.c
+ * Touch editor for detection zones on the radar screen.
+ *
+ * A long press on the radar enters edit mode: the selected zone shows a
+ * draggable handle per vertex and a toolbar to pick a zone, add or clear it,
+ * add a vertex, change sensitivity and the whole-field range, and save to NVS.
+ * A second long press leaves edit mode.
+ *
+ * While dragging only the handle and that zone's outline move, so LVGL
+ * invalidates two small areas per touch sample and the sweep keeps its frame
+ * rate. The membership grid is rebuilt once, when the handle is released.
+ *
+ * There is one zone table, so there is one editor: it attaches to a single
+ * radar at a time and refuses a second one until that radar is deleted.
+ */
+
+#include "esp_log.h"
+#include "lvgl.h"
+#include <stdio.h>
+#include <string.h>
+#include "presence.h"
+#include "radar_panel.h"
+#include "telemetry.h"
+#include "zone_editor.h"
+
+#define SKN_EDIT_HANDLE_SZ   18
+#define SKN_EDIT_RANGE_STEP  500
+#define SKN_EDIT_RANGE_MIN   1000
+#define SKN_EDIT_RANGE_MAX   8000
+
+static const char *EDITOR_TAG = "ZoneEditor";
+
+static lv_obj_t *radar_obj = NULL;
+static lv_obj_t *toolbar = NULL;
+static lv_obj_t *handles[SKN_ZONE_MAX_VERTICES];
+static lv_obj_t *zone_label, *sens_label, *range_label, *shape_label;
+
+static bool editing = false;
+static uint8_t selected = 0;
+static skn_zone_t work; // Copy of the selected zone being edited
+
+static void skn_editor_refresh(void)
+{
+    lv_point_t p;
+
+    for (uint8_t i = 0; i < SKN_ZONE_MAX_VERTICES; i++) {
+        if (i < work.vertex_count) {
+            lv_radar_mm_to_point(radar_obj, work.vertices[i].x_mm, work.vertices[i].y_mm, &p);
+            lv_obj_set_pos(handles[i], p.x - SKN_EDIT_HANDLE_SZ / 2, p.y - SKN_EDIT_HANDLE_SZ / 2);
+            lv_obj_remove_flag(handles[i], LV_OBJ_FLAG_HIDDEN);
+        } else {
+            lv_obj_add_flag(handles[i], LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+
+    lv_label_set_text_fmt(zone_label, "Z%u", selected + 1);
+    lv_label_set_text(shape_label, work.vertex_count >= 3 ? "Clear" : "New");
+    lv_label_set_text_fmt(sens_label, "S%u", work.sensitivity);
+    lv_label_set_text_fmt(range_label, "%u.%um", skn_presence_get_range_mm() / 1000,
+                          (skn_presence_get_range_mm() % 1000) / 100);
+}
+
+static void skn_editor_select(uint8_t index)
+{
+    selected = index;
+    skn_zones_get(selected, &work);
+    if (work.sensitivity == 0) {
+        work.sensitivity = 5;
+    }
+    skn_editor_refresh();
+}
+
+static void skn_editor_commit(void)
+{
+    if (skn_zones_set(selected, &work) != ESP_OK) {
+        ESP_LOGW(EDITOR_TAG, "Zone %u rejected", selected);
+    }
+    lv_radar_zone_overlay_set(radar_obj, selected, &work);
+}
+
+static void skn_editor_handle_cb(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    uint8_t index = (uint8_t)(uintptr_t)lv_event_get_user_data(e);
+    lv_area_t coords;
+    lv_point_t p;
+
+    if (code == LV_EVENT_RELEASED) {
+        skn_editor_commit();
+        return;
+    }
+
+    lv_indev_get_point(lv_indev_active(), &p);
+    lv_obj_get_coords(radar_obj, &coords);
+    p.x -= coords.x1;
+    p.y -= coords.y1;
+
+    // Round-trip through millimetres so the handle snaps to the clamped position
+    lv_radar_point_to_mm(radar_obj, &p, &work.vertices[index].x_mm, &work.vertices[index].y_mm);
+    lv_radar_mm_to_point(radar_obj, work.vertices[index].x_mm, work.vertices[index].y_mm, &p);
+    lv_obj_set_pos(handles[index], p.x - SKN_EDIT_HANDLE_SZ / 2, p.y - SKN_EDIT_HANDLE_SZ / 2);
+    lv_radar_zone_overlay_set(radar_obj, selected, &work);
+}
+
+static void skn_editor_geometry_cb(lv_event_t *e)
+{
+    if (editing) {
+        skn_editor_refresh();
+        lv_radar_zone_overlay_set(radar_obj, selected, &work);
+    }
+}
+
+static void skn_editor_zone_cb(lv_event_t *e)
+{
+    skn_editor_select((selected + 1) % SKN_ZONE_MAX_ZONES);
+}
+
+static void skn_editor_shape_cb(lv_event_t *e)
+{
+    static const skn_zone_point_t square[] = {{-500, 1500}, {500, 1500}, {500, 2500}, {-500, 2500}};
+
+    if (work.vertex_count >= 3) {
+        work.vertex_count = 0;
+    } else {
+        memcpy(work.vertices, square, sizeof(square));
+        work.vertex_count = sizeof(square) / sizeof(square[0]);
+        snprintf(work.name, sizeof(work.name), "Zone %u", selected + 1);
+    }
+    skn_editor_commit();
+    skn_editor_refresh();
+}
+
+static void skn_editor_vertex_cb(lv_event_t *e)
+{
+    if (work.vertex_count < 3 || work.vertex_count >= SKN_ZONE_MAX_VERTICES) {
+        return;
+    }
+    // New vertex halfway along the closing edge
+    const skn_zone_point_t *a = &work.vertices[work.vertex_count - 1];
+    const skn_zone_point_t *b = &work.vertices[0];
+    work.vertices[work.vertex_count].x_mm = (a->x_mm + b->x_mm) / 2;
+    work.vertices[work.vertex_count].y_mm = (a->y_mm + b->y_mm) / 2;
+    work.vertex_count++;
+    skn_editor_commit();
+    skn_editor_refresh();
+}
+
+static void skn_editor_sens_cb(lv_event_t *e)
+{
+    int step = (int)(intptr_t)lv_event_get_user_data(e);
+    int sensitivity = work.sensitivity + step;
+
+    work.sensitivity = sensitivity < 1 ? 1 : (sensitivity > 10 ? 10 : sensitivity);
+    skn_editor_commit();
+    skn_editor_refresh();
+}
+
+static void skn_editor_range_cb(lv_event_t *e)
+{
+    int step = (int)(intptr_t)lv_event_get_user_data(e);
+    int range_mm = skn_presence_get_range_mm() + step;
+
+    range_mm = range_mm < SKN_EDIT_RANGE_MIN ? SKN_EDIT_RANGE_MIN : (range_mm > SKN_EDIT_RANGE_MAX ? SKN_EDIT_RANGE_MAX : range_mm);
+    skn_presence_set_range_mm(range_mm);
+    skn_editor_refresh();
+}
+
+static void skn_editor_save_cb(lv_event_t *e)
+{
+    skn_editor_commit();
+    esp_err_t ret = skn_zones_save(selected);
+    if (ret == ESP_OK) {
+        ret = skn_zones_save_range();
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(EDITOR_TAG, "Saving zone %u failed: %s", selected, esp_err_to_name(ret));
+    }
+}
+
+static void skn_editor_toggle_cb(lv_event_t *e)
+{
+    static skn_telemetry_t stats; // ~1.2 KB, kept off the LVGL task stack and heap
+
+    editing = !editing;
+    if (editing) {
+        lv_obj_remove_flag(toolbar, LV_OBJ_FLAG_HIDDEN);
+        skn_editor_select(selected);
+        return;
+    }
+
+    lv_obj_add_flag(toolbar, LV_OBJ_FLAG_HIDDEN);
+    for (uint8_t i = 0; i < SKN_ZONE_MAX_VERTICES; i++) {
+        lv_obj_add_flag(handles[i], LV_OBJ_FLAG_HIDDEN);
+    }
+
+    skn_telemetry_get(&stats);
+    ESP_LOGI(EDITOR_TAG, "Edit done: %u.%u fps, render avg %lu us, max %lu us", stats.fps_x10 / 10,
+             stats.fps_x10 % 10, stats.render_avg_us, stats.render_max_us);
+}
+
+static lv_obj_t *skn_editor_button(lv_obj_t *parent, const char *text, lv_event_cb_t cb, intptr_t user_data)
+{
+    lv_obj_t *btn = lv_button_create(parent);
+    lv_obj_set_style_pad_all(btn, 6, 0);
+    lv_obj_add_event_cb(btn, cb, LV_EVENT_CLICKED, (void *)user_data);
+
+    lv_obj_t *label = lv_label_create(btn);
+    lv_label_set_text(label, text);
+    lv_obj_center(label);
+    return label;
+}
+
+/**
+ * @brief Release the editor when its radar is deleted
+ *
+ * The handles and toolbar are children of the radar and go with it; only the
+ * module state is reset so another radar can attach.
+ */
+static void skn_editor_delete_cb(lv_event_t *e)
+{
+    radar_obj = NULL;
+    toolbar = NULL;
+    editing = false;
+}
+
+/**
+ * @brief Attach the zone editor to a radar
+ *
+ * All editor objects are created hidden up front; edit mode only toggles them.
+ *
+ * @param radar The radar returned by lv_radar_screen_create()
+ * @return false when the editor already belongs to another radar
+ */
+bool lv_radar_zone_editor_create(lv_obj_t *radar)
+{
+    if (radar_obj != NULL) {
+        ESP_LOGE(EDITOR_TAG, "Zone editor already attached to another radar");
+        return false;
+    }
+
+    radar_obj = radar;
+    editing = false;
+    lv_obj_add_event_cb(radar, skn_editor_delete_cb, LV_EVENT_DELETE, NULL);
+    lv_obj_add_event_cb(radar, skn_editor_toggle_cb, LV_EVENT_LONG_PRESSED, NULL);
+    lv_obj_add_event_cb(radar, skn_editor_geometry_cb, lv_radar_geometry_event(), NULL);
+
+    for (uint8_t i = 0; i < SKN_ZONE_MAX_VERTICES; i++) {
+        lv_obj_t *handle = lv_obj_create(radar);
+        lv_obj_set_size(handle, SKN_EDIT_HANDLE_SZ, SKN_EDIT_HANDLE_SZ);
+        lv_obj_set_style_radius(handle, LV_RADIUS_CIRCLE, 0);
+        lv_obj_set_style_bg_color(handle, lv_color_white(), 0);
+        lv_obj_set_style_border_color(handle, lv_color_hex(0xFF8000), 0);
+        lv_obj_set_style_border_width(handle, 2, 0);
+        lv_obj_remove_flag(handle, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_set_ext_click_area(handle, 12);
+        lv_obj_add_flag(handle, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_event_cb(handle, skn_editor_handle_cb, LV_EVENT_PRESSING, (void *)(uintptr_t)i);
+        lv_obj_add_event_cb(handle, skn_editor_handle_cb, LV_EVENT_RELEASED, (void *)(uintptr_t)i);
+        handles[i] = handle;
+    }
+
+    toolbar = lv_obj_create(radar);
+    lv_obj_set_size(toolbar, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+    lv_obj_set_pos(toolbar, 4, 4);
+    lv_obj_set_flex_flow(toolbar, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(toolbar, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_style_pad_all(toolbar, 4, 0);
+    lv_obj_set_style_pad_column(toolbar, 4, 0);
+    lv_obj_set_style_bg_color(toolbar, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(toolbar, LV_OPA_70, 0);
+    lv_obj_remove_flag(toolbar, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(toolbar, LV_OBJ_FLAG_HIDDEN);
+
+    zone_label = skn_editor_button(toolbar, "Z1", skn_editor_zone_cb, 0);
+    shape_label = skn_editor_button(toolbar, "New", skn_editor_shape_cb, 0);
+    skn_editor_button(toolbar, "+Pt", skn_editor_vertex_cb, 0);
+    skn_editor_button(toolbar, "S-", skn_editor_sens_cb, -1);
+    sens_label = lv_label_create(toolbar);
+    skn_editor_button(toolbar, "S+", skn_editor_sens_cb, 1);
+    skn_editor_button(toolbar, "R-", skn_editor_range_cb, -SKN_EDIT_RANGE_STEP);
+    range_label = lv_label_create(toolbar);
+    skn_editor_button(toolbar, "R+", skn_editor_range_cb, SKN_EDIT_RANGE_STEP);
+    skn_editor_button(toolbar, "Save", skn_editor_save_cb, 0);
+    lv_obj_set_style_text_color(sens_label, lv_color_white(), 0);
+    lv_obj_set_style_text_color(range_label, lv_color_white(), 0);
+    return true;
+}
+
+bool lv_radar_zone_editor_active(void)
+{
+    return editing;
+}
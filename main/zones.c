@@ -0,0 +1,306 @@
+/*
+ * zones.c
+ * User-defined polygon detection zones with an O(1) membership grid.
+ *
+ * The sensor field (x -8 m..8 m, y 0..8 m) is divided into square cells of
+ * CONFIG_SKN_ZONE_CELL_MM. Each cell holds two zone bit masks: the low byte
+ * marks zones whose polygon contains the cell centre, the high byte the same
+ * polygon grown by the zone's hysteresis margin. Occupied zones are tested
+ * against the grown mask so targets on a boundary do not flap.
+ *
+ * Editing a zone only clears and re-rasterizes the cells inside its old and
+ * new bounding boxes. The sensor task may observe a half-updated zone for one
+ * frame while that happens, which the presence debounce absorbs.
+ */
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "zones.h"
+
+#define SKN_ZONE_FIELD_MM   8000
+#define SKN_ZONE_CELL_MM    CONFIG_SKN_ZONE_CELL_MM
+#define SKN_ZONE_GRID_W     ((2 * SKN_ZONE_FIELD_MM) / SKN_ZONE_CELL_MM)
+#define SKN_ZONE_GRID_H     (SKN_ZONE_FIELD_MM / SKN_ZONE_CELL_MM)
+#define SKN_ZONE_NVS_NS     "zones"
+#define SKN_ZONE_NVS_RANGE  "range"
+
+static const char *ZONES_TAG = "Zones";
+
+typedef struct
+{
+    int16_t x1, y1, x2, y2; // Inclusive cell bounds of the grown polygon
+    bool valid;
+} skn_zone_bbox_t;
+
+static skn_zone_t zones[SKN_ZONE_MAX_ZONES];
+static skn_zone_bbox_t zone_bbox[SKN_ZONE_MAX_ZONES];
+static uint16_t *zone_grid = NULL;
+static uint8_t active_mask = 0;
+
+static int16_t skn_zone_cell_x(int32_t x_mm)
+{
+    int32_t cx = (x_mm + SKN_ZONE_FIELD_MM) / SKN_ZONE_CELL_MM;
+    return cx < 0 ? 0 : (cx >= SKN_ZONE_GRID_W ? SKN_ZONE_GRID_W - 1 : cx);
+}
+
+static int16_t skn_zone_cell_y(int32_t y_mm)
+{
+    int32_t cy = y_mm / SKN_ZONE_CELL_MM;
+    return cy < 0 ? 0 : (cy >= SKN_ZONE_GRID_H ? SKN_ZONE_GRID_H - 1 : cy);
+}
+
+static bool skn_zone_contains(const skn_zone_t *zone, float x, float y)
+{
+    bool inside = false;
+    for (uint8_t i = 0, j = zone->vertex_count - 1; i < zone->vertex_count; j = i++) {
+        float xi = zone->vertices[i].x_mm, yi = zone->vertices[i].y_mm;
+        float xj = zone->vertices[j].x_mm, yj = zone->vertices[j].y_mm;
+        if (((yi > y) != (yj > y)) && (x < (xj - xi) * (y - yi) / (yj - yi) + xi)) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+static float skn_zone_edge_distance(const skn_zone_t *zone, float x, float y)
+{
+    float best = INFINITY;
+    for (uint8_t i = 0, j = zone->vertex_count - 1; i < zone->vertex_count; j = i++) {
+        float ax = zone->vertices[j].x_mm, ay = zone->vertices[j].y_mm;
+        float dx = zone->vertices[i].x_mm - ax, dy = zone->vertices[i].y_mm - ay;
+        float len2 = dx * dx + dy * dy;
+        float t = len2 > 0 ? ((x - ax) * dx + (y - ay) * dy) / len2 : 0;
+        t = t < 0 ? 0 : (t > 1 ? 1 : t);
+        float ex = ax + t * dx - x, ey = ay + t * dy - y;
+        float d = sqrtf(ex * ex + ey * ey);
+        if (d < best) {
+            best = d;
+        }
+    }
+    return best;
+}
+
+static void skn_zone_clear_cells(uint8_t index)
+{
+    const skn_zone_bbox_t *bbox = &zone_bbox[index];
+    uint16_t keep = ~((1 << index) | (0x100 << index));
+
+    if (!bbox->valid) {
+        return;
+    }
+    for (int16_t cy = bbox->y1; cy <= bbox->y2; cy++) {
+        uint16_t *row = &zone_grid[cy * SKN_ZONE_GRID_W];
+        for (int16_t cx = bbox->x1; cx <= bbox->x2; cx++) {
+            row[cx] &= keep;
+        }
+    }
+}
+
+static void skn_zone_rasterize(uint8_t index)
+{
+    const skn_zone_t *zone = &zones[index];
+    skn_zone_bbox_t *bbox = &zone_bbox[index];
+    skn_presence_zone_params_t params;
+
+    bbox->valid = false;
+    if (zone->vertex_count < 3) {
+        return;
+    }
+    skn_presence_get_zone_params(index, &params);
+    int32_t margin = params.hysteresis_mm;
+
+    int32_t min_x = INT16_MAX, min_y = INT16_MAX, max_x = INT16_MIN, max_y = INT16_MIN;
+    for (uint8_t i = 0; i < zone->vertex_count; i++) {
+        min_x = zone->vertices[i].x_mm < min_x ? zone->vertices[i].x_mm : min_x;
+        max_x = zone->vertices[i].x_mm > max_x ? zone->vertices[i].x_mm : max_x;
+        min_y = zone->vertices[i].y_mm < min_y ? zone->vertices[i].y_mm : min_y;
+        max_y = zone->vertices[i].y_mm > max_y ? zone->vertices[i].y_mm : max_y;
+    }
+    bbox->x1 = skn_zone_cell_x(min_x - margin);
+    bbox->x2 = skn_zone_cell_x(max_x + margin);
+    bbox->y1 = skn_zone_cell_y(min_y - margin);
+    bbox->y2 = skn_zone_cell_y(max_y + margin);
+    bbox->valid = true;
+
+    uint16_t inner_bit = 1 << index;
+    uint16_t outer_bit = 0x100 << index;
+    for (int16_t cy = bbox->y1; cy <= bbox->y2; cy++) {
+        float y = cy * SKN_ZONE_CELL_MM + SKN_ZONE_CELL_MM / 2.0f;
+        uint16_t *row = &zone_grid[cy * SKN_ZONE_GRID_W];
+        for (int16_t cx = bbox->x1; cx <= bbox->x2; cx++) {
+            float x = cx * SKN_ZONE_CELL_MM - SKN_ZONE_FIELD_MM + SKN_ZONE_CELL_MM / 2.0f;
+            if (skn_zone_contains(zone, x, y)) {
+                row[cx] |= inner_bit | outer_bit;
+            } else if (margin > 0 && skn_zone_edge_distance(zone, x, y) <= margin) {
+                row[cx] |= outer_bit;
+            }
+        }
+    }
+}
+
+static void skn_zone_apply_sensitivity(uint8_t index)
+{
+    skn_presence_zone_params_t params;
+    uint8_t sensitivity = zones[index].sensitivity;
+
+    if (sensitivity == 0) {
+        return;
+    }
+    // Higher sensitivity enters sooner: 10 -> 1 frame, 1 -> 10 frames
+    skn_presence_get_zone_params(index, &params);
+    params.enter_frames = 11 - (sensitivity > 10 ? 10 : sensitivity);
+    skn_presence_set_zone_params(index, &params);
+}
+
+/**
+ * @brief Load zones from NVS and build the membership grid
+ *
+ * Must run after nvs_flash_init() and skn_presence_init().
+ */
+esp_err_t skn_zones_init(void)
+{
+    zone_grid = heap_caps_calloc(SKN_ZONE_GRID_W * SKN_ZONE_GRID_H, sizeof(uint16_t),
+                                 MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (zone_grid == NULL) {
+        ESP_LOGE(ZONES_TAG, "Unable to allocate %dx%d zone grid", SKN_ZONE_GRID_W, SKN_ZONE_GRID_H);
+        return ESP_ERR_NO_MEM;
+    }
+    memset(zones, 0, sizeof(zones));
+    memset(zone_bbox, 0, sizeof(zone_bbox));
+    active_mask = 0;
+
+    nvs_handle_t nvs;
+    if (nvs_open(SKN_ZONE_NVS_NS, NVS_READONLY, &nvs) == ESP_OK) {
+        for (uint8_t i = 0; i < SKN_ZONE_MAX_ZONES; i++) {
+            char key[8];
+            size_t len = sizeof(skn_zone_t);
+            snprintf(key, sizeof(key), "z%u", i);
+            if (nvs_get_blob(nvs, key, &zones[i], &len) != ESP_OK || len != sizeof(skn_zone_t)) {
+                memset(&zones[i], 0, sizeof(skn_zone_t));
+            }
+        }
+        uint16_t range_mm;
+        if (nvs_get_u16(nvs, SKN_ZONE_NVS_RANGE, &range_mm) == ESP_OK) {
+            skn_presence_set_range_mm(range_mm);
+        }
+        nvs_close(nvs);
+    }
+
+    for (uint8_t i = 0; i < SKN_ZONE_MAX_ZONES; i++) {
+        if (zones[i].vertex_count >= 3) {
+            skn_zone_apply_sensitivity(i);
+            skn_zone_rasterize(i);
+            active_mask |= 1 << i;
+            ESP_LOGI(ZONES_TAG, "Zone %u '%s': %u vertices", i, zones[i].name, zones[i].vertex_count);
+        }
+    }
+    return ESP_OK;
+}
+
+void skn_zones_get(uint8_t index, skn_zone_t *zone)
+{
+    if (index < SKN_ZONE_MAX_ZONES) {
+        *zone = zones[index];
+    }
+}
+
+/**
+ * @brief Replace one zone and update only the grid cells it touches
+ */
+esp_err_t skn_zones_set(uint8_t index, const skn_zone_t *zone)
+{
+    if (index >= SKN_ZONE_MAX_ZONES || zone->vertex_count > SKN_ZONE_MAX_VERTICES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (zone_grid == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    skn_zone_clear_cells(index);
+    zones[index] = *zone;
+    skn_zone_apply_sensitivity(index);
+    skn_zone_rasterize(index);
+
+    if (zones[index].vertex_count >= 3) {
+        active_mask |= 1 << index;
+    } else {
+        active_mask &= ~(1 << index);
+    }
+    return ESP_OK;
+}
+
+esp_err_t skn_zones_save(uint8_t index)
+{
+    nvs_handle_t nvs;
+    char key[8];
+
+    if (index >= SKN_ZONE_MAX_ZONES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = nvs_open(SKN_ZONE_NVS_NS, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    snprintf(key, sizeof(key), "z%u", index);
+    ret = nvs_set_blob(nvs, key, &zones[index], sizeof(skn_zone_t));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    ESP_LOGI(ZONES_TAG, "Zone %u saved: %s", index, esp_err_to_name(ret));
+    return ret;
+}
+
+/**
+ * @brief Persist the whole-field range limit
+ */
+esp_err_t skn_zones_save_range(void)
+{
+    nvs_handle_t nvs;
+
+    esp_err_t ret = nvs_open(SKN_ZONE_NVS_NS, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = nvs_set_u16(nvs, SKN_ZONE_NVS_RANGE, skn_presence_get_range_mm());
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    return ret;
+}
+
+uint8_t skn_zones_active_mask(void)
+{
+    return active_mask;
+}
+
+/**
+ * @brief Zones containing a point: one grid read
+ *
+ * @param occupied_mask Zones tested against their hysteresis-grown outline
+ */
+uint8_t skn_zones_lookup(int16_t x_mm, int16_t y_mm, uint8_t occupied_mask)
+{
+    if (zone_grid == NULL || y_mm < 0 || y_mm >= SKN_ZONE_FIELD_MM ||
+        x_mm < -SKN_ZONE_FIELD_MM || x_mm >= SKN_ZONE_FIELD_MM) {
+        return 0;
+    }
+    uint16_t cell = zone_grid[skn_zone_cell_y(y_mm) * SKN_ZONE_GRID_W + skn_zone_cell_x(x_mm)];
+    return (cell & 0xFF) | ((cell >> 8) & occupied_mask);
+}
+
+/**
+ * @brief Presence classifier; falls back to the whole-field zone until zones exist
+ */
+uint8_t skn_zones_classify(const skn_target_t *target, uint8_t occupied_mask)
+{
+    if (active_mask == 0) {
+        return skn_presence_classify_range(target, occupied_mask);
+    }
+    return skn_zones_lookup(target->x_mm, target->y_mm, occupied_mask);
+}
@@ -0,0 +1,107 @@
+/*
+ * radar_stubs.c
+ * Stand-ins for the firmware modules radar_panel.c and zone_editor.c call, so
+ * the widget code can run on the host against the LVGL fake: an in-memory zone
+ * table, fixed sprites and no-op telemetry, power and screen hooks.
+ */
+
+#include <string.h>
+#include "heatmap.h"
+#include "marker_sprites.h"
+#include "power.h"
+#include "presence.h"
+#include "radar_stubs.h"
+#include "radar_targets.h"
+#include "screen_manager.h"
+#include "telemetry.h"
+
+uint32_t stub_zone_sets = 0;
+
+static skn_zone_t zones[SKN_ZONE_MAX_ZONES];
+static uint16_t range_mm = 8000;
+static const lv_image_dsc_t sprite = {.header = {.w = SKN_SPRITE_SZ, .h = SKN_SPRITE_SZ}};
+
+void stub_zone_put(uint8_t index, const skn_zone_t *zone)
+{
+    zones[index] = *zone;
+}
+
+void skn_zones_get(uint8_t index, skn_zone_t *zone)
+{
+    *zone = zones[index];
+}
+
+esp_err_t skn_zones_set(uint8_t index, const skn_zone_t *zone)
+{
+    zones[index] = *zone;
+    stub_zone_sets++;
+    return ESP_OK;
+}
+
+esp_err_t skn_zones_save(uint8_t index)
+{
+    return ESP_OK;
+}
+
+esp_err_t skn_zones_save_range(void)
+{
+    return ESP_OK;
+}
+
+void skn_presence_set_range_mm(uint16_t limit_mm)
+{
+    range_mm = limit_mm;
+}
+
+uint16_t skn_presence_get_range_mm(void)
+{
+    return range_mm;
+}
+
+esp_err_t skn_sprites_init(void)
+{
+    return ESP_OK;
+}
+
+const lv_image_dsc_t *skn_sprite_get(uint8_t track, uint8_t heading, skn_sprite_speed_t speed)
+{
+    return &sprite;
+}
+
+uint8_t skn_sprite_heading(int32_t dx_mm, int32_t dy_mm)
+{
+    return SKN_SPRITE_NO_HEADING;
+}
+
+skn_sprite_speed_t skn_sprite_speed_class(int16_t speed_mms)
+{
+    return SKN_SPRITE_IDLE;
+}
+
+lv_obj_t *lv_radar_heatmap_create(lv_obj_t *radar)
+{
+    return NULL;
+}
+
+lv_obj_t *skn_screen_switch_add(lv_obj_t *screen, skn_screen_id_t target, const char *text)
+{
+    return NULL;
+}
+
+void skn_power_governor_start(lv_obj_t *radar)
+{
+}
+
+uint32_t skn_targets_latest(skn_target_frame_t *frame)
+{
+    return 0;
+}
+
+void skn_telemetry_ui_frame(void)
+{
+}
+
+void skn_telemetry_get(skn_telemetry_t *out)
+{
+    memset(out, 0, sizeof(*out));
+}
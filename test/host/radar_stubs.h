@@ -0,0 +1,9 @@
+// radar_stubs.h - firmware modules around the radar widget, for the host tests
+#pragma once
+
+#include <stdint.h>
+#include "zones.h"
+
+extern uint32_t stub_zone_sets; // skn_zones_set() calls, i.e. membership grid rebuilds
+
+void stub_zone_put(uint8_t index, const skn_zone_t *zone);
@@ -0,0 +1,4 @@
+// driver/uart.h - host shim for the unit tests in test/host
+#pragma once
+
+typedef int uart_port_t;
@@ -0,0 +1,16 @@
+// esp_err.h - host shim for the unit tests in test/host
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef int esp_err_t;
+
+#define ESP_OK         0
+#define ESP_FAIL       -1
+#define ESP_ERR_NO_MEM 0x101
+
+static inline const char *esp_err_to_name(esp_err_t err)
+{
+    return err == ESP_OK ? "ESP_OK" : "ESP_FAIL";
+}
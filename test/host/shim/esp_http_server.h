@@ -0,0 +1,95 @@
+// esp_http_server.h - host shim for the unit tests in test/host
+//
+// Declarations only; the test that links a server module provides a fake
+// server behind them.
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include "esp_err.h"
+
+typedef void *httpd_handle_t;
+
+typedef enum
+{
+    HTTP_GET = 1,
+    HTTP_POST = 3,
+} httpd_method_t;
+
+typedef enum
+{
+    HTTPD_400_BAD_REQUEST = 400,
+    HTTPD_403_FORBIDDEN = 403,
+    HTTPD_404_NOT_FOUND = 404,
+    HTTPD_500_INTERNAL_SERVER_ERROR = 500,
+} httpd_err_code_t;
+
+typedef struct
+{
+    int method;
+    size_t content_len;
+    int fd; // Host only: the session's socket
+} httpd_req_t;
+
+typedef enum
+{
+    HTTPD_WS_TYPE_TEXT = 0x1,
+    HTTPD_WS_TYPE_BINARY = 0x2,
+} httpd_ws_type_t;
+
+typedef enum
+{
+    HTTPD_WS_CLIENT_INVALID = 0,
+    HTTPD_WS_CLIENT_HTTP = 1,
+    HTTPD_WS_CLIENT_WEBSOCKET = 2,
+} httpd_ws_client_info_t;
+
+typedef struct
+{
+    bool final;
+    httpd_ws_type_t type;
+    uint8_t *payload;
+    size_t len;
+} httpd_ws_frame_t;
+
+typedef void (*httpd_close_func_t)(httpd_handle_t hd, int sockfd);
+typedef void (*httpd_work_fn_t)(void *arg);
+
+typedef struct
+{
+    unsigned task_priority;
+    size_t stack_size;
+    int core_id;
+    uint16_t server_port;
+    bool lru_purge_enable;
+    httpd_close_func_t close_fn;
+} httpd_config_t;
+
+#define HTTPD_DEFAULT_CONFIG() {.task_priority = 5, .stack_size = 4096, .core_id = 0x7FFFFFFF, .server_port = 80}
+
+typedef struct
+{
+    const char *uri;
+    httpd_method_t method;
+    esp_err_t (*handler)(httpd_req_t *r);
+    void *user_ctx;
+    bool is_websocket;
+} httpd_uri_t;
+
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config);
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler);
+esp_err_t httpd_queue_work(httpd_handle_t handle, httpd_work_fn_t work, void *arg);
+int httpd_req_to_sockfd(httpd_req_t *r);
+esp_err_t httpd_ws_recv_frame(httpd_req_t *req, httpd_ws_frame_t *pkt, size_t max_len);
+esp_err_t httpd_ws_send_frame_async(httpd_handle_t hd, int fd, httpd_ws_frame_t *frame);
+httpd_ws_client_info_t httpd_ws_get_fd_info(httpd_handle_t hd, int fd);
+esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len);
+esp_err_t httpd_resp_send_chunk(httpd_req_t *r, const char *buf, ssize_t buf_len);
+esp_err_t httpd_resp_send_err(httpd_req_t *req, httpd_err_code_t error, const char *msg);
+esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type);
+esp_err_t httpd_query_key_value(const char *qry, const char *key, char *val, size_t val_size);
+size_t httpd_req_get_hdr_value_len(httpd_req_t *r, const char *field);
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t *r, const char *field, char *val, size_t val_size);
+int httpd_req_recv(httpd_req_t *r, char *buf, size_t buf_len);
@@ -0,0 +1,17 @@
+// esp_log.h - host shim for the unit tests in test/host
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+
+// uint32_t is unsigned long on the target, so the sources print it with %lu;
+// the host shim therefore does not format-check its arguments.
+static inline void esp_log_host(FILE *out, char level, const char *tag, const char *fmt, ...)
+{
+    fprintf(out, "%c %s: %s\n", level, tag, fmt);
+}
+
+#define ESP_LOGE(tag, fmt, ...) esp_log_host(stderr, 'E', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) esp_log_host(stderr, 'W', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) do { if (0) esp_log_host(stdout, 'I', tag, fmt, ##__VA_ARGS__); } while (0)
+#define ESP_LOGD(tag, fmt, ...) do { if (0) esp_log_host(stdout, 'D', tag, fmt, ##__VA_ARGS__); } while (0)
@@ -0,0 +1,14 @@
+// freertos/FreeRTOS.h - host shim for the unit tests in test/host
+//
+// The tests drive the modules from one thread, so critical sections are empty.
+#pragma once
+
+#include <stdint.h>
+
+#define configMAX_TASK_NAME_LEN 16
+
+typedef int portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define taskENTER_CRITICAL(mux)      ((void)(mux))
+#define taskEXIT_CRITICAL(mux)       ((void)(mux))
@@ -0,0 +1,640 @@
+// lv_fake.c - host stand-in for the LVGL widget core, see lvgl.h
+//
+// Objects keep their position, size, flags, event callbacks and whatever a
+// widget was last given (line points, image source, label text). Every change
+// that makes LVGL invalidate an object records the object's screen area in
+// lv_fake_invalid, so a test can check how much a real display would redraw.
+// Nothing is drawn and there is no layout engine: sizes are explicit, lines
+// are as large as their points and images as large as their source.
+//
+// Objects, child and event lists and timers come from lv_malloc(), which
+// ends in lv_*_core(): plain malloc() here unless the test links an LVGL
+// allocator such as main/lv_mem_skn.c.
+
+#include <math.h>
+#include <stdlib.h>
+#include "lvgl.h"
+
+#define LV_FAKE_CONTENT_W 100 // Stand-in for LV_SIZE_CONTENT and unset sizes
+#define LV_FAKE_CONTENT_H 40
+#define LV_FAKE_GLYPH_W   8
+#define LV_FAKE_GLYPH_H   16
+
+const lv_obj_class_t lv_obj_class = {.instance_size = sizeof(lv_obj_t)};
+const lv_obj_class_t lv_line_class = {.base_class = &lv_obj_class, .instance_size = sizeof(lv_obj_t)};
+const lv_obj_class_t lv_image_class = {.base_class = &lv_obj_class, .instance_size = sizeof(lv_obj_t)};
+const lv_obj_class_t lv_label_class = {.base_class = &lv_obj_class, .instance_size = sizeof(lv_obj_t)};
+const lv_obj_class_t lv_canvas_class = {.base_class = &lv_image_class, .instance_size = sizeof(lv_obj_t)};
+
+lv_fake_invalid_t lv_fake_invalid;
+
+// Allocator: the weak core functions give way to a linked LVGL allocator
+
+__attribute__((weak)) void *lv_malloc_core(size_t size)
+{
+    return malloc(size);
+}
+
+__attribute__((weak)) void *lv_realloc_core(void *p, size_t new_size)
+{
+    return realloc(p, new_size);
+}
+
+__attribute__((weak)) void lv_free_core(void *p)
+{
+    free(p);
+}
+
+void *lv_malloc(size_t size)
+{
+    return lv_malloc_core(size);
+}
+
+void *lv_malloc_zeroed(size_t size)
+{
+    void *p = lv_malloc_core(size);
+    if (p != NULL) {
+        lv_memzero(p, size);
+    }
+    return p;
+}
+
+void *lv_realloc(void *p, size_t new_size)
+{
+    return lv_realloc_core(p, new_size);
+}
+
+void lv_free(void *p)
+{
+    if (p != NULL) {
+        lv_free_core(p);
+    }
+}
+
+static uint32_t fake_tick = 0;
+static uint32_t fake_event_id = LV_EVENT_LAST;
+static lv_indev_t fake_indev;
+
+void lv_fake_invalid_reset(void)
+{
+    lv_memzero(&lv_fake_invalid, sizeof(lv_fake_invalid));
+}
+
+void lv_fake_tick_set(uint32_t tick)
+{
+    fake_tick = tick;
+}
+
+static bool fake_visible(const lv_obj_t *obj)
+{
+    for (; obj != NULL; obj = obj->parent) {
+        if (obj->flags & LV_OBJ_FLAG_HIDDEN) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void fake_invalidate(const lv_obj_t *obj)
+{
+    lv_area_t area;
+
+    if (!fake_visible(obj) || obj->w <= 0 || obj->h <= 0) {
+        return;
+    }
+    if (lv_fake_invalid.count == LV_FAKE_MAX_INVALID) {
+        lv_fake_invalid.dropped++;
+        return;
+    }
+    lv_obj_get_coords(obj, &area);
+    lv_fake_invalid.areas[lv_fake_invalid.count++] = area;
+}
+
+static int32_t fake_size(int32_t value, int32_t parent_value)
+{
+    if (value == LV_SIZE_CONTENT) {
+        return LV_FAKE_CONTENT_W;
+    }
+    if (value & (1 << 29)) {
+        return parent_value * (value & 0xFFFF) / 100;
+    }
+    return value;
+}
+
+/**
+ * @brief Resize without the size-changed event; the widget's own content
+ */
+static void fake_resize(lv_obj_t *obj, int32_t w, int32_t h)
+{
+    if (obj->w == w && obj->h == h) {
+        return;
+    }
+    fake_invalidate(obj);
+    obj->w = w;
+    obj->h = h;
+    fake_invalidate(obj);
+}
+
+// Classes and events
+
+lv_obj_t *lv_obj_class_create_obj(const lv_obj_class_t *class_p, lv_obj_t *parent)
+{
+    lv_obj_t *obj = lv_malloc_zeroed(class_p->instance_size);
+
+    obj->class_p = class_p;
+    obj->parent = parent;
+    obj->flags = LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE;
+    if (parent != NULL) {
+        parent->children = lv_realloc(parent->children, (parent->child_count + 1) * sizeof(obj));
+        parent->children[parent->child_count++] = obj;
+    }
+    return obj;
+}
+
+static void fake_construct(const lv_obj_class_t *class_p, lv_obj_t *obj)
+{
+    if (class_p->base_class != NULL) {
+        fake_construct(class_p->base_class, obj);
+    }
+    if (class_p->constructor_cb != NULL) {
+        class_p->constructor_cb(class_p, obj);
+    }
+}
+
+/**
+ * @brief Construct, then apply the class's default size as the first layout would
+ */
+void lv_obj_class_init_obj(lv_obj_t *obj)
+{
+    fake_construct(obj->class_p, obj);
+    if (obj->class_p->width_def || obj->class_p->height_def) {
+        lv_obj_set_size(obj, obj->class_p->width_def, obj->class_p->height_def);
+    }
+    fake_invalidate(obj);
+}
+
+static lv_obj_t *fake_create(const lv_obj_class_t *class_p, lv_obj_t *parent)
+{
+    lv_obj_t *obj = lv_obj_class_create_obj(class_p, parent);
+    lv_obj_class_init_obj(obj);
+    return obj;
+}
+
+lv_obj_t *lv_obj_create(lv_obj_t *parent)
+{
+    lv_obj_t *obj = fake_create(&lv_obj_class, parent);
+
+    if (parent != NULL) {
+        fake_resize(obj, LV_FAKE_CONTENT_W, LV_FAKE_CONTENT_H);
+    }
+    return obj;
+}
+
+void lv_obj_add_event_cb(lv_obj_t *obj, lv_event_cb_t event_cb, lv_event_code_t filter, void *user_data)
+{
+    obj->events = lv_realloc(obj->events, (obj->event_count + 1) * sizeof(obj->events[0]));
+    obj->events[obj->event_count++] = (lv_fake_event_dsc_t){event_cb, filter, user_data};
+}
+
+bool lv_obj_remove_event_cb(lv_obj_t *obj, lv_event_cb_t event_cb)
+{
+    for (uint8_t i = 0; i < obj->event_count; i++) {
+        if (obj->events[i].cb == event_cb) {
+            memmove(&obj->events[i], &obj->events[i + 1], (obj->event_count - i - 1) * sizeof(obj->events[0]));
+            obj->event_count--;
+            return true;
+        }
+    }
+    return false;
+}
+
+lv_result_t lv_obj_event_base(const lv_obj_class_t *class_p, lv_event_t *e)
+{
+    return LV_RESULT_OK;
+}
+
+/**
+ * @brief Like LVGL: the class handler first, then the callbacks in order
+ */
+lv_result_t lv_obj_send_event(lv_obj_t *obj, lv_event_code_t event_code, void *param)
+{
+    lv_event_t e = {.current_target = obj, .code = event_code, .param = param};
+
+    for (const lv_obj_class_t *c = obj->class_p; c != NULL; c = c->base_class) {
+        if (c->event_cb != NULL) {
+            c->event_cb(c, &e);
+            break;
+        }
+    }
+    for (uint8_t i = 0; i < obj->event_count; i++) {
+        if (obj->events[i].filter == LV_EVENT_ALL || obj->events[i].filter == event_code) {
+            e.user_data = obj->events[i].user_data;
+            obj->events[i].cb(&e);
+        }
+    }
+    return LV_RESULT_OK;
+}
+
+uint32_t lv_event_register_id(void)
+{
+    return ++fake_event_id;
+}
+
+void lv_obj_delete(lv_obj_t *obj)
+{
+    lv_obj_send_event(obj, LV_EVENT_DELETE, NULL);
+    while (obj->child_count > 0) {
+        lv_obj_delete(obj->children[obj->child_count - 1]);
+    }
+    fake_invalidate(obj);
+    for (const lv_obj_class_t *c = obj->class_p; c != NULL; c = c->base_class) {
+        if (c->destructor_cb != NULL) {
+            c->destructor_cb(c, obj);
+        }
+    }
+
+    lv_obj_t *parent = obj->parent;
+    for (uint32_t i = 0; parent != NULL && i < parent->child_count; i++) {
+        if (parent->children[i] == obj) {
+            memmove(&parent->children[i], &parent->children[i + 1], (parent->child_count - i - 1) * sizeof(obj));
+            parent->child_count--;
+            break;
+        }
+    }
+    lv_free(obj->children);
+    lv_free(obj->events);
+    lv_free(obj);
+}
+
+lv_obj_t *lv_obj_get_child_by_type(const lv_obj_t *obj, int32_t idx, const lv_obj_class_t *class_p)
+{
+    for (uint32_t i = 0; i < obj->child_count; i++) {
+        if (obj->children[i]->class_p == class_p && idx-- == 0) {
+            return obj->children[i];
+        }
+    }
+    return NULL;
+}
+
+uint32_t lv_obj_get_child_count(const lv_obj_t *obj)
+{
+    return obj->child_count;
+}
+
+// Geometry and flags
+
+void lv_obj_set_pos(lv_obj_t *obj, int32_t x, int32_t y)
+{
+    if (obj->x == x && obj->y == y) {
+        return;
+    }
+    fake_invalidate(obj);
+    obj->x = x;
+    obj->y = y;
+    fake_invalidate(obj);
+}
+
+void lv_obj_set_size(lv_obj_t *obj, int32_t w, int32_t h)
+{
+    w = fake_size(w, obj->parent ? obj->parent->w : 0);
+    h = fake_size(h, obj->parent ? obj->parent->h : 0);
+    if (obj->w == w && obj->h == h) {
+        return;
+    }
+    fake_resize(obj, w, h);
+    lv_obj_send_event(obj, LV_EVENT_SIZE_CHANGED, NULL);
+}
+
+void lv_obj_update_layout(const lv_obj_t *obj)
+{
+}
+
+int32_t lv_obj_get_width(const lv_obj_t *obj)
+{
+    return obj->w;
+}
+
+int32_t lv_obj_get_height(const lv_obj_t *obj)
+{
+    return obj->h;
+}
+
+int32_t lv_obj_get_content_width(const lv_obj_t *obj)
+{
+    return obj->w;
+}
+
+int32_t lv_obj_get_content_height(const lv_obj_t *obj)
+{
+    return obj->h;
+}
+
+void lv_obj_get_coords(const lv_obj_t *obj, lv_area_t *coords)
+{
+    int32_t x = 0, y = 0;
+
+    for (const lv_obj_t *o = obj; o != NULL; o = o->parent) {
+        x += o->x;
+        y += o->y;
+    }
+    *coords = (lv_area_t){.x1 = x, .y1 = y, .x2 = x + obj->w - 1, .y2 = y + obj->h - 1};
+}
+
+void lv_obj_add_flag(lv_obj_t *obj, lv_obj_flag_t f)
+{
+    if ((f & LV_OBJ_FLAG_HIDDEN) && !(obj->flags & LV_OBJ_FLAG_HIDDEN)) {
+        fake_invalidate(obj);
+    }
+    obj->flags |= f;
+}
+
+void lv_obj_remove_flag(lv_obj_t *obj, lv_obj_flag_t f)
+{
+    bool shows = (f & LV_OBJ_FLAG_HIDDEN) && (obj->flags & LV_OBJ_FLAG_HIDDEN);
+
+    obj->flags &= ~f;
+    if (shows) {
+        fake_invalidate(obj);
+    }
+}
+
+bool lv_obj_has_flag(const lv_obj_t *obj, lv_obj_flag_t f)
+{
+    return (obj->flags & f) == f;
+}
+
+void lv_obj_move_foreground(lv_obj_t *obj)
+{
+    lv_obj_t *parent = obj->parent;
+
+    for (uint32_t i = 0; i < parent->child_count; i++) {
+        if (parent->children[i] == obj) {
+            memmove(&parent->children[i], &parent->children[i + 1], (parent->child_count - i - 1) * sizeof(obj));
+            parent->children[parent->child_count - 1] = obj;
+            fake_invalidate(obj);
+            return;
+        }
+    }
+}
+
+void lv_obj_center(lv_obj_t *obj)
+{
+}
+
+void lv_obj_set_ext_click_area(lv_obj_t *obj, int32_t size)
+{
+}
+
+void lv_obj_set_flex_flow(lv_obj_t *obj, lv_flex_flow_t flow)
+{
+}
+
+void lv_obj_set_flex_align(lv_obj_t *obj, lv_flex_align_t main_place, lv_flex_align_t cross_place,
+                           lv_flex_align_t track_cross_place)
+{
+}
+
+void lv_obj_set_user_data(lv_obj_t *obj, void *user_data)
+{
+    obj->user_data = user_data;
+}
+
+void *lv_obj_get_user_data(lv_obj_t *obj)
+{
+    return obj->user_data;
+}
+
+// Styles
+
+void lv_style_init(lv_style_t *style) {}
+void lv_style_set_line_width(lv_style_t *style, int32_t value) {}
+void lv_style_set_line_color(lv_style_t *style, lv_color_t value) {}
+void lv_style_set_line_rounded(lv_style_t *style, bool value) {}
+void lv_obj_add_style(lv_obj_t *obj, const lv_style_t *style, lv_style_selector_t selector) {}
+void lv_obj_set_style_bg_color(lv_obj_t *obj, lv_color_t value, lv_style_selector_t selector) {}
+void lv_obj_set_style_bg_opa(lv_obj_t *obj, lv_opa_t value, lv_style_selector_t selector) {}
+void lv_obj_set_style_border_color(lv_obj_t *obj, lv_color_t value, lv_style_selector_t selector) {}
+void lv_obj_set_style_border_width(lv_obj_t *obj, int32_t value, lv_style_selector_t selector) {}
+void lv_obj_set_style_radius(lv_obj_t *obj, int32_t value, lv_style_selector_t selector) {}
+void lv_obj_set_style_pad_all(lv_obj_t *obj, int32_t value, lv_style_selector_t selector) {}
+void lv_obj_set_style_pad_column(lv_obj_t *obj, int32_t value, lv_style_selector_t selector) {}
+void lv_obj_set_style_line_color(lv_obj_t *obj, lv_color_t value, lv_style_selector_t selector) {}
+void lv_obj_set_style_line_opa(lv_obj_t *obj, lv_opa_t value, lv_style_selector_t selector) {}
+void lv_obj_set_style_line_width(lv_obj_t *obj, int32_t value, lv_style_selector_t selector) {}
+void lv_obj_set_style_text_color(lv_obj_t *obj, lv_color_t value, lv_style_selector_t selector) {}
+
+// Widgets
+
+lv_obj_t *lv_button_create(lv_obj_t *parent)
+{
+    return lv_obj_create(parent);
+}
+
+lv_obj_t *lv_label_create(lv_obj_t *parent)
+{
+    return fake_create(&lv_label_class, parent);
+}
+
+void lv_label_set_text(lv_obj_t *obj, const char *text)
+{
+    if (strcmp(obj->text, text) == 0) {
+        return;
+    }
+    fake_invalidate(obj);
+    snprintf(obj->text, sizeof(obj->text), "%s", text);
+    fake_resize(obj, (int32_t)strlen(obj->text) * LV_FAKE_GLYPH_W, LV_FAKE_GLYPH_H);
+    fake_invalidate(obj);
+}
+
+void lv_label_set_text_fmt(lv_obj_t *obj, const char *fmt, ...)
+{
+    char text[sizeof(obj->text)];
+    va_list args;
+
+    va_start(args, fmt);
+    vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+    lv_label_set_text(obj, text);
+}
+
+lv_obj_t *lv_line_create(lv_obj_t *parent)
+{
+    return fake_create(&lv_line_class, parent);
+}
+
+/**
+ * @brief Keep the caller's array, as lv_line does, and size the line to it
+ */
+void lv_line_set_points(lv_obj_t *obj, const lv_point_precise_t points[], uint32_t point_num)
+{
+    int32_t w = 0, h = 0;
+
+    fake_invalidate(obj);
+    obj->points = points;
+    obj->point_count = point_num;
+    for (uint32_t i = 0; i < point_num; i++) {
+        w = LV_MAX(w, points[i].x + 1);
+        h = LV_MAX(h, points[i].y + 1);
+    }
+    obj->w = w;
+    obj->h = h;
+    fake_invalidate(obj);
+}
+
+lv_obj_t *lv_image_create(lv_obj_t *parent)
+{
+    return fake_create(&lv_image_class, parent);
+}
+
+void lv_image_set_src(lv_obj_t *obj, const void *src)
+{
+    const lv_image_dsc_t *dsc = src;
+
+    fake_invalidate(obj);
+    obj->src = src;
+    if (dsc != NULL) {
+        obj->w = dsc->header.w;
+        obj->h = dsc->header.h;
+    }
+    fake_invalidate(obj);
+}
+
+void lv_image_set_pivot(lv_obj_t *obj, int32_t x, int32_t y) {}
+void lv_image_set_scale(lv_obj_t *obj, uint32_t zoom) {}
+void lv_image_cache_drop(const void *src) {}
+
+lv_obj_t *lv_canvas_create(lv_obj_t *parent)
+{
+    return fake_create(&lv_canvas_class, parent);
+}
+
+void lv_canvas_set_draw_buf(lv_obj_t *obj, lv_draw_buf_t *draw_buf)
+{
+    lv_image_set_src(obj, draw_buf);
+}
+
+lv_draw_buf_t *lv_canvas_get_draw_buf(lv_obj_t *obj)
+{
+    return (lv_draw_buf_t *)obj->src;
+}
+
+void lv_canvas_fill_bg(lv_obj_t *obj, lv_color_t color, lv_opa_t opa) {}
+
+void lv_canvas_init_layer(lv_obj_t *canvas, lv_layer_t *layer)
+{
+    layer->canvas = canvas;
+}
+
+void lv_canvas_finish_layer(lv_obj_t *canvas, lv_layer_t *layer)
+{
+    fake_invalidate(canvas);
+}
+
+uint32_t lv_draw_buf_width_to_stride(uint32_t w, lv_color_format_t color_format)
+{
+    return (w * 2 + LV_DRAW_BUF_ALIGN - 1) & ~(LV_DRAW_BUF_ALIGN - 1);
+}
+
+lv_result_t lv_draw_buf_init(lv_draw_buf_t *draw_buf, uint32_t w, uint32_t h, lv_color_format_t cf, uint32_t stride,
+                             void *data, uint32_t data_size)
+{
+    *draw_buf = (lv_draw_buf_t){
+        .header = {.w = w, .h = h, .cf = cf, .stride = stride},
+        .data_size = data_size,
+        .data = data,
+    };
+    return LV_RESULT_OK;
+}
+
+void lv_draw_line_dsc_init(lv_draw_line_dsc_t *dsc) { lv_memzero(dsc, sizeof(*dsc)); }
+void lv_draw_line(lv_layer_t *layer, const lv_draw_line_dsc_t *dsc) {}
+void lv_draw_arc_dsc_init(lv_draw_arc_dsc_t *dsc) { lv_memzero(dsc, sizeof(*dsc)); }
+void lv_draw_arc(lv_layer_t *layer, const lv_draw_arc_dsc_t *dsc) {}
+void lv_draw_label_dsc_init(lv_draw_label_dsc_t *dsc) { lv_memzero(dsc, sizeof(*dsc)); }
+void lv_draw_label(lv_layer_t *layer, const lv_draw_label_dsc_t *dsc, const lv_area_t *coords) {}
+
+int32_t lv_trigo_sin(int16_t angle)
+{
+    return (int32_t)lround(sin(angle * M_PI / 180.0) * (LV_TRIGO_SIN_MAX - 1));
+}
+
+int32_t lv_trigo_cos(int16_t angle)
+{
+    return lv_trigo_sin(angle + 90);
+}
+
+// Timers run only when a test calls their callback; animations end at once
+
+lv_timer_t *lv_timer_create(lv_timer_cb_t timer_xcb, uint32_t period, void *user_data)
+{
+    lv_timer_t *timer = lv_malloc(sizeof(*timer));
+
+    *timer = (lv_timer_t){.cb = timer_xcb, .period = period, .user_data = user_data};
+    return timer;
+}
+
+void lv_timer_delete(lv_timer_t *timer)
+{
+    lv_free(timer);
+}
+
+void lv_timer_pause(lv_timer_t *timer)
+{
+    timer->paused = true;
+}
+
+void lv_timer_resume(lv_timer_t *timer)
+{
+    timer->paused = false;
+}
+
+int32_t lv_anim_path_ease_in_out(const void *anim)
+{
+    return 0;
+}
+
+void lv_anim_init(lv_anim_t *a) { lv_memzero(a, sizeof(*a)); }
+void lv_anim_set_var(lv_anim_t *a, void *var) { a->var = var; }
+void lv_anim_set_exec_cb(lv_anim_t *a, lv_anim_exec_xcb_t exec_cb) { a->exec_cb = exec_cb; }
+void lv_anim_set_path_cb(lv_anim_t *a, lv_anim_path_cb_t path_cb) { a->path_cb = path_cb; }
+void lv_anim_set_values(lv_anim_t *a, int32_t start, int32_t end) { a->start_value = start; a->end_value = end; }
+void lv_anim_set_duration(lv_anim_t *a, uint32_t duration) { a->duration = duration; }
+
+void lv_anim_start(const lv_anim_t *a)
+{
+    a->exec_cb(a->var, a->end_value);
+}
+
+bool lv_anim_delete(void *var, lv_anim_exec_xcb_t exec_cb)
+{
+    return false;
+}
+
+uint32_t lv_tick_get(void)
+{
+    return fake_tick;
+}
+
+uint32_t lv_tick_elaps(uint32_t prev_tick)
+{
+    return fake_tick - prev_tick;
+}
+
+lv_indev_t *lv_indev_active(void)
+{
+    return &fake_indev;
+}
+
+void lv_indev_get_point(const lv_indev_t *indev, lv_point_t *point)
+{
+    *point = indev->point;
+}
+
+/**
+ * @brief Touch at a screen position and send one input event to an object
+ */
+void lv_fake_press(lv_obj_t *obj, lv_event_code_t code, int32_t x, int32_t y)
+{
+    fake_indev.point = (lv_point_t){x, y};
+    lv_obj_send_event(obj, code, NULL);
+}
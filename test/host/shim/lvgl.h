@@ -0,0 +1,454 @@
+// lvgl.h - host shim for the unit tests in test/host
+//
+// Only the types and helpers the tested modules touch; nothing here draws.
+// lv_fake.c backs the widget part with a small object tree that records
+// what a real display would have to redraw (see lv_fake_* at the end).
+#pragma once
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LV_UNUSED(x)       ((void)x)
+#define LV_DRAW_BUF_ALIGN  4
+#define LV_MIN(a, b)       ((a) < (b) ? (a) : (b))
+#define LV_MAX(a, b)       ((a) > (b) ? (a) : (b))
+#define LV_CLAMP(min, val, max) (LV_MAX(min, LV_MIN(val, max)))
+
+#define LV_PRId32                "d"
+#define LV_LOG_WARN(...)         ((void)0)
+#define LV_ASSERT_OBJ(obj, cls)  ((void)(obj), (void)(cls))
+#define LV_DEF_REFR_PERIOD       33
+
+#define LV_COORD_MAX       ((1 << 29) - 1)
+#define LV_PCT(x)          ((x) | (1 << 29))
+#define LV_SIZE_CONTENT    (2001 | (1 << 29))
+#define LV_RADIUS_CIRCLE   0x7FFF
+#define LV_SCALE_NONE      256
+#define LV_TRIGO_SIN_MAX   32768
+#define LV_TRIGO_SHIFT     15
+
+typedef void *lv_mem_pool_t;
+typedef uint8_t lv_color_format_t;
+typedef uint8_t lv_opa_t;
+typedef uint32_t lv_style_selector_t;
+
+#define LV_COLOR_FORMAT_RGB565 0x12
+
+enum
+{
+    LV_OPA_TRANSP = 0,
+    LV_OPA_70 = 178,
+    LV_OPA_80 = 204,
+    LV_OPA_COVER = 255,
+};
+
+typedef enum
+{
+    LV_RESULT_INVALID = 0,
+    LV_RESULT_OK,
+} lv_result_t;
+
+typedef struct
+{
+    size_t total_size;
+    size_t free_cnt;
+    size_t free_size;
+    size_t free_biggest_size;
+    size_t used_cnt;
+    size_t max_used;
+    uint8_t used_pct;
+    uint8_t frag_pct;
+} lv_mem_monitor_t;
+
+typedef struct
+{
+    void *(*buf_malloc_cb)(size_t size, lv_color_format_t cf);
+    void (*buf_free_cb)(void *buf);
+} lv_draw_buf_handlers_t;
+
+lv_draw_buf_handlers_t *lv_draw_buf_get_handlers(void);
+
+void lv_mem_init(void);
+void lv_mem_deinit(void);
+void *lv_malloc_core(size_t size);
+void *lv_realloc_core(void *p, size_t new_size);
+void lv_free_core(void *p);
+void *lv_malloc(size_t size);
+void *lv_malloc_zeroed(size_t size);
+void *lv_realloc(void *p, size_t new_size);
+void lv_free(void *p);
+void lv_mem_monitor_core(lv_mem_monitor_t *mon_p);
+lv_result_t lv_mem_test_core(void);
+
+// Geometry and colour
+
+typedef struct
+{
+    int32_t x;
+    int32_t y;
+} lv_point_t;
+
+typedef lv_point_t lv_point_precise_t;
+
+typedef struct
+{
+    int32_t x1;
+    int32_t y1;
+    int32_t x2;
+    int32_t y2;
+} lv_area_t;
+
+typedef struct
+{
+    uint8_t blue;
+    uint8_t green;
+    uint8_t red;
+} lv_color_t;
+
+static inline lv_color_t lv_color_hex(uint32_t c)
+{
+    return (lv_color_t){.red = (c >> 16) & 0xFF, .green = (c >> 8) & 0xFF, .blue = c & 0xFF};
+}
+
+static inline lv_color_t lv_color_black(void)
+{
+    return lv_color_hex(0x000000);
+}
+
+static inline lv_color_t lv_color_white(void)
+{
+    return lv_color_hex(0xFFFFFF);
+}
+
+static inline void lv_memzero(void *dst, size_t len)
+{
+    memset(dst, 0, len);
+}
+
+#define lv_snprintf snprintf
+
+int32_t lv_trigo_sin(int16_t angle);
+int32_t lv_trigo_cos(int16_t angle);
+
+// Objects, classes and events
+
+typedef enum
+{
+    LV_EVENT_ALL = 0,
+    LV_EVENT_PRESSED,
+    LV_EVENT_PRESSING,
+    LV_EVENT_LONG_PRESSED,
+    LV_EVENT_CLICKED,
+    LV_EVENT_RELEASED,
+    LV_EVENT_DELETE,
+    LV_EVENT_SIZE_CHANGED,
+    LV_EVENT_LAST,
+} lv_event_code_t;
+
+typedef enum
+{
+    LV_OBJ_FLAG_HIDDEN = 1 << 0,
+    LV_OBJ_FLAG_CLICKABLE = 1 << 1,
+    LV_OBJ_FLAG_SCROLLABLE = 1 << 4,
+} lv_obj_flag_t;
+
+typedef enum
+{
+    LV_FLEX_FLOW_ROW = 0,
+} lv_flex_flow_t;
+
+typedef enum
+{
+    LV_FLEX_ALIGN_START = 0,
+    LV_FLEX_ALIGN_CENTER = 2,
+} lv_flex_align_t;
+
+typedef struct lv_obj_class_t lv_obj_class_t;
+typedef struct lv_event_t lv_event_t;
+typedef void (*lv_event_cb_t)(lv_event_t *e);
+
+typedef struct
+{
+    lv_event_cb_t cb;
+    lv_event_code_t filter;
+    void *user_data;
+} lv_fake_event_dsc_t;
+
+typedef struct lv_obj_t
+{
+    const lv_obj_class_t *class_p;
+    struct lv_obj_t *parent;
+    struct lv_obj_t **children; // Grown by one per child, as LVGL does
+    uint32_t child_count;
+    int32_t x, y, w, h; // Relative to the parent
+    uint32_t flags;
+    void *user_data;
+    lv_fake_event_dsc_t *events; // Grown by one per callback
+    uint8_t event_count;
+    const lv_point_precise_t *points; // lv_line: the array it was given
+    uint32_t point_count;
+    const void *src; // lv_image / lv_canvas
+    char text[32];   // lv_label
+} lv_obj_t;
+
+struct lv_obj_class_t
+{
+    const lv_obj_class_t *base_class;
+    void (*constructor_cb)(const lv_obj_class_t *class_p, lv_obj_t *obj);
+    void (*destructor_cb)(const lv_obj_class_t *class_p, lv_obj_t *obj);
+    void (*event_cb)(const lv_obj_class_t *class_p, lv_event_t *e);
+    int32_t width_def;
+    int32_t height_def;
+    uint32_t instance_size;
+};
+
+struct lv_event_t
+{
+    lv_obj_t *current_target;
+    lv_event_code_t code;
+    void *user_data;
+    void *param;
+};
+
+extern const lv_obj_class_t lv_obj_class;
+extern const lv_obj_class_t lv_line_class;
+extern const lv_obj_class_t lv_image_class;
+extern const lv_obj_class_t lv_label_class;
+extern const lv_obj_class_t lv_canvas_class;
+
+lv_obj_t *lv_obj_class_create_obj(const lv_obj_class_t *class_p, lv_obj_t *parent);
+void lv_obj_class_init_obj(lv_obj_t *obj);
+lv_obj_t *lv_obj_create(lv_obj_t *parent);
+void lv_obj_delete(lv_obj_t *obj);
+#define lv_obj_del lv_obj_delete
+lv_obj_t *lv_obj_get_child_by_type(const lv_obj_t *obj, int32_t idx, const lv_obj_class_t *class_p);
+uint32_t lv_obj_get_child_count(const lv_obj_t *obj);
+void lv_obj_set_pos(lv_obj_t *obj, int32_t x, int32_t y);
+void lv_obj_set_size(lv_obj_t *obj, int32_t w, int32_t h);
+void lv_obj_update_layout(const lv_obj_t *obj);
+int32_t lv_obj_get_width(const lv_obj_t *obj);
+int32_t lv_obj_get_height(const lv_obj_t *obj);
+int32_t lv_obj_get_content_width(const lv_obj_t *obj);
+int32_t lv_obj_get_content_height(const lv_obj_t *obj);
+void lv_obj_get_coords(const lv_obj_t *obj, lv_area_t *coords);
+void lv_obj_add_flag(lv_obj_t *obj, lv_obj_flag_t f);
+void lv_obj_remove_flag(lv_obj_t *obj, lv_obj_flag_t f);
+bool lv_obj_has_flag(const lv_obj_t *obj, lv_obj_flag_t f);
+void lv_obj_move_foreground(lv_obj_t *obj);
+void lv_obj_center(lv_obj_t *obj);
+void lv_obj_set_ext_click_area(lv_obj_t *obj, int32_t size);
+void lv_obj_set_flex_flow(lv_obj_t *obj, lv_flex_flow_t flow);
+void lv_obj_set_flex_align(lv_obj_t *obj, lv_flex_align_t main_place, lv_flex_align_t cross_place,
+                           lv_flex_align_t track_cross_place);
+void lv_obj_set_user_data(lv_obj_t *obj, void *user_data);
+void *lv_obj_get_user_data(lv_obj_t *obj);
+void lv_obj_add_event_cb(lv_obj_t *obj, lv_event_cb_t event_cb, lv_event_code_t filter, void *user_data);
+bool lv_obj_remove_event_cb(lv_obj_t *obj, lv_event_cb_t event_cb);
+lv_result_t lv_obj_send_event(lv_obj_t *obj, lv_event_code_t event_code, void *param);
+lv_result_t lv_obj_event_base(const lv_obj_class_t *class_p, lv_event_t *e);
+uint32_t lv_event_register_id(void);
+
+static inline lv_event_code_t lv_event_get_code(lv_event_t *e)
+{
+    return e->code;
+}
+
+static inline void *lv_event_get_user_data(lv_event_t *e)
+{
+    return e->user_data;
+}
+
+static inline void *lv_event_get_current_target(lv_event_t *e)
+{
+    return e->current_target;
+}
+
+// Styles: accepted and ignored, nothing is drawn
+
+typedef struct
+{
+    uint32_t unused;
+} lv_style_t;
+
+void lv_style_init(lv_style_t *style);
+void lv_style_set_line_width(lv_style_t *style, int32_t value);
+void lv_style_set_line_color(lv_style_t *style, lv_color_t value);
+void lv_style_set_line_rounded(lv_style_t *style, bool value);
+void lv_obj_add_style(lv_obj_t *obj, const lv_style_t *style, lv_style_selector_t selector);
+void lv_obj_set_style_bg_color(lv_obj_t *obj, lv_color_t value, lv_style_selector_t selector);
+void lv_obj_set_style_bg_opa(lv_obj_t *obj, lv_opa_t value, lv_style_selector_t selector);
+void lv_obj_set_style_border_color(lv_obj_t *obj, lv_color_t value, lv_style_selector_t selector);
+void lv_obj_set_style_border_width(lv_obj_t *obj, int32_t value, lv_style_selector_t selector);
+void lv_obj_set_style_radius(lv_obj_t *obj, int32_t value, lv_style_selector_t selector);
+void lv_obj_set_style_pad_all(lv_obj_t *obj, int32_t value, lv_style_selector_t selector);
+void lv_obj_set_style_pad_column(lv_obj_t *obj, int32_t value, lv_style_selector_t selector);
+void lv_obj_set_style_line_color(lv_obj_t *obj, lv_color_t value, lv_style_selector_t selector);
+void lv_obj_set_style_line_opa(lv_obj_t *obj, lv_opa_t value, lv_style_selector_t selector);
+void lv_obj_set_style_line_width(lv_obj_t *obj, int32_t value, lv_style_selector_t selector);
+void lv_obj_set_style_text_color(lv_obj_t *obj, lv_color_t value, lv_style_selector_t selector);
+
+// Widgets
+
+typedef struct
+{
+    uint32_t w;
+    uint32_t h;
+    uint32_t cf;
+    uint32_t stride;
+} lv_image_header_t;
+
+typedef struct
+{
+    lv_image_header_t header;
+    uint32_t data_size;
+    const uint8_t *data;
+} lv_image_dsc_t;
+
+typedef struct
+{
+    lv_image_header_t header;
+    uint32_t data_size;
+    uint8_t *data;
+} lv_draw_buf_t;
+
+typedef struct
+{
+    lv_obj_t *canvas;
+} lv_layer_t;
+
+typedef struct
+{
+    lv_color_t color;
+    int32_t width;
+    lv_point_precise_t p1;
+    lv_point_precise_t p2;
+} lv_draw_line_dsc_t;
+
+typedef struct
+{
+    lv_color_t color;
+    int32_t width;
+    lv_point_t center;
+    int32_t radius;
+    int32_t start_angle;
+    int32_t end_angle;
+} lv_draw_arc_dsc_t;
+
+typedef struct
+{
+    lv_color_t color;
+    const char *text;
+} lv_draw_label_dsc_t;
+
+lv_obj_t *lv_button_create(lv_obj_t *parent);
+lv_obj_t *lv_label_create(lv_obj_t *parent);
+void lv_label_set_text(lv_obj_t *obj, const char *text);
+void lv_label_set_text_fmt(lv_obj_t *obj, const char *fmt, ...);
+lv_obj_t *lv_line_create(lv_obj_t *parent);
+void lv_line_set_points(lv_obj_t *obj, const lv_point_precise_t points[], uint32_t point_num);
+lv_obj_t *lv_image_create(lv_obj_t *parent);
+void lv_image_set_src(lv_obj_t *obj, const void *src);
+void lv_image_set_pivot(lv_obj_t *obj, int32_t x, int32_t y);
+void lv_image_set_scale(lv_obj_t *obj, uint32_t zoom);
+void lv_image_cache_drop(const void *src);
+lv_obj_t *lv_canvas_create(lv_obj_t *parent);
+void lv_canvas_set_draw_buf(lv_obj_t *obj, lv_draw_buf_t *draw_buf);
+lv_draw_buf_t *lv_canvas_get_draw_buf(lv_obj_t *obj);
+void lv_canvas_fill_bg(lv_obj_t *obj, lv_color_t color, lv_opa_t opa);
+void lv_canvas_init_layer(lv_obj_t *canvas, lv_layer_t *layer);
+void lv_canvas_finish_layer(lv_obj_t *canvas, lv_layer_t *layer);
+uint32_t lv_draw_buf_width_to_stride(uint32_t w, lv_color_format_t color_format);
+lv_result_t lv_draw_buf_init(lv_draw_buf_t *draw_buf, uint32_t w, uint32_t h, lv_color_format_t cf, uint32_t stride,
+                             void *data, uint32_t data_size);
+void lv_draw_line_dsc_init(lv_draw_line_dsc_t *dsc);
+void lv_draw_line(lv_layer_t *layer, const lv_draw_line_dsc_t *dsc);
+void lv_draw_arc_dsc_init(lv_draw_arc_dsc_t *dsc);
+void lv_draw_arc(lv_layer_t *layer, const lv_draw_arc_dsc_t *dsc);
+void lv_draw_label_dsc_init(lv_draw_label_dsc_t *dsc);
+void lv_draw_label(lv_layer_t *layer, const lv_draw_label_dsc_t *dsc, const lv_area_t *coords);
+
+// Timers, animations, ticks and input
+
+typedef struct lv_timer_t lv_timer_t;
+typedef void (*lv_timer_cb_t)(lv_timer_t *timer);
+
+struct lv_timer_t
+{
+    lv_timer_cb_t cb;
+    uint32_t period;
+    void *user_data;
+    bool paused;
+};
+
+lv_timer_t *lv_timer_create(lv_timer_cb_t timer_xcb, uint32_t period, void *user_data);
+void lv_timer_delete(lv_timer_t *timer);
+void lv_timer_pause(lv_timer_t *timer);
+void lv_timer_resume(lv_timer_t *timer);
+
+static inline void *lv_timer_get_user_data(lv_timer_t *timer)
+{
+    return timer->user_data;
+}
+
+typedef void (*lv_anim_exec_xcb_t)(void *var, int32_t value);
+typedef int32_t (*lv_anim_path_cb_t)(const void *anim);
+
+typedef struct
+{
+    void *var;
+    lv_anim_exec_xcb_t exec_cb;
+    lv_anim_path_cb_t path_cb;
+    int32_t start_value;
+    int32_t end_value;
+    uint32_t duration;
+} lv_anim_t;
+
+int32_t lv_anim_path_ease_in_out(const void *anim);
+void lv_anim_init(lv_anim_t *a);
+void lv_anim_set_var(lv_anim_t *a, void *var);
+void lv_anim_set_exec_cb(lv_anim_t *a, lv_anim_exec_xcb_t exec_cb);
+void lv_anim_set_path_cb(lv_anim_t *a, lv_anim_path_cb_t path_cb);
+void lv_anim_set_values(lv_anim_t *a, int32_t start, int32_t end);
+void lv_anim_set_duration(lv_anim_t *a, uint32_t duration);
+void lv_anim_start(const lv_anim_t *a);
+bool lv_anim_delete(void *var, lv_anim_exec_xcb_t exec_cb);
+
+uint32_t lv_tick_get(void);
+uint32_t lv_tick_elaps(uint32_t prev_tick);
+
+typedef struct
+{
+    lv_point_t point;
+} lv_indev_t;
+
+typedef struct
+{
+    uint32_t unused;
+} lv_display_t;
+
+lv_indev_t *lv_indev_active(void);
+void lv_indev_get_point(const lv_indev_t *indev, lv_point_t *point);
+
+// Host-only controls and records of the fake
+
+#define LV_FAKE_MAX_INVALID 256
+
+/**
+ * @brief Areas invalidated since the last lv_fake_invalid_reset(), screen coordinates
+ */
+typedef struct
+{
+    lv_area_t areas[LV_FAKE_MAX_INVALID];
+    uint32_t count;
+    uint32_t dropped; // Invalidations beyond LV_FAKE_MAX_INVALID
+} lv_fake_invalid_t;
+
+extern lv_fake_invalid_t lv_fake_invalid;
+
+void lv_fake_invalid_reset(void);
+void lv_fake_tick_set(uint32_t tick);
+void lv_fake_press(lv_obj_t *obj, lv_event_code_t code, int32_t x, int32_t y);
@@ -0,0 +1,30 @@
+// multi_heap.h - host shim for the unit tests in test/host
+//
+// A first-fit allocator with coalescing that lives entirely inside the
+// registered region, so arena exhaustion, fragmentation and high-water
+// behave like a real fixed-size heap.
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct multi_heap_info *multi_heap_handle_t;
+
+typedef struct
+{
+    size_t total_free_bytes;
+    size_t total_allocated_bytes;
+    size_t largest_free_block;
+    size_t minimum_free_bytes;
+    size_t allocated_blocks;
+    size_t free_blocks;
+    size_t total_blocks;
+} multi_heap_info_t;
+
+multi_heap_handle_t multi_heap_register(void *start, size_t size);
+void *multi_heap_malloc(multi_heap_handle_t heap, size_t size);
+void *multi_heap_realloc(multi_heap_handle_t heap, void *p, size_t size);
+void multi_heap_free(multi_heap_handle_t heap, void *p);
+size_t multi_heap_get_allocated_size(multi_heap_handle_t heap, void *p);
+void multi_heap_get_info(multi_heap_handle_t heap, multi_heap_info_t *info);
+bool multi_heap_check(multi_heap_handle_t heap, bool print_errors);
@@ -0,0 +1,135 @@
+// multi_heap_host.c - see multi_heap.h
+#include <stdint.h>
+#include <string.h>
+#include "multi_heap.h"
+
+#define ALIGN 8
+
+typedef struct block
+{
+    size_t size;        // Payload bytes
+    struct block *next; // Next block in address order
+    bool used;
+} block_t;
+
+struct multi_heap_info
+{
+    block_t *first;
+    size_t free_bytes;
+    size_t min_free;
+};
+
+static size_t round_up(size_t v)
+{
+    return (v + ALIGN - 1) & ~(size_t)(ALIGN - 1);
+}
+
+multi_heap_handle_t multi_heap_register(void *start, size_t size)
+{
+    uintptr_t p = round_up((uintptr_t)start);
+    uintptr_t end = (uintptr_t)start + size;
+    struct multi_heap_info *heap = (struct multi_heap_info *)p;
+    block_t *b = (block_t *)round_up(p + sizeof(*heap));
+
+    if ((uintptr_t)(b + 1) >= end) {
+        return NULL;
+    }
+    b->size = (end - (uintptr_t)(b + 1)) & ~(size_t)(ALIGN - 1);
+    b->next = NULL;
+    b->used = false;
+    heap->first = b;
+    heap->free_bytes = b->size;
+    heap->min_free = b->size;
+    return heap;
+}
+
+void *multi_heap_malloc(multi_heap_handle_t heap, size_t size)
+{
+    size = round_up(size ? size : 1);
+    for (block_t *b = heap->first; b != NULL; b = b->next) {
+        if (b->used || b->size < size) {
+            continue;
+        }
+        if (b->size >= size + sizeof(block_t) + ALIGN) {
+            block_t *rest = (block_t *)((uint8_t *)(b + 1) + size);
+            rest->size = b->size - size - sizeof(block_t);
+            rest->next = b->next;
+            rest->used = false;
+            b->next = rest;
+            b->size = size;
+            heap->free_bytes -= sizeof(block_t);
+        }
+        b->used = true;
+        heap->free_bytes -= b->size;
+        heap->min_free = heap->free_bytes < heap->min_free ? heap->free_bytes : heap->min_free;
+        return b + 1;
+    }
+    return NULL;
+}
+
+void multi_heap_free(multi_heap_handle_t heap, void *p)
+{
+    if (p == NULL) {
+        return;
+    }
+    block_t *b = (block_t *)p - 1;
+    b->used = false;
+    heap->free_bytes += b->size;
+
+    // Coalesce every run of free blocks
+    for (block_t *c = heap->first; c != NULL; c = c->next) {
+        while (!c->used && c->next != NULL && !c->next->used) {
+            c->size += sizeof(block_t) + c->next->size;
+            c->next = c->next->next;
+            heap->free_bytes += sizeof(block_t);
+        }
+    }
+}
+
+size_t multi_heap_get_allocated_size(multi_heap_handle_t heap, void *p)
+{
+    (void)heap;
+    return ((block_t *)p - 1)->size;
+}
+
+void *multi_heap_realloc(multi_heap_handle_t heap, void *p, size_t size)
+{
+    size_t old = multi_heap_get_allocated_size(heap, p);
+    if (round_up(size) <= old) {
+        return p;
+    }
+    void *q = multi_heap_malloc(heap, size);
+    if (q != NULL) {
+        memcpy(q, p, old);
+        multi_heap_free(heap, p);
+    }
+    return q;
+}
+
+void multi_heap_get_info(multi_heap_handle_t heap, multi_heap_info_t *info)
+{
+    memset(info, 0, sizeof(*info));
+    for (block_t *b = heap->first; b != NULL; b = b->next) {
+        info->total_blocks++;
+        if (b->used) {
+            info->allocated_blocks++;
+            info->total_allocated_bytes += b->size;
+        } else {
+            info->free_blocks++;
+            info->total_free_bytes += b->size;
+            info->largest_free_block = b->size > info->largest_free_block ? b->size : info->largest_free_block;
+        }
+    }
+    info->minimum_free_bytes = heap->min_free;
+}
+
+bool multi_heap_check(multi_heap_handle_t heap, bool print_errors)
+{
+    (void)print_errors;
+    for (block_t *b = heap->first; b != NULL; b = b->next) {
+        if (b->next != NULL && (uint8_t *)b->next != (uint8_t *)(b + 1) + b->size) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,374 @@
+/*
+ * test_fusion_replay.c
+ * Replays RD-03D streams through the real sensor_fusion.c: every frame is
+ * moved into the room with skn_fusion_to_room() and the sensors are fused
+ * with skn_fusion_merge(), both timed.
+ *
+ * Without arguments, walkers pace a room seen by two modules in opposite
+ * corners angled in by 45 degrees (with sensor noise). The test checks that
+ * every walker seen by two sensors comes out once, near where it really is,
+ * that two people close together in front of one sensor stay two, and that
+ * the gate comparisons per sensor stay flat from 1 to 16 sensors (counted,
+ * the timings are only printed).
+ *
+ * With arguments, raw UART captures (e.g. `cat /dev/ttyUSB0 > left.bin` at
+ * 256000 baud) are replayed with the pose each module was mounted at, and
+ * only the statistics are printed:
+ *
+ *   test_fusion_replay left.bin -2000,0,-45 right.bin 2000,0,45
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sensor_fusion.h"
+
+#define REPLAY_RATE_HZ    10
+#define REPLAY_SECONDS    120
+#define REPLAY_FRAMES     (REPLAY_RATE_HZ * REPLAY_SECONDS)
+#define REPLAY_WALKERS    2
+#define REPLAY_FOV_DEG    60
+#define REPLAY_NOISE_MM   25
+#define REPLAY_TRUTH_MM   150 // Fused target to real walker, noise and Q14 rounding included
+#define REPLAY_MAX_SCALE  16
+#define REPLAY_REPORT_SZ  30
+#define REPLAY_PAIR_MM    200 // Two people standing this close, well inside one gate
+
+typedef struct
+{
+    double x_mm;
+    double y_mm;
+    double speed_mms;
+} walker_t;
+
+typedef struct
+{
+    skn_sensor_pose_t pose;
+    double x_mm, y_mm, yaw_deg;
+    skn_target_frame_t *frames; // Sensor frame, as parsed from the UART
+    uint32_t frame_count;
+} replay_sensor_t;
+
+static int failures = 0;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Same paths as tools/rd03d_simulator.py walkers()
+static void walkers_at(double t, walker_t *w)
+{
+    for (int i = 0; i < REPLAY_WALKERS; i++) {
+        double rate = 0.35 + 0.1 * i;
+        double phase = t * rate + i * 2.1;
+        w[i].x_mm = 1800.0 * sin(phase);
+        w[i].y_mm = 2500.0 + 1200.0 * i + 900.0 * cos(phase);
+        w[i].speed_mms = -900.0 * sin(phase) * rate * cos(phase);
+    }
+}
+
+static int16_t noise_mm(void)
+{
+    return (int16_t)(rand() % (2 * REPLAY_NOISE_MM + 1) - REPLAY_NOISE_MM);
+}
+
+/**
+ * @brief What a module at pose reports: walkers inside its field of view
+ *
+ * @return Bit mask of the walkers it saw
+ */
+static uint8_t sensor_view(const replay_sensor_t *sensor, const walker_t *w, skn_target_frame_t *frame)
+{
+    double yaw = sensor->yaw_deg * M_PI / 180.0;
+    double c = cos(yaw), s = sin(yaw);
+    uint8_t seen = 0;
+
+    frame->count = 0;
+    for (int i = 0; i < REPLAY_WALKERS && frame->count < SKN_MAX_TARGETS; i++) {
+        double dx = w[i].x_mm - sensor->x_mm, dy = w[i].y_mm - sensor->y_mm;
+        double sx = c * dx + s * dy, sy = -s * dx + c * dy;
+        if (sy <= 0 || fabs(atan2(sx, sy)) > REPLAY_FOV_DEG * M_PI / 180.0 || hypot(sx, sy) > 8000) {
+            continue;
+        }
+        skn_target_t *t = &frame->targets[frame->count++];
+        t->x_mm = (int16_t)lround(sx) + noise_mm();
+        t->y_mm = (int16_t)lround(sy) + noise_mm();
+        t->speed_mms = (int16_t)lround(w[i].speed_mms);
+        t->distance_mm = (uint16_t)lround(hypot(t->x_mm, t->y_mm));
+        seen |= 1 << i;
+    }
+    return seen;
+}
+
+static int16_t report_decode(const uint8_t *p)
+{
+    uint16_t v = p[0] | (p[1] << 8);
+    return (v & 0x8000) ? (int16_t)(v & 0x7FFF) : -(int16_t)(v & 0x7FFF);
+}
+
+/**
+ * @brief Split a UART capture into sensor frames, resynchronising on the header
+ */
+static uint32_t capture_parse(const uint8_t *data, size_t len, skn_target_frame_t *frames, uint32_t max)
+{
+    static const uint8_t head[4] = {0xAA, 0xFF, 0x03, 0x00};
+    static const uint8_t tail[2] = {0x55, 0xCC};
+    uint32_t count = 0;
+
+    for (size_t pos = 0; pos + REPLAY_REPORT_SZ <= len && count < max; pos++) {
+        const uint8_t *r = &data[pos];
+        if (memcmp(r, head, sizeof(head)) != 0 || memcmp(r + 28, tail, sizeof(tail)) != 0) {
+            continue;
+        }
+        skn_target_frame_t *frame = &frames[count];
+        frame->count = 0;
+        for (int i = 0; i < 3; i++) {
+            const uint8_t *t = r + 4 + 8 * i;
+            if ((t[0] | t[1] | t[2] | t[3]) == 0) {
+                continue;
+            }
+            skn_target_t *target = &frame->targets[frame->count++];
+            target->x_mm = report_decode(t);
+            target->y_mm = report_decode(t + 2);
+            target->speed_mms = report_decode(t + 4) * 10;
+            target->distance_mm = t[6] | (t[7] << 8);
+        }
+        count++;
+        pos += REPLAY_REPORT_SZ - 1;
+    }
+    return count;
+}
+
+static bool capture_load(replay_sensor_t *sensor, const char *path, const char *pose)
+{
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL || sscanf(pose, "%lf,%lf,%lf", &sensor->x_mm, &sensor->y_mm, &sensor->yaw_deg) != 3) {
+        fprintf(stderr, "Unable to use %s at pose %s\n", path, pose);
+        if (fp) fclose(fp);
+        return false;
+    }
+    fseek(fp, 0, SEEK_END);
+    size_t len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint8_t *data = malloc(len);
+    len = fread(data, 1, len, fp);
+    fclose(fp);
+
+    uint32_t max = len / REPLAY_REPORT_SZ + 1;
+    sensor->frames = calloc(max, sizeof(skn_target_frame_t));
+    sensor->frame_count = capture_parse(data, len, sensor->frames, max);
+    free(data);
+    return true;
+}
+
+/**
+ * @brief Fuse every frame: transform and merge cost per frame in ns
+ *
+ * @param repeat Number of passes, so short streams still time reliably
+ * @return Gate comparisons per frame
+ */
+static double replay_fuse(replay_sensor_t *sensors, uint8_t count, uint32_t frames, int repeat, double *to_room_ns,
+                          double *merge_ns, skn_target_frame_t *fused)
+{
+    skn_target_frame_t *room = malloc((size_t)frames * count * sizeof(skn_target_frame_t));
+    double t_room = 0, t_merge = 0;
+    uint64_t compares = 0;
+
+    for (int r = 0; r < repeat; r++) {
+        for (uint32_t k = 0; k < frames; k++) {
+            for (uint8_t s = 0; s < count; s++) {
+                skn_target_frame_t *frame = &room[k * count + s];
+                *frame = sensors[s].frames[k];
+                frame->seq = k + 1;
+                frame->timestamp_us = (int64_t)k * 1000000 / REPLAY_RATE_HZ;
+            }
+        }
+
+        double t0 = now_ns();
+        for (uint32_t k = 0; k < frames; k++) {
+            for (uint8_t s = 0; s < count; s++) {
+                skn_fusion_to_room(&sensors[s].pose, &room[k * count + s]);
+            }
+        }
+        double t1 = now_ns();
+        for (uint32_t k = 0; k < frames; k++) {
+            compares += skn_fusion_merge(&room[k * count], count, room[k * count].timestamp_us, &fused[k]);
+        }
+        t_merge += now_ns() - t1;
+        t_room += t1 - t0;
+    }
+    free(room);
+    *to_room_ns = t_room / ((double)repeat * frames);
+    *merge_ns = t_merge / ((double)repeat * frames);
+    return (double)compares / ((double)repeat * frames);
+}
+
+/**
+ * @brief Two people a step apart in front of one sensor stay two targets
+ *
+ * Alone, and with a second sensor seeing the same pair: each sighting of the
+ * second sensor must go to its own person, never fold the pair into one.
+ */
+static void check_close_pair(void)
+{
+    skn_target_frame_t frames[2] = {0}, fused;
+    const int16_t x[2] = {-REPLAY_PAIR_MM / 2, REPLAY_PAIR_MM / 2};
+
+    for (int s = 0; s < 2; s++) {
+        frames[s].seq = 1;
+        frames[s].timestamp_us = 1000;
+        frames[s].count = 2;
+        for (int i = 0; i < 2; i++) {
+            skn_target_t *t = &frames[s].targets[i];
+            t->x_mm = x[i] + (s ? 30 : 0);
+            t->y_mm = 2000 + (s ? -20 : 0);
+            t->distance_mm = (uint16_t)lround(hypot(t->x_mm, t->y_mm));
+        }
+    }
+
+    for (uint8_t count = 1; count <= 2; count++) {
+        skn_fusion_merge(frames, count, 1000, &fused);
+        bool apart = fused.count == 2 && abs(fused.targets[0].x_mm - x[0]) < REPLAY_PAIR_MM / 2 &&
+                     abs(fused.targets[1].x_mm - x[1]) < REPLAY_PAIR_MM / 2;
+        printf("%u sensor(s), pair %u mm apart: %u fused targets\n", count, REPLAY_PAIR_MM, fused.count);
+        if (!apart) {
+            printf("FAIL %u sensor(s): the pair was merged or mixed up\n", count);
+            failures++;
+        }
+    }
+}
+
+static int replay_captures(int argc, char **argv)
+{
+    replay_sensor_t sensors[REPLAY_MAX_SCALE] = {0};
+    uint8_t count = 0;
+    uint32_t frames = UINT32_MAX;
+
+    for (int i = 1; i + 1 < argc && count < REPLAY_MAX_SCALE; i += 2, count++) {
+        if (!capture_load(&sensors[count], argv[i], argv[i + 1])) {
+            return 1;
+        }
+        skn_fusion_pose_init(&sensors[count].pose, sensors[count].x_mm, sensors[count].y_mm, sensors[count].yaw_deg);
+        frames = sensors[count].frame_count < frames ? sensors[count].frame_count : frames;
+    }
+    if (count == 0 || frames == 0) {
+        fprintf(stderr, "No reports found\n");
+        return 1;
+    }
+
+    skn_target_frame_t *fused = calloc(frames, sizeof(skn_target_frame_t));
+    double to_room_ns, merge_ns;
+    replay_fuse(sensors, count, frames, 1, &to_room_ns, &merge_ns, fused);
+
+    uint32_t sightings = 0, targets = 0;
+    for (uint32_t k = 0; k < frames; k++) {
+        for (uint8_t s = 0; s < count; s++) {
+            sightings += sensors[s].frames[k].count;
+        }
+        targets += fused[k].count;
+    }
+    printf("%u sensors, %u frames: to_room %.0f ns/frame, merge %.0f ns/frame, %.2f targets/frame, "
+           "%u sightings merged\n", count, frames, to_room_ns, merge_ns, (double)targets / frames, sightings - targets);
+    return 0;
+}
+
+static int replay_synthetic(void)
+{
+    static const double poses[2][3] = {{-2000, 0, -45}, {2000, 0, 45}};
+    static walker_t truth[REPLAY_FRAMES][REPLAY_WALKERS];
+    static uint8_t visible[REPLAY_FRAMES];
+    static skn_target_frame_t fused[REPLAY_FRAMES];
+    replay_sensor_t sensors[REPLAY_MAX_SCALE] = {0};
+    uint32_t both = 0, merged = 0, worst_mm = 0;
+
+    srand(1);
+    for (int s = 0; s < REPLAY_MAX_SCALE; s++) {
+        sensors[s].x_mm = poses[s % 2][0];
+        sensors[s].y_mm = poses[s % 2][1];
+        sensors[s].yaw_deg = poses[s % 2][2];
+        sensors[s].frames = calloc(REPLAY_FRAMES, sizeof(skn_target_frame_t));
+        skn_fusion_pose_init(&sensors[s].pose, sensors[s].x_mm, sensors[s].y_mm, sensors[s].yaw_deg);
+    }
+    for (uint32_t k = 0; k < REPLAY_FRAMES; k++) {
+        walkers_at((double)k / REPLAY_RATE_HZ, truth[k]);
+        uint8_t seen[REPLAY_MAX_SCALE];
+        for (int s = 0; s < REPLAY_MAX_SCALE; s++) {
+            seen[s] = sensor_view(&sensors[s], truth[k], &sensors[s].frames[k]);
+        }
+        visible[k] = seen[0] | seen[1];
+        for (int i = 0; i < REPLAY_WALKERS; i++) {
+            both += (seen[0] & seen[1] & (1 << i)) != 0;
+        }
+    }
+
+    // Two real sensors: every visible walker exactly once, close to the truth,
+    // also while the walkers pass within a gate of each other
+    double to_room_ns, merge_ns;
+    replay_fuse(sensors, 2, REPLAY_FRAMES, 1, &to_room_ns, &merge_ns, fused);
+    for (uint32_t k = 0; k < REPLAY_FRAMES; k++) {
+        const walker_t *w = truth[k];
+        uint8_t want = __builtin_popcount(visible[k]);
+        if (fused[k].count != want) {
+            printf("FAIL frame %u: %u fused targets for %u visible walkers\n", k, fused[k].count, want);
+            failures++;
+            continue;
+        }
+        merged += sensors[0].frames[k].count + sensors[1].frames[k].count - fused[k].count;
+        for (int i = 0; i < REPLAY_WALKERS; i++) {
+            if (!(visible[k] & (1 << i))) {
+                continue;
+            }
+            uint32_t best = UINT32_MAX;
+            for (uint8_t j = 0; j < fused[k].count; j++) {
+                uint32_t d = (uint32_t)lround(hypot(fused[k].targets[j].x_mm - w[i].x_mm,
+                                                    fused[k].targets[j].y_mm - w[i].y_mm));
+                best = d < best ? d : best;
+            }
+            worst_mm = best > worst_mm ? best : worst_mm;
+            if (best > REPLAY_TRUTH_MM) {
+                printf("FAIL frame %u: walker %d fused %u mm from where it is\n", k, i, best);
+                failures++;
+            }
+        }
+    }
+    printf("2 sensors, %u frames: %u sightings by both sensors, %u merged, worst %u mm off\n",
+           REPLAY_FRAMES, both, merged, worst_mm);
+    if (both == 0 || merged == 0) {
+        printf("FAIL the sensors never overlapped\n");
+        failures++;
+    }
+
+    check_close_pair();
+
+    // Scaling: every sighting is compared with at most SKN_MAX_TARGETS fused
+    // targets, whatever the sensor count; timings are for information only
+    for (uint8_t count = 1; count <= REPLAY_MAX_SCALE; count *= 2) {
+        double best = INFINITY, compares = 0;
+        for (int run = 0; run < 5; run++) {
+            compares = replay_fuse(sensors, count, REPLAY_FRAMES, 20, &to_room_ns, &merge_ns, fused);
+            best = fmin(best, (to_room_ns + merge_ns) / count);
+        }
+        printf("%2u sensors: %.2f gate compares and %.1f ns per sensor frame (to_room + merge)\n", count,
+               compares / count, best);
+        if (compares / count > SKN_MAX_TARGETS * SKN_MAX_TARGETS) {
+            printf("FAIL gate compares per sensor grow with the sensor count\n");
+            failures++;
+        }
+    }
+
+    for (int s = 0; s < REPLAY_MAX_SCALE; s++) {
+        free(sensors[s].frames);
+    }
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    return argc > 1 ? replay_captures(argc, argv) : replay_synthetic();
+}
@@ -0,0 +1,271 @@
+/*
+ * test_lv_mem_soak.c
+ * Soak test for the LVGL arenas in main/lv_mem_skn.c.
+ *
+ * The allocation pattern comes from the real radar_panel.c and zone_editor.c
+ * running on the LVGL fake, whose objects, child lists, event lists and
+ * timers are allocated through lv_malloc() like LVGL's own:
+ *
+ * - a resident radar screen is built step by step through
+ *   lv_radar_panel_build(), exactly as the screen manager does;
+ * - every cycle a second radar screen with zones and sweep is built and
+ *   deleted again, standing in for the non-resident intro screen;
+ * - every frame walking targets are pushed through lv_radar_set_targets(),
+ *   the sweep steps, and each visible object in an invalidated area gets a
+ *   short-lived draw task, plus layer buffers through the draw-buffer
+ *   handler;
+ * - every few cycles the zone editor is opened, a vertex dragged and the
+ *   editor closed.
+ *
+ * After every cycle both arenas must be back at their baseline: no leak, no
+ * fragmentation growth, and nothing left in the internal arena.
+ *
+ * Not covered: the arenas run on the first-fit multi_heap stand-in in
+ * shim/multi_heap_host.c, not ESP-IDF's TLSF, so fragmentation figures are
+ * those of first fit. Object and draw task sizes are the fake's and
+ * SOAK_DRAW_TASK_SZ, not LVGL's; styles, fonts and the image decoder
+ * allocate nothing here.
+ *
+ * SKN_SOAK_SECONDS=<n> runs for n seconds instead of the default cycle count,
+ * e.g. SKN_SOAK_SECONDS=14400 for a four hour soak.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "lvgl.h"
+#include "lv_mem_skn.h"
+#include "radar_panel.h"
+#include "radar_stubs.h"
+
+#define SOAK_CYCLES        2000
+#define SOAK_FRAMES        8
+#define SOAK_LAYERS        2
+#define SOAK_EDIT_EVERY    25 // Cycles between zone editor sessions
+#define SOAK_SCREEN_W      480
+#define SOAK_SCREEN_H      320
+#define SOAK_DRAW_TASK_SZ  160 // One draw task with its descriptor
+#define SOAK_MAX_TASKS     256
+
+static lv_draw_buf_handlers_t handlers;
+static void *tasks[SOAK_MAX_TASKS];
+static uint32_t task_count;
+
+lv_draw_buf_handlers_t *lv_draw_buf_get_handlers(void)
+{
+    return &handlers;
+}
+
+static size_t pick(size_t lo, size_t hi)
+{
+    return lo + (size_t)rand() % (hi - lo + 1);
+}
+
+static void shuffle(void **p, size_t n)
+{
+    for (size_t i = n - 1; i > 0; i--) {
+        size_t j = (size_t)rand() % (i + 1);
+        void *t = p[i];
+        p[i] = p[j];
+        p[j] = t;
+    }
+}
+
+static int fail(const char *what, unsigned long cycle)
+{
+    fprintf(stderr, "FAIL after %lu cycles: %s\n", cycle, what);
+    return 1;
+}
+
+static bool areas_overlap(const lv_area_t *a, const lv_area_t *b)
+{
+    return a->x1 <= b->x2 && b->x1 <= a->x2 && a->y1 <= b->y2 && b->y1 <= a->y2;
+}
+
+/**
+ * @brief Queue a draw task for every visible object an invalidated area touches
+ *
+ * @return false when a task could not be allocated
+ */
+static bool draw_tasks_create(const lv_obj_t *obj)
+{
+    lv_area_t coords;
+
+    if (lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN)) {
+        return true;
+    }
+    lv_obj_get_coords(obj, &coords);
+    for (uint32_t i = 0; i < lv_fake_invalid.count && task_count < SOAK_MAX_TASKS; i++) {
+        if (areas_overlap(&coords, &lv_fake_invalid.areas[i])) {
+            tasks[task_count] = lv_malloc(SOAK_DRAW_TASK_SZ);
+            if (tasks[task_count++] == NULL) {
+                return false;
+            }
+            break;
+        }
+    }
+    for (uint32_t i = 0; i < obj->child_count; i++) {
+        if (!draw_tasks_create(obj->children[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief A walker per target slot, some of them away from the field
+ */
+static void walk(skn_target_frame_t *frame, uint32_t n)
+{
+    frame->seq = n;
+    frame->timestamp_us = (int64_t)n * 100000;
+    frame->count = 0;
+    for (uint8_t i = 0; i < SKN_MAX_TARGETS; i++) {
+        if ((n / 40 + i) % 4 == 3) {
+            continue;
+        }
+        skn_target_t *t = &frame->targets[frame->count++];
+        t->x_mm = (int16_t)(((int32_t)(n * (7 + 3 * i)) % 4000) - 2000);
+        t->y_mm = (int16_t)(500 + (n * (5 + i) + 1000 * i) % 5000);
+        t->speed_mms = (int16_t)(i * 250);
+        t->distance_mm = (uint16_t)t->y_mm;
+    }
+}
+
+static lv_obj_t *screen_create(void)
+{
+    lv_obj_t *scr = lv_obj_create(NULL);
+    lv_obj_set_size(scr, SOAK_SCREEN_W, SOAK_SCREEN_H);
+    return scr;
+}
+
+/**
+ * @brief Long press into edit mode, drag the first visible handle, leave again
+ */
+static void edit_session(lv_obj_t *radar)
+{
+    lv_fake_press(radar, LV_EVENT_LONG_PRESSED, 0, 0);
+    for (uint32_t i = 0; i < lv_obj_get_child_count(radar); i++) {
+        lv_obj_t *handle = radar->children[i];
+        if (handle->class_p == &lv_obj_class && !lv_obj_has_flag(handle, LV_OBJ_FLAG_HIDDEN)) {
+            lv_area_t a;
+            lv_obj_get_coords(handle, &a);
+            for (int32_t step = 1; step <= 10; step++) {
+                lv_fake_press(handle, LV_EVENT_PRESSING, a.x1 + step, a.y1 - step);
+            }
+            lv_fake_press(handle, LV_EVENT_RELEASED, 0, 0);
+            break;
+        }
+    }
+    lv_fake_press(radar, LV_EVENT_LONG_PRESSED, 0, 0);
+}
+
+int main(void)
+{
+    const skn_zone_t zone = {
+        .vertex_count = 4,
+        .sensitivity = 5,
+        .name = "Zone 1",
+        .vertices = {{-800, 1000}, {800, 1000}, {800, 2500}, {-800, 2500}},
+    };
+    const char *env = getenv("SKN_SOAK_SECONDS");
+    time_t deadline = env ? time(NULL) + atol(env) : 0;
+    void *layers[SOAK_LAYERS];
+    skn_lv_arena_stats_t psram0, internal0, psram, internal;
+    skn_target_frame_t frame;
+
+    srand(1);
+    lv_mem_init();
+    handlers.buf_malloc_cb = NULL;
+    handlers.buf_free_cb = lv_free_core;
+    skn_lv_mem_init_draw_bufs();
+    if (handlers.buf_malloc_cb == NULL) {
+        return fail("draw-buffer handler not installed", 0);
+    }
+
+    // The resident screen, built like the screen manager does
+    stub_zone_put(0, &zone);
+    lv_obj_t *home = screen_create();
+    for (uint8_t step = 0; !lv_radar_panel_build(home, step); step++) {
+    }
+    lv_obj_t *radar = lv_obj_get_child_by_type(home, 0, &lv_radar_class);
+    lv_radar_sweep_t *sweep = lv_radar_sweep_create(radar, 4000, true);
+    if (radar == NULL || sweep == NULL) {
+        return fail("resident radar screen not built", 0);
+    }
+    // One editor session first: the editor's own state is resident from then on
+    edit_session(radar);
+
+    skn_lv_mem_get_stats(SKN_LV_ARENA_PSRAM, &psram0);
+    skn_lv_mem_get_stats(SKN_LV_ARENA_INTERNAL, &internal0);
+    if (internal0.free != internal0.total) {
+        return fail("lv_malloc() served from the internal arena", 0);
+    }
+
+    unsigned long cycle = 0, internal_frames = 0, draw_tasks = 0;
+    uint32_t n = 0;
+    while (deadline ? time(NULL) < deadline : cycle < SOAK_CYCLES) {
+        // Build the transient screen
+        lv_obj_t *scr = screen_create();
+        lv_obj_t *other = lv_radar_screen_create(scr, SOAK_SCREEN_W, SOAK_SCREEN_H);
+        lv_radar_zones_draw(other);
+        if (lv_radar_sweep_create(other, 4000, true) == NULL) return fail("sweep allocation failed", cycle);
+
+        // Render: markers and sweep move, every touched object gets a draw task
+        for (int f = 0; f < SOAK_FRAMES; f++, n++) {
+            lv_fake_invalid_reset();
+            walk(&frame, n);
+            lv_radar_set_targets(radar, &frame);
+            lv_radar_sweep_update(sweep, (uint16_t)(n % 181));
+
+            task_count = 0;
+            if (!draw_tasks_create(home)) return fail("draw task allocation failed", cycle);
+            for (int i = 0; i < SOAK_LAYERS; i++) {
+                layers[i] = handlers.buf_malloc_cb(pick(1024, 20480), 0);
+                if (layers[i] == NULL) return fail("layer allocation failed", cycle);
+            }
+            skn_lv_mem_get_stats(SKN_LV_ARENA_INTERNAL, &internal);
+            internal_frames += internal.free != internal.total;
+            draw_tasks += task_count;
+
+            // Draw units finish tasks in any order; layers go with their frame
+            shuffle(tasks, task_count);
+            for (uint32_t i = 0; i < task_count; i++) {
+                lv_free(tasks[i]);
+            }
+            for (int i = 0; i < SOAK_LAYERS; i++) {
+                handlers.buf_free_cb(layers[i]);
+            }
+        }
+        if (cycle % SOAK_EDIT_EVERY == 0) {
+            edit_session(radar);
+        }
+
+        lv_obj_delete(scr);
+        cycle++;
+
+        skn_lv_mem_get_stats(SKN_LV_ARENA_PSRAM, &psram);
+        skn_lv_mem_get_stats(SKN_LV_ARENA_INTERNAL, &internal);
+        if (psram.free != psram0.free) return fail("PSRAM arena grew", cycle);
+        if (psram.largest_free < psram0.largest_free) return fail("PSRAM arena fragmentation grew", cycle);
+        if (internal.free != internal0.free) return fail("internal arena pinned after the frame", cycle);
+        if (lv_mem_test_core() != LV_RESULT_OK) return fail("arena corrupted", cycle);
+    }
+
+    if (internal_frames == 0) {
+        return fail("layers never used the internal arena", cycle);
+    }
+    if (draw_tasks == 0) {
+        return fail("frames never drew anything", cycle);
+    }
+    lv_obj_delete(home);
+    skn_lv_mem_get_stats(SKN_LV_ARENA_PSRAM, &psram);
+    if (psram.free != psram.total) {
+        return fail("resident screen leaked", cycle);
+    }
+    printf("lv_mem soak: %lu cycles, %lu draw tasks, %lu frames with internal layers, psram high-water %zu/%zu, "
+           "internal high-water %zu/%zu, %u fallbacks\n", cycle, draw_tasks, internal_frames, psram.high_water,
+           psram.total, internal.high_water, internal.total, (unsigned)internal.fallbacks);
+    lv_mem_deinit();
+    return 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * test_presence_replay.c
+ * Replays a scripted walk through the whole-field zone into the real
+ * skn_presence_process() and checks the exact ENTER/EXIT/DWELL/APPROACH
+ * sequence, including enter debounce, boundary hysteresis, approach re-arm
+ * and a dropout shorter than the exit hold.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "presence.h"
+#include "target_stream.h"
+
+#define FRAME_MS 100
+
+typedef struct
+{
+    uint8_t frames;
+    uint16_t distance_mm[2]; // 0 = no target in that slot
+} script_step_t;
+
+typedef struct
+{
+    uint8_t type;
+    uint32_t at_ms;
+    uint8_t slot;
+    uint32_t duration_ms;
+} expected_event_t;
+
+static skn_presence_event_t events[32];
+static int event_count = 0;
+
+// Stands in for target_stream.c: capture what presence.c publishes
+void skn_stream_submit_event(const skn_presence_event_t *event)
+{
+    if (event_count < (int)(sizeof(events) / sizeof(events[0]))) {
+        events[event_count] = *event;
+    }
+    event_count++;
+}
+
+static const script_step_t script[] = {
+    {1, {2500, 0}},    // t=0      first sighting
+    {1, {0, 0}},       // t=100    flicker resets the debounce
+    {3, {2500, 0}},    // t=200    ENTER on the third consecutive frame, t=400
+    {5, {3100, 0}},    // t=500    beyond range but inside the hysteresis band
+    {5, {2500, 700}},  // t=1000   second target close: APPROACH by slot 1
+    {3, {950, 0}},     // t=1500   within approach hysteresis, stays armed off
+    {2, {1100, 0}},    // t=1800   moved out far enough to re-arm
+    {5, {700, 0}},     // t=2000   APPROACH again; DWELL at t=2400
+    {5, {0, 0}},       // t=2500   dropout shorter than the exit hold
+    {5, {2500, 0}},    // t=3000   back, no second ENTER
+    {15, {0, 0}},      // t=3500   gone: EXIT one hold after last seen, t=4400
+    {5, {3300, 0}},    // t=5000   outside the range of an empty zone
+};
+
+static const expected_event_t expected[] = {
+    {SKN_PRESENCE_ENTER, 400, 0, 0},
+    {SKN_PRESENCE_APPROACH, 1000, 1, 600},
+    {SKN_PRESENCE_APPROACH, 2000, 0, 1600},
+    {SKN_PRESENCE_DWELL, 2400, 0, 2000},
+    {SKN_PRESENCE_EXIT, 4400, 0, 3000},
+};
+
+int main(void)
+{
+    const skn_presence_zone_params_t params = {
+        .enter_frames = 3,
+        .exit_hold_ms = 1000,
+        .dwell_ms = 2000,
+        .approach_mm = 800,
+        .hysteresis_mm = 200,
+    };
+    skn_target_frame_t frame = {0};
+    int failures = 0;
+
+    skn_presence_init(NULL);
+    skn_presence_set_range_mm(3000);
+    skn_presence_set_zone_params(0, &params);
+
+    for (size_t s = 0; s < sizeof(script) / sizeof(script[0]); s++) {
+        for (uint8_t f = 0; f < script[s].frames; f++) {
+            frame.count = 0;
+            for (int t = 0; t < 2 && script[s].distance_mm[t]; t++) {
+                frame.targets[frame.count] = (skn_target_t){.y_mm = script[s].distance_mm[t],
+                                                            .distance_mm = script[s].distance_mm[t]};
+                frame.count++;
+            }
+            skn_presence_process(&frame);
+            frame.seq++;
+            frame.timestamp_us += FRAME_MS * 1000;
+        }
+    }
+
+    int want = sizeof(expected) / sizeof(expected[0]);
+    for (int i = 0; i < event_count || i < want; i++) {
+        const skn_presence_event_t *got = i < event_count ? &events[i] : NULL;
+        const expected_event_t *exp = i < want ? &expected[i] : NULL;
+        bool match = got && exp && got->type == exp->type && got->zone == 0 &&
+                     got->timestamp_us == (int64_t)exp->at_ms * 1000 && got->slot == exp->slot &&
+                     got->duration_ms == exp->duration_ms;
+        if (!match) {
+            failures++;
+        }
+        printf("%s event %d: got %s@%lld slot %d dur %d, want %s@%d slot %d dur %d\n", match ? "ok  " : "FAIL", i,
+               got ? skn_presence_event_name(got->type) : "-", got ? (long long)got->timestamp_us / 1000 : -1,
+               got ? got->slot : -1, got ? (int)got->duration_ms : -1, exp ? skn_presence_event_name(exp->type) : "-",
+               exp ? (int)exp->at_ms : -1, exp ? exp->slot : -1, exp ? (int)exp->duration_ms : -1);
+    }
+    if (skn_presence_occupied_mask() != 0) {
+        printf("FAIL zone still occupied after the replay\n");
+        failures++;
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,221 @@
+/*
+ * test_radar_geometry.c
+ * Checks the LVGL-free radar geometry in radar_geometry.h: the sweep trail
+ * clamp and the Q16 mm -> pixel transform. The sweep in radar_panel.c is then
+ * run against the LVGL fake to check what each of its lines was given.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "lvgl.h"
+#include "radar_geometry.h"
+#include "radar_panel.h"
+
+static int failures = 0;
+
+static void expect_trail(uint16_t angle, int8_t direction, uint8_t index, uint8_t step, uint16_t want)
+{
+    uint16_t got = skn_radar_trail_angle(angle, direction, index, step);
+    if (got != want) {
+        printf("FAIL trail(%u, %d, %u, %u) = %u, want %u\n", angle, direction, index, step, got, want);
+        failures++;
+    }
+}
+
+static void test_sweep_trail(void)
+{
+    // Sweeping left to right, shadows sit at smaller angles
+    expect_trail(90, 1, 0, 8, 82);
+    expect_trail(90, 1, 4, 8, 50);
+    // Playback, shadows sit at larger angles
+    expect_trail(90, -1, 0, 8, 98);
+    expect_trail(90, -1, 4, 8, 130);
+    // Clamped at the 0 degree edge while starting a forward pass
+    expect_trail(10, 1, 0, 8, 2);
+    expect_trail(10, 1, 1, 8, 0);
+    expect_trail(0, 1, 7, 30, 0);
+    // Clamped at the 180 degree edge while starting playback
+    expect_trail(175, -1, 0, 8, 180);
+    expect_trail(180, -1, 7, 30, 180);
+    // The edge the sweep moves towards never clamps its trail
+    expect_trail(180, 1, 0, 8, 172);
+    expect_trail(0, -1, 0, 8, 8);
+
+    // Every setting stays inside the half circle and steps away monotonically
+    for (int direction = -1; direction <= 1; direction += 2) {
+        for (uint16_t angle = 0; angle <= 180; angle++) {
+            for (uint8_t step = 1; step <= 30; step++) {
+                uint16_t prev = angle;
+                for (uint8_t i = 0; i < 8; i++) {
+                    uint16_t a = skn_radar_trail_angle(angle, direction, i, step);
+                    if (a > 180 || (direction > 0 ? a > prev : a < prev)) {
+                        printf("FAIL trail(%u, %d, %u, %u) = %u after %u\n", angle, direction, i, step, a, prev);
+                        failures++;
+                    }
+                    prev = a;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Q16 mm -> pixel transform against the float reference
+ *
+ * Sweeps every radius from 50 to 320 px over 2 to 8 m of range, both axes
+ * across the whole field; every result must be within 1 px of
+ * round(mm * radius / range).
+ */
+static void test_xform(void)
+{
+    int32_t worst = 0;
+    uint64_t points = 0, exact = 0;
+
+    for (uint32_t range = 2000; range <= 8000; range += 100) {
+        for (int32_t radius = 50; radius <= 320; radius++) {
+            int32_t k = skn_radar_px_per_mm_q16(radius, range);
+            for (int32_t mm = -(int32_t)range; mm <= (int32_t)range; mm += 7) {
+                int32_t got = skn_radar_mm_to_px(mm, k);
+                int32_t want = (int32_t)lround((double)mm * radius / range);
+                int32_t err = abs(got - want);
+                if (err > 1) {
+                    printf("FAIL xform %d mm at %u mm / %d px = %d px, want %d\n", mm, range, radius, got, want);
+                    failures++;
+                }
+                worst = err > worst ? err : worst;
+                exact += err == 0;
+                points++;
+            }
+            // The range edge lands on the outer band
+            if (abs(skn_radar_mm_to_px(range, k) - radius) > 1) {
+                printf("FAIL xform edge at %u mm / %d px\n", range, radius);
+                failures++;
+            }
+        }
+    }
+    printf("xform: %llu points, %.3f%% exact, worst %d px\n", (unsigned long long)points, 100.0 * exact / points,
+           worst);
+}
+
+/**
+ * @brief One sweep line: from the center to the circle at its angle
+ */
+static void expect_line(const lv_radar_sweep_t *sweep, const lv_obj_t *line, uint16_t angle, const char *what)
+{
+    int32_t x = sweep->center_x + ((sweep->radius * lv_trigo_cos(angle)) >> LV_TRIGO_SHIFT);
+    int32_t y = sweep->center_y - ((sweep->radius * lv_trigo_sin(angle)) >> LV_TRIGO_SHIFT);
+
+    if (line->point_count != 2 || line->points[0].x != sweep->center_x || line->points[0].y != sweep->center_y ||
+        line->points[1].x != x || line->points[1].y != y) {
+        printf("FAIL %s at sweep %u dir %d does not end at %u deg (%d,%d)\n", what, sweep->current_angle,
+               sweep->direction, angle, x, y);
+        failures++;
+    }
+}
+
+/**
+ * @brief Sweep state in radar_panel.c
+ *
+ * lv_line keeps the pointer it is given, so every shadow line needs its own
+ * point array; after each update every line must end at its own trail angle.
+ */
+static void test_sweep_lines(void)
+{
+    static const uint16_t angles[] = {0, 1, 45, 90, 178, 180, 120, 60, 3, 0};
+    lv_obj_t *scr = lv_obj_create(NULL);
+
+    lv_obj_set_size(scr, 480, 320);
+    lv_obj_t *radar = lv_radar_screen_create(scr, 480, 320);
+    lv_radar_sweep_t *sweep = lv_radar_sweep_create(radar, 1000, true);
+    if (sweep == NULL || sweep->radius <= 0 || sweep->trail_len != CONFIG_SKN_SWEEP_TRAIL_LEN) {
+        printf("FAIL sweep not created on a laid out radar\n");
+        failures++;
+        lv_obj_delete(scr);
+        return;
+    }
+
+    for (uint8_t i = 0; i < sweep->trail_len; i++) {
+        const lv_point_precise_t *points = sweep->shadow_lines[i]->points;
+        if (points != sweep->shadow_points[i] || points == sweep->sweep_line->points) {
+            printf("FAIL shadow line %u does not own its points\n", i);
+            failures++;
+        }
+        for (uint8_t j = 0; j < i; j++) {
+            if (sweep->shadow_lines[j]->points == points) {
+                printf("FAIL shadow lines %u and %u share points\n", j, i);
+                failures++;
+            }
+        }
+    }
+
+    for (size_t n = 0; n < sizeof(angles) / sizeof(angles[0]); n++) {
+        lv_radar_sweep_update(sweep, angles[n]);
+        expect_line(sweep, sweep->sweep_line, angles[n], "sweep line");
+        for (uint8_t i = 0; i < sweep->trail_len; i++) {
+            uint16_t want = skn_radar_trail_angle(angles[n], sweep->direction, i, CONFIG_SKN_SWEEP_TRAIL_STEP_DEG);
+            expect_line(sweep, sweep->shadow_lines[i], want, "shadow line");
+        }
+    }
+    lv_obj_delete(scr);
+}
+
+/**
+ * @brief Two screens built step by step in lockstep
+ *
+ * Every step must land on its own screen's radar, and the half circle must
+ * fit the screen on both sides. The zone editor is single-instance, so the
+ * second build logs that it stays on the first radar.
+ */
+static void test_panel_build(void)
+{
+    lv_obj_t *scr[2];
+    bool done[2] = {false, false};
+
+    for (int n = 0; n < 2; n++) {
+        scr[n] = lv_obj_create(NULL);
+        lv_obj_set_size(scr[n], 480, 320);
+    }
+    for (uint8_t step = 0; !done[0] || !done[1]; step++) {
+        for (int n = 0; n < 2; n++) {
+            if (!done[n]) {
+                done[n] = lv_radar_panel_build(scr[n], step);
+            }
+        }
+    }
+    uint32_t children[2];
+    for (int n = 0; n < 2; n++) {
+        lv_obj_t *radar = lv_obj_get_child_by_type(scr[n], 0, &lv_radar_class);
+        children[n] = radar != NULL ? lv_obj_get_child_count(radar) : 0;
+    }
+    for (int n = 0; n < 2; n++) {
+        lv_obj_t *radar = lv_obj_get_child_by_type(scr[n], 0, &lv_radar_class);
+        if (radar == NULL || lv_obj_get_child_by_type(scr[n], 1, &lv_radar_class) != NULL) {
+            printf("FAIL build of screen %d did not make exactly one radar\n", n);
+            failures++;
+            continue;
+        }
+        // Returns the sweep the build attached, if it went to this radar
+        const lv_radar_sweep_t *sweep = lv_radar_sweep_create(radar, 4000, true);
+        if (lv_obj_get_child_count(radar) != children[n]) {
+            printf("FAIL build of screen %d left its radar without a sweep\n", n);
+            failures++;
+        }
+        if (sweep->center_x - sweep->radius < 0 || sweep->center_x + sweep->radius > 480 || sweep->radius > 320) {
+            printf("FAIL radius %d around x %d leaves the 480x320 screen\n", sweep->radius, sweep->center_x);
+            failures++;
+        }
+    }
+    lv_obj_delete(scr[0]);
+    lv_obj_delete(scr[1]);
+}
+
+int main(void)
+{
+    test_sweep_trail();
+    test_xform();
+    test_sweep_lines();
+    test_panel_build();
+    printf("radar geometry: %s\n", failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}
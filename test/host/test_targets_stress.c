@@ -0,0 +1,89 @@
+/*
+ * test_targets_stress.c
+ * One writer thread publishes frames through the real radar_targets.c triple
+ * buffer as fast as it can while one reader thread copies the latest frame.
+ * Every field of a published frame is derived from its sequence number, so
+ * a reader that sees a mix of two frames (a tear) or a sequence going
+ * backwards is detected.
+ *
+ * SKN_STRESS_FRAMES=<n> changes the number of published frames.
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "radar_targets.h"
+
+#define STRESS_FRAMES 20000000u
+
+static uint32_t frames = STRESS_FRAMES;
+static atomic_bool writer_done = false;
+
+static void stress_fill(skn_target_frame_t *frame, uint32_t seq)
+{
+    frame->seq = seq;
+    frame->timestamp_us = (int64_t)seq * 100000;
+    frame->count = seq % (SKN_MAX_TARGETS + 1);
+    for (uint8_t i = 0; i < SKN_MAX_TARGETS; i++) {
+        frame->targets[i].x_mm = (int16_t)(seq * 3 + i);
+        frame->targets[i].y_mm = (int16_t)(seq * 5 + i);
+        frame->targets[i].speed_mms = (int16_t)(seq * 7 + i);
+        frame->targets[i].distance_mm = (uint16_t)(seq * 11 + i);
+    }
+}
+
+static void *stress_writer(void *arg)
+{
+    skn_target_frame_t frame;
+
+    for (uint32_t seq = 1; seq <= frames; seq++) {
+        stress_fill(&frame, seq);
+        skn_targets_publish(&frame);
+    }
+    atomic_store(&writer_done, true);
+    return NULL;
+}
+
+int main(void)
+{
+    const char *env = getenv("SKN_STRESS_FRAMES");
+    skn_target_frame_t got, want;
+    pthread_t writer;
+    uint64_t reads = 0, tears = 0, regressions = 0, distinct = 0;
+    uint32_t last_seq = 0;
+
+    if (env) {
+        frames = strtoul(env, NULL, 10);
+    }
+    pthread_create(&writer, NULL, stress_writer, NULL);
+
+    bool done = false;
+    while (!done) {
+        // Read once more after the writer finished to pick up the last frame
+        done = atomic_load(&writer_done);
+        uint32_t seq = skn_targets_latest(&got);
+        reads++;
+        if (seq == 0) {
+            continue;
+        }
+        stress_fill(&want, seq);
+        bool torn = got.timestamp_us != want.timestamp_us || got.count != want.count;
+        for (uint8_t i = 0; i < SKN_MAX_TARGETS; i++) {
+            torn |= got.targets[i].x_mm != want.targets[i].x_mm || got.targets[i].y_mm != want.targets[i].y_mm ||
+                    got.targets[i].speed_mms != want.targets[i].speed_mms ||
+                    got.targets[i].distance_mm != want.targets[i].distance_mm;
+        }
+        tears += torn;
+        regressions += seq < last_seq;
+        distinct += seq != last_seq;
+        last_seq = seq;
+    }
+    pthread_join(writer, NULL);
+
+    printf("targets stress: %u frames published, %llu reads, %llu distinct frames seen, %llu torn, %llu out of "
+           "order, last seq %u\n", frames, (unsigned long long)reads, (unsigned long long)distinct,
+           (unsigned long long)tears, (unsigned long long)regressions, last_seq);
+    return (tears || regressions || distinct < 2 || last_seq != frames) ? 1 : 0;
+}
@@ -0,0 +1,272 @@
+/*
+ * test_web_fanout.c
+ * Load test of the WebSocket push in the real web_server.c: one sensor frame
+ * after the other goes through skn_web_submit(), the delta encoder and the
+ * fan-out to 1..CONFIG_SKN_WEB_MAX_CLIENTS fake clients, and the cost per
+ * frame is reported as clients join.
+ *
+ * The fake httpd runs queued work at once and copies every message into the
+ * client's socket buffer, standing in for the copy into lwIP. The test checks
+ * that each frame is encoded once and the same buffer goes to every client,
+ * that every client's view decoded from its messages follows the targets,
+ * that a client joining late gets a keyframe and that one client over the
+ * limit is rejected. Timings are printed, not asserted.
+ *
+ * SKN_FANOUT_FRAMES=<n> changes the number of frames per client count.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "esp_http_server.h"
+#include "rd03d_config.h"
+#include "telemetry.h"
+#include "web_server.h"
+
+#define FANOUT_FRAMES  200000u
+#define FANOUT_FD_BASE 50
+#define FANOUT_SOCK_SZ 256
+
+typedef struct
+{
+    int fd;
+    bool connected;
+    uint32_t messages;
+    uint32_t bytes;
+    bool present[SKN_MAX_TARGETS]; // Targets as decoded from the messages
+    int16_t x_mm[SKN_MAX_TARGETS];
+    int16_t y_mm[SKN_MAX_TARGETS];
+    uint8_t sock[FANOUT_SOCK_SZ];
+} fake_client_t;
+
+static fake_client_t fake[CONFIG_SKN_WEB_MAX_CLIENTS + 1];
+static esp_err_t (*ws_handler)(httpd_req_t *req);
+static const uint8_t *frame_payloads[2]; // Distinct buffers sent for the current frame
+static uint8_t frame_payload_count;
+static int failures = 0;
+
+// Fake httpd
+
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config)
+{
+    *handle = (httpd_handle_t)fake;
+    return ESP_OK;
+}
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler)
+{
+    if (uri_handler->is_websocket) {
+        ws_handler = uri_handler->handler;
+    }
+    return ESP_OK;
+}
+
+esp_err_t httpd_queue_work(httpd_handle_t handle, httpd_work_fn_t work, void *arg)
+{
+    work(arg);
+    return ESP_OK;
+}
+
+int httpd_req_to_sockfd(httpd_req_t *r)
+{
+    return r->fd;
+}
+
+httpd_ws_client_info_t httpd_ws_get_fd_info(httpd_handle_t hd, int fd)
+{
+    return fake[fd - FANOUT_FD_BASE].connected ? HTTPD_WS_CLIENT_WEBSOCKET : HTTPD_WS_CLIENT_INVALID;
+}
+
+/**
+ * @brief Receive one message on a fake client and apply it to its view
+ */
+esp_err_t httpd_ws_send_frame_async(httpd_handle_t hd, int fd, httpd_ws_frame_t *frame)
+{
+    fake_client_t *client = &fake[fd - FANOUT_FD_BASE];
+    const uint8_t *p = client->sock;
+
+    memcpy(client->sock, frame->payload, frame->len);
+    client->messages++;
+    client->bytes += frame->len;
+    if (frame_payload_count == 0 || frame_payloads[frame_payload_count - 1] != frame->payload) {
+        if (frame_payload_count < 2) {
+            frame_payloads[frame_payload_count] = frame->payload;
+        }
+        frame_payload_count++;
+    }
+
+    uint8_t changes = p[3];
+    p += 4;
+    for (uint8_t i = 0; i < changes; i++) {
+        uint8_t slot = *p & 0x7F;
+        client->present[slot] = (*p++ & 0x80) != 0;
+        if (client->present[slot]) {
+            memcpy(&client->x_mm[slot], p, 2);
+            memcpy(&client->y_mm[slot], p + 2, 2);
+            p += 6;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t httpd_ws_recv_frame(httpd_req_t *req, httpd_ws_frame_t *pkt, size_t max_len)
+{
+    pkt->len = 0;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len) { return ESP_OK; }
+esp_err_t httpd_resp_send_chunk(httpd_req_t *r, const char *buf, ssize_t buf_len) { return ESP_OK; }
+esp_err_t httpd_resp_send_err(httpd_req_t *req, httpd_err_code_t error, const char *msg) { return ESP_OK; }
+esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type) { return ESP_OK; }
+esp_err_t httpd_query_key_value(const char *qry, const char *key, char *val, size_t val_size) { return ESP_FAIL; }
+size_t httpd_req_get_hdr_value_len(httpd_req_t *r, const char *field) { return 0; }
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t *r, const char *field, char *val, size_t val_size) { return ESP_FAIL; }
+int httpd_req_recv(httpd_req_t *r, char *buf, size_t buf_len) { return -1; }
+
+// The rest of the firmware web_server.c links against
+
+int skn_telemetry_to_json(char *buf, size_t len) { return -1; }
+esp_err_t skn_rd03d_load_config(skn_rd03d_config_t *config) { return ESP_FAIL; }
+esp_err_t skn_rd03d_save_config(const skn_rd03d_config_t *config) { return ESP_FAIL; }
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static esp_err_t fanout_connect(uint8_t index)
+{
+    httpd_req_t req = {.method = HTTP_GET, .fd = FANOUT_FD_BASE + index};
+
+    fake[index].fd = req.fd;
+    fake[index].connected = true;
+    esp_err_t ret = ws_handler(&req);
+    fake[index].connected = ret == ESP_OK;
+    return ret;
+}
+
+/**
+ * @brief Three people walking; one leaves and comes back every few seconds
+ */
+static void fanout_frame(uint32_t k, skn_target_frame_t *frame)
+{
+    double t = k / 10.0;
+
+    frame->seq = k + 1;
+    frame->count = 2 + (k / 40) % 2;
+    for (uint8_t i = 0; i < frame->count; i++) {
+        double phase = t * (0.35 + 0.1 * i) + i * 2.1;
+        frame->targets[i].x_mm = (int16_t)lround(1800.0 * sin(phase));
+        frame->targets[i].y_mm = (int16_t)lround(2500.0 + 1000.0 * i + 900.0 * cos(phase));
+        frame->targets[i].speed_mms = (int16_t)lround(300.0 * cos(phase));
+    }
+}
+
+/**
+ * @brief Whether a client's view is within tolerance of the frame
+ *
+ * Unchanged slots are not resent, so a view lags the truth by up to
+ * CONFIG_SKN_WEB_DELTA_MM, twice that for a client that joined on a keyframe
+ * taken between two sent states.
+ */
+static bool fanout_view_ok(const fake_client_t *client, const skn_target_frame_t *frame)
+{
+    for (uint8_t slot = 0; slot < SKN_MAX_TARGETS; slot++) {
+        bool is = slot < frame->count;
+        if (client->present[slot] != is) {
+            return false;
+        }
+        if (is && (abs(client->x_mm[slot] - frame->targets[slot].x_mm) > 2 * CONFIG_SKN_WEB_DELTA_MM ||
+                   abs(client->y_mm[slot] - frame->targets[slot].y_mm) > 2 * CONFIG_SKN_WEB_DELTA_MM)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(void)
+{
+    const char *env = getenv("SKN_FANOUT_FRAMES");
+    uint32_t frames = env ? (uint32_t)strtoul(env, NULL, 10) : FANOUT_FRAMES;
+    skn_target_frame_t frame;
+    uint32_t k = 0;
+    double base_ns = 0;
+
+    if (skn_web_start() != ESP_OK || ws_handler == NULL) {
+        printf("FAIL web server did not start\n");
+        return 1;
+    }
+
+    for (uint8_t clients = 1; clients <= CONFIG_SKN_WEB_MAX_CLIENTS; clients++) {
+        fake_client_t *joined = &fake[clients - 1];
+        if (fanout_connect(clients - 1) != ESP_OK) {
+            printf("FAIL client %u refused below the limit\n", clients);
+            return 1;
+        }
+
+        uint32_t messages = 0, bytes = 0, shared = 0, bad_views = 0;
+        for (uint32_t i = 0; i < frames; i++, k++) {
+            fanout_frame(k, &frame);
+            frame_payload_count = 0;
+            skn_web_submit(&frame);
+
+            // One delta buffer for everyone, plus the keyframe on a join
+            shared += frame_payload_count <= (i == 0 ? 2 : 1);
+            if (i == 0 && (joined->messages != 1 || !fanout_view_ok(joined, &frame))) {
+                printf("FAIL client %u did not start from a keyframe\n", clients);
+                failures++;
+            }
+            for (uint8_t c = 0; c < clients; c++) {
+                bad_views += !fanout_view_ok(&fake[c], &frame);
+            }
+        }
+
+        // Same stream again, timed without the checks
+        for (uint8_t c = 0; c < clients; c++) {
+            messages -= fake[c].messages;
+            bytes -= fake[c].bytes;
+        }
+        double t0 = now_ns();
+        for (uint32_t i = 0; i < frames; i++, k++) {
+            fanout_frame(k, &frame);
+            skn_web_submit(&frame);
+        }
+        double ns = (now_ns() - t0) / frames;
+        for (uint8_t c = 0; c < clients; c++) {
+            messages += fake[c].messages;
+            bytes += fake[c].bytes;
+        }
+        base_ns = clients == 1 ? ns : base_ns;
+        printf("%u clients: %.0f ns/frame (%.2fx of 1 client), %.2f messages and %.1f bytes per client per frame\n",
+               clients, ns, ns / base_ns, (double)messages / frames / clients, (double)bytes / frames / clients);
+        if (shared != frames) {
+            printf("FAIL %u frames encoded more than once\n", frames - shared);
+            failures++;
+        }
+        if (bad_views) {
+            printf("FAIL %u client views off the targets\n", bad_views);
+            failures++;
+        }
+    }
+
+    // One over the limit: rejected, so httpd closes it, and never sent to
+    if (fanout_connect(CONFIG_SKN_WEB_MAX_CLIENTS) == ESP_OK) {
+        printf("FAIL client over the limit accepted\n");
+        failures++;
+    }
+    fanout_frame(k, &frame);
+    skn_web_submit(&frame);
+    if (fake[CONFIG_SKN_WEB_MAX_CLIENTS].messages != 0) {
+        printf("FAIL client over the limit received data\n");
+        failures++;
+    }
+    printf("client over the limit rejected\n");
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,163 @@
+/*
+ * test_zone_editor.c
+ * Scripted touch session on the real zone_editor.c and radar_panel.c, run
+ * against the LVGL fake: a long press enters edit mode and one vertex handle
+ * of a zone is dragged across the radar.
+ *
+ * Every touch sample may only invalidate the dragged handle and the edited
+ * zone's outline, old and new position, so the sweep and markers keep their
+ * frame rate; the zone table (and its membership grid) is only written on
+ * release. The redrawn share of the radar and the CPU time per touch sample
+ * are printed.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "lvgl.h"
+#include "radar_panel.h"
+#include "radar_stubs.h"
+#include "zone_editor.h"
+
+#define EDIT_SCREEN_W   480
+#define EDIT_SCREEN_H   320
+#define EDIT_HANDLE_SZ  18 // As in zone_editor.c
+#define EDIT_SAMPLES    60
+#define EDIT_DRAG_X     (-120)
+#define EDIT_DRAG_Y     (-100)
+
+static int failures = 0;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static bool area_within(const lv_area_t *a, const lv_area_t *outer)
+{
+    return a->x1 >= outer->x1 && a->y1 >= outer->y1 && a->x2 <= outer->x2 && a->y2 <= outer->y2;
+}
+
+static int64_t area_size(const lv_area_t *a)
+{
+    return (int64_t)(a->x2 - a->x1 + 1) * (a->y2 - a->y1 + 1);
+}
+
+/**
+ * @brief First visible child of a class, optionally of a given size
+ */
+static lv_obj_t *find_child(lv_obj_t *parent, const lv_obj_class_t *class_p, int32_t size)
+{
+    for (uint32_t i = 0; i < parent->child_count; i++) {
+        lv_obj_t *child = parent->children[i];
+        if (child->class_p == class_p && !lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN) &&
+            (size == 0 || (child->w == size && child->h == size))) {
+            return child;
+        }
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    const skn_zone_t square = {
+        .vertex_count = 4,
+        .sensitivity = 5,
+        .name = "Zone 1",
+        .vertices = {{-500, 1500}, {500, 1500}, {500, 2500}, {-500, 2500}},
+    };
+
+    stub_zone_put(0, &square);
+    lv_obj_t *scr = lv_obj_create(NULL);
+    lv_obj_set_size(scr, EDIT_SCREEN_W, EDIT_SCREEN_H);
+    lv_obj_t *radar = lv_radar_screen_create(scr, EDIT_SCREEN_W, EDIT_SCREEN_H);
+    lv_radar_zones_draw(radar);
+    if (!lv_radar_zone_editor_create(radar)) {
+        printf("FAIL editor did not attach\n");
+        return 1;
+    }
+    lv_obj_t *outline = find_child(radar, &lv_line_class, 0);
+
+    // Long press: edit mode with a handle on every vertex of zone 1
+    lv_fake_press(radar, LV_EVENT_LONG_PRESSED, 0, 0);
+    lv_obj_t *handle = find_child(radar, &lv_obj_class, EDIT_HANDLE_SZ);
+    if (!lv_radar_zone_editor_active() || handle == NULL || outline == NULL) {
+        printf("FAIL edit mode shows no handle for zone 1\n");
+        return 1;
+    }
+
+    lv_area_t start, bounds;
+    lv_obj_get_coords(handle, &start);
+    lv_obj_get_coords(radar, &bounds);
+    if (!area_within(&start, &bounds) || lv_obj_get_width(outline) <= 1) {
+        printf("FAIL the radar was not laid out, handle at %d,%d\n", start.x1, start.y1);
+        return 1;
+    }
+    int32_t x0 = (start.x1 + start.x2) / 2, y0 = (start.y1 + start.y2) / 2;
+    int64_t redrawn = 0, worst = 0;
+    uint32_t sets = stub_zone_sets;
+    double cpu_ns = 0;
+
+    for (int i = 1; i <= EDIT_SAMPLES; i++) {
+        lv_area_t allowed[4];
+        lv_obj_get_coords(handle, &allowed[0]);
+        lv_obj_get_coords(outline, &allowed[1]);
+
+        lv_fake_invalid_reset();
+        double t0 = now_ns();
+        lv_fake_press(handle, LV_EVENT_PRESSING, x0 + EDIT_DRAG_X * i / EDIT_SAMPLES,
+                      y0 + EDIT_DRAG_Y * i / EDIT_SAMPLES);
+        cpu_ns += now_ns() - t0;
+        lv_obj_get_coords(handle, &allowed[2]);
+        lv_obj_get_coords(outline, &allowed[3]);
+
+        int64_t sample = 0;
+        for (uint32_t j = 0; j < lv_fake_invalid.count; j++) {
+            const lv_area_t *a = &lv_fake_invalid.areas[j];
+            bool ok = false;
+            for (int k = 0; k < 4 && !ok; k++) {
+                ok = area_within(a, &allowed[k]);
+            }
+            if (!ok) {
+                printf("FAIL sample %d invalidated %d,%d..%d,%d outside the handle and outline\n", i, a->x1, a->y1,
+                       a->x2, a->y2);
+                failures++;
+            }
+            sample += area_size(a);
+        }
+        redrawn += sample;
+        worst = sample > worst ? sample : worst;
+    }
+    if (stub_zone_sets != sets) {
+        printf("FAIL the zone table was written %u times while dragging\n", stub_zone_sets - sets);
+        failures++;
+    }
+
+    // Release: the zone is committed once, at the handle's final position
+    lv_area_t end;
+    lv_obj_get_coords(handle, &end);
+    lv_fake_press(handle, LV_EVENT_RELEASED, 0, 0);
+    skn_zone_t zone;
+    skn_zones_get(0, &zone);
+    lv_point_t p;
+    lv_radar_mm_to_point(radar, zone.vertices[0].x_mm, zone.vertices[0].y_mm, &p);
+    if (stub_zone_sets != sets + 1 || abs(p.x - (end.x1 + end.x2) / 2) > 1 || abs(p.y - (end.y1 + end.y2) / 2) > 1) {
+        printf("FAIL release did not commit the dragged vertex once\n");
+        failures++;
+    }
+
+    int64_t screen = (int64_t)EDIT_SCREEN_W * EDIT_SCREEN_H;
+    printf("%d touch samples: %.0f ns each, redraw avg %.1f%% worst %.1f%% of the radar\n", EDIT_SAMPLES,
+           cpu_ns / EDIT_SAMPLES, 100.0 * redrawn / EDIT_SAMPLES / screen, 100.0 * worst / screen);
+
+    lv_fake_press(radar, LV_EVENT_LONG_PRESSED, 0, 0);
+    if (lv_radar_zone_editor_active()) {
+        printf("FAIL second long press did not leave edit mode\n");
+        failures++;
+    }
+    lv_obj_delete(scr);
+    return failures ? 1 : 0;
+}
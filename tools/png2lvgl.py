@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""
+png2lvgl.py
+Convert the PNG images of a directory into LVGL v9 native image binaries.
+
+The output files carry a standard lv_image_header_t followed by the pixel
+planes, so they can be memory-mapped from flash and handed to LVGL as an
+lv_image_dsc_t without any runtime decoding.
+
+Only the standard library is used (zlib), so the script runs in a bare
+ESP-IDF python environment.
+
+usage: png2lvgl.py <input_dir> <output_dir> [--cf RGB565A8|RGB565]
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+LV_IMAGE_HEADER_MAGIC = 0x19
+LV_COLOR_FORMAT_RGB565 = 0x12
+LV_COLOR_FORMAT_RGB565A8 = 0x14
+
+PNG_SIGNATURE = b"\x89PNG\r\n\x1a\n"
+PNG_CHANNELS = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}
+
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def png_read_rgba(path):
+    """Decode a non-interlaced PNG into (width, height, [r, g, b, a] rows)."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:8] != PNG_SIGNATURE:
+        raise ValueError("%s: not a PNG file" % path)
+
+    pos = 8
+    idat = b""
+    palette = []
+    trns = b""
+    while pos < len(data):
+        length, ctype = struct.unpack(">I4s", data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if ctype == b"IHDR":
+            width, height, depth, color, _, _, interlace = struct.unpack(">IIBBBBB", chunk)
+        elif ctype == b"PLTE":
+            palette = [tuple(chunk[i:i + 3]) for i in range(0, len(chunk), 3)]
+        elif ctype == b"tRNS":
+            trns = chunk
+        elif ctype == b"IDAT":
+            idat += chunk
+        elif ctype == b"IEND":
+            break
+
+    if interlace:
+        raise ValueError("%s: interlaced PNG is not supported" % path)
+    if depth < 8 and color != 3:
+        raise ValueError("%s: bit depth %d is not supported" % (path, depth))
+
+    channels = PNG_CHANNELS[color]
+    bits_pp = channels * depth
+    bpp = max(1, bits_pp // 8)
+    row_len = (width * bits_pp + 7) // 8
+    raw = zlib.decompress(idat)
+
+    rows = []
+    prev = bytearray(row_len)
+    for y in range(height):
+        base = y * (row_len + 1)
+        ftype = raw[base]
+        line = bytearray(raw[base + 1:base + 1 + row_len])
+        for i in range(row_len):
+            a = line[i - bpp] if i >= bpp else 0
+            b = prev[i]
+            c = prev[i - bpp] if i >= bpp else 0
+            if ftype == 1:
+                line[i] = (line[i] + a) & 0xFF
+            elif ftype == 2:
+                line[i] = (line[i] + b) & 0xFF
+            elif ftype == 3:
+                line[i] = (line[i] + ((a + b) >> 1)) & 0xFF
+            elif ftype == 4:
+                line[i] = (line[i] + paeth(a, b, c)) & 0xFF
+        prev = line
+
+        pixels = []
+        for x in range(width):
+            if color == 3:
+                bit = x * depth
+                idx = (line[bit // 8] >> (8 - depth - (bit % 8))) & ((1 << depth) - 1)
+                r, g, b = palette[idx]
+                pixels.append((r, g, b, trns[idx] if idx < len(trns) else 255))
+                continue
+            # 16-bit samples keep only their most significant byte
+            step = depth // 8
+            s = [line[(x * channels + c) * step] for c in range(channels)]
+            if color == 0:
+                pixels.append((s[0], s[0], s[0], 255))
+            elif color == 4:
+                pixels.append((s[0], s[0], s[0], s[1]))
+            elif color == 2:
+                pixels.append((s[0], s[1], s[2], 255))
+            else:
+                pixels.append((s[0], s[1], s[2], s[3]))
+        rows.append(pixels)
+
+    return width, height, rows
+
+
+def lvgl_image_bin(width, height, rows, cf):
+    stride = width * 2
+    header = struct.pack("<BBHHHHH", LV_IMAGE_HEADER_MAGIC, cf, 0, width, height, stride, 0)
+
+    rgb = bytearray()
+    alpha = bytearray()
+    for pixels in rows:
+        for r, g, b, a in pixels:
+            rgb += struct.pack("<H", ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3))
+            alpha.append(a)
+
+    if cf == LV_COLOR_FORMAT_RGB565A8:
+        return header + rgb + alpha
+    return header + rgb
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert PNG images to LVGL native binaries")
+    parser.add_argument("input_dir")
+    parser.add_argument("output_dir")
+    parser.add_argument("--cf", choices=["RGB565A8", "RGB565"], default="RGB565A8")
+    args = parser.parse_args()
+
+    cf = LV_COLOR_FORMAT_RGB565A8 if args.cf == "RGB565A8" else LV_COLOR_FORMAT_RGB565
+    os.makedirs(args.output_dir, exist_ok=True)
+
+    for name in sorted(os.listdir(args.input_dir)):
+        if not name.lower().endswith(".png"):
+            continue
+        src = os.path.join(args.input_dir, name)
+        dst = os.path.join(args.output_dir, os.path.splitext(name)[0] + ".bin")
+        width, height, rows = png_read_rgba(src)
+        blob = lvgl_image_bin(width, height, rows, cf)
+        with open(dst, "wb") as f:
+            f.write(blob)
+        print("png2lvgl: %s -> %s (%dx%d, %d bytes)" % (name, os.path.basename(dst), width, height, len(blob)))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""
+rd03d_simulator.py
+Host stand-in for an RD-03D radar module.
+
+Streams 10 Hz target reports (AA FF 03 00 ... 55 CC) for one or more
+synthetic walkers and answers configuration frames (FD FC FB FA ... 04 03 02 01):
+enable/end configuration, firmware version and single/multi-target mode.
+Reports pause while configuration mode is open, as on the real module.
+
+Connect a USB-UART adapter to the firmware's sensor UART pins and pass its
+device, or use --pty to get a pseudo terminal for exercising a host client.
+
+Walkers move in the room frame; --pose x,y,yaw mounts the simulated module
+like the SKN_SENSORn_* settings, so two instances see the same people.
+
+usage: rd03d_simulator.py (--port /dev/ttyUSB0 | --pty) [--baud 256000] [--targets 2] [--pose 0,0,0] [--verbose]
+"""
+
+import argparse
+import math
+import os
+import struct
+import time
+
+CMD_HEAD = b"\xfd\xfc\xfb\xfa"
+CMD_TAIL = b"\x04\x03\x02\x01"
+REPORT_HEAD = b"\xaa\xff\x03\x00"
+REPORT_TAIL = b"\x55\xcc"
+
+CMD_READ_VERSION = 0x0000
+CMD_SINGLE_TARGET = 0x0080
+CMD_MULTI_TARGET = 0x0090
+CMD_END_CONFIG = 0x00FE
+CMD_ENABLE_CONFIG = 0x00FF
+
+FIRMWARE = (0x0000, 2, 1, 0x22062416)  # type, major, minor, build -> V2.01.22062416
+PROTOCOL = 0x0001
+BUFFER_SIZE = 0x0040
+
+
+def signed_mag(value):
+    """RD-03D coordinates: bit 15 set means positive, the low 15 bits are the magnitude."""
+    value = int(round(value))
+    return (0x8000 | min(value, 0x7FFF)) if value >= 0 else min(-value, 0x7FFF)
+
+
+def report(targets):
+    body = b""
+    for i in range(3):
+        if i < len(targets):
+            x, y, speed_cms = targets[i]
+            body += struct.pack("<HHHH", signed_mag(x), signed_mag(y), signed_mag(speed_cms),
+                                int(math.hypot(x, y)))
+        else:
+            body += b"\x00" * 8
+    return REPORT_HEAD + body + REPORT_TAIL
+
+
+def ack(command, status=0, data=b""):
+    body = struct.pack("<HH", command | 0x0100, status) + data
+    return CMD_HEAD + struct.pack("<H", len(body)) + body + CMD_TAIL
+
+
+class Module:
+    def __init__(self, verbose):
+        self.config_mode = False
+        self.multi_target = False
+        self.verbose = verbose
+        self.rx = b""
+
+    def feed(self, data):
+        """Consume received bytes, return the ACK frames to send."""
+        self.rx += data
+        replies = []
+        while True:
+            start = self.rx.find(CMD_HEAD)
+            if start < 0:
+                self.rx = self.rx[-3:]
+                return replies
+            if len(self.rx) < start + 6:
+                self.rx = self.rx[start:]
+                return replies
+            length = struct.unpack_from("<H", self.rx, start + 4)[0]
+            end = start + 6 + length + len(CMD_TAIL)
+            if len(self.rx) < end:
+                self.rx = self.rx[start:]
+                return replies
+            frame, self.rx = self.rx[start:end], self.rx[end:]
+            if frame[-4:] != CMD_TAIL or length < 2:
+                continue
+            command = struct.unpack_from("<H", frame, 6)[0]
+            replies.append(self.handle(command, frame[8:-4]))
+
+    def handle(self, command, value):
+        if self.verbose:
+            print("command 0x%04x value %s" % (command, value.hex()))
+        if command == CMD_ENABLE_CONFIG:
+            self.config_mode = True
+            return ack(command, 0, struct.pack("<HH", PROTOCOL, BUFFER_SIZE))
+        if not self.config_mode:
+            return ack(command, 1)
+        if command == CMD_END_CONFIG:
+            self.config_mode = False
+            return ack(command)
+        if command == CMD_READ_VERSION:
+            fw_type, major, minor, build = FIRMWARE
+            return ack(command, 0, struct.pack("<HBBI", fw_type, minor, major, build))
+        if command in (CMD_SINGLE_TARGET, CMD_MULTI_TARGET):
+            self.multi_target = command == CMD_MULTI_TARGET
+            print("tracking mode: %s-target" % ("multi" if self.multi_target else "single"))
+            return ack(command)
+        return ack(command, 1)
+
+
+def walkers(t, count):
+    """Targets pacing across the room on offset ellipses, speed in cm/s."""
+    out = []
+    for i in range(count):
+        phase = t * (0.35 + 0.1 * i) + i * 2.1
+        x = 1800.0 * math.sin(phase)
+        y = 2500.0 + 1200.0 * i + 900.0 * math.cos(phase)
+        radial = -900.0 * math.sin(phase) * (0.35 + 0.1 * i) * math.cos(phase)
+        out.append((x, y, radial / 10.0))
+    return out
+
+
+def parse_pose(text):
+    x, y, yaw = (float(v) for v in text.split(","))
+    return x, y, yaw
+
+
+def room_to_sensor(targets, pose):
+    """Inverse of the firmware's room transform: walkers seen by a module mounted at pose."""
+    px, py, yaw = pose
+    c, s = math.cos(math.radians(yaw)), math.sin(math.radians(yaw))
+    out = []
+    for x, y, speed in targets:
+        dx, dy = x - px, y - py
+        sx, sy = c * dx + s * dy, -s * dx + c * dy
+        if sy > 0:  # Only what is in front of the module
+            out.append((sx, sy, speed))
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description="RD-03D module simulator")
+    group = parser.add_mutually_exclusive_group(required=True)
+    group.add_argument("--port", help="serial device connected to the firmware's sensor UART")
+    group.add_argument("--pty", action="store_true", help="serve on a new pseudo terminal")
+    parser.add_argument("--baud", type=int, default=256000)
+    parser.add_argument("--targets", type=int, default=2, choices=range(0, 4))
+    parser.add_argument("--rate", type=float, default=10.0, help="reports per second")
+    parser.add_argument("--pose", type=parse_pose, default=(0.0, 0.0, 0.0), help="x_mm,y_mm,yaw_deg in the room")
+    parser.add_argument("--verbose", action="store_true")
+    args = parser.parse_args()
+
+    if args.pty:
+        master, slave = os.openpty()
+        print("simulated RD-03D on %s" % os.ttyname(slave))
+        os.set_blocking(master, False)
+
+        def read():
+            try:
+                return os.read(master, 256)
+            except BlockingIOError:
+                return b""
+
+        def write(data):
+            os.write(master, data)
+    else:
+        import serial  # pyserial
+
+        port = serial.Serial(args.port, args.baud, timeout=0)
+        print("simulated RD-03D on %s at %d baud" % (args.port, args.baud))
+        read = lambda: port.read(256)
+        write = port.write
+
+    module = Module(args.verbose)
+    start = time.time()
+    next_report = start
+    while True:
+        for reply in module.feed(read()):
+            write(reply)
+        now = time.time()
+        if now >= next_report:
+            next_report += 1.0 / args.rate
+            if not module.config_mode:
+                targets = room_to_sensor(walkers(now - start, args.targets), args.pose)
+                write(report(targets if module.multi_target else targets[:1]))
+        time.sleep(0.002)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+"""
+sensor_replay.py
+Writes synthetic RD-03D UART captures for the fusion replay in test/host.
+
+Renders the walkers of tools/rd03d_simulator.py as seen from each mounting
+pose, in the module's report format, one capture file per sensor. The
+captures are replayed through the firmware's own main/sensor_fusion.c by
+test_fusion_replay, the same way as real captures taken with
+`cat /dev/ttyUSB0 > left.bin` at 256000 baud; this script does no fusion.
+
+usage: sensor_replay.py [--pose X,Y,YAW ...] [--seconds 60] [--targets 2] [--out DIR]
+"""
+
+import argparse
+import os
+
+import rd03d_simulator as sim
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Synthetic RD-03D captures for test_fusion_replay")
+    parser.add_argument("--pose", action="append", type=sim.parse_pose, default=[],
+                        help="mounting pose X,Y,YAW of one sensor, repeat per sensor")
+    parser.add_argument("--seconds", type=float, default=60.0)
+    parser.add_argument("--targets", type=int, default=2)
+    parser.add_argument("--rate", type=float, default=10.0, help="reports per second")
+    parser.add_argument("--out", default=".", help="directory for sensorN.bin")
+    args = parser.parse_args()
+
+    # Default: two modules in opposite corners of a 4 m wide room, angled in by 45 degrees
+    poses = args.pose or [(-2000.0, 0.0, -45.0), (2000.0, 0.0, 45.0)]
+    streams = [bytearray() for _ in poses]
+    for k in range(int(args.seconds * args.rate)):
+        walkers = sim.walkers(k / args.rate, args.targets)
+        for stream, pose in zip(streams, poses):
+            stream += sim.report(sim.room_to_sensor(walkers, pose))
+
+    replay_args = []
+    for i, (stream, pose) in enumerate(zip(streams, poses)):
+        path = os.path.join(args.out, "sensor%d.bin" % (i + 1))
+        with open(path, "wb") as f:
+            f.write(stream)
+        replay_args.append("%s %g,%g,%g" % (path, *pose))
+    print("test_fusion_replay " + " ".join(replay_args))
+
+
+if __name__ == "__main__":
+    main()
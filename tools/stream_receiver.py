@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""
+stream_receiver.py
+Linux stand-in for a humanRadar target stream consumer.
+
+Joins the UDP multicast group the device publishes to, decodes the binary
+target batches and reports end-to-end latency and frame loss. Latency uses
+the wall-clock capture time carried in each batch, so both the device (SNTP)
+and this host (NTP) must be time-synced for the figures to be meaningful.
+
+usage: stream_receiver.py [--group 239.255.42.99] [--port 47800] [--interval 5]
+"""
+
+import argparse
+import json
+import socket
+import struct
+import time
+
+MAGIC = 0x524E4B53
+EVENT_MAGIC = 0x454E4B53
+EVENT_HEADER = struct.Struct("<IBBH")
+EVENT = struct.Struct("<BBBHI")
+EVENT_NAMES = {1: "ENTER", 2: "EXIT", 3: "DWELL", 4: "APPROACH"}
+HEADER = struct.Struct("<IBBHQ")
+FRAME = struct.Struct("<HHB")
+TARGET = struct.Struct("<hhh")
+
+
+def decode(packet):
+    magic, version, frame_count, batch_seq, base_epoch_ms = HEADER.unpack_from(packet, 0)
+    if magic != MAGIC or version != 1:
+        return None
+    offset = HEADER.size
+    frames = []
+    for _ in range(frame_count):
+        seq, dt_ms, count = FRAME.unpack_from(packet, offset)
+        offset += FRAME.size
+        targets = []
+        for _ in range(count):
+            targets.append(TARGET.unpack_from(packet, offset))
+            offset += TARGET.size
+        frames.append((seq, base_epoch_ms + dt_ms if base_epoch_ms else 0, targets))
+    return batch_seq, frames
+
+
+def decode_events(packet):
+    magic, version, count, _ = EVENT_HEADER.unpack_from(packet, 0)
+    if magic != EVENT_MAGIC or version != 1:
+        return []
+    return [EVENT.unpack_from(packet, EVENT_HEADER.size + i * EVENT.size) for i in range(count)]
+
+
+def percentile(values, pct):
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * pct / 100))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="humanRadar target stream receiver")
+    parser.add_argument("--group", default="239.255.42.99")
+    parser.add_argument("--port", type=int, default=47800)
+    parser.add_argument("--interval", type=float, default=5.0, help="report interval in seconds")
+    parser.add_argument("--verbose", action="store_true", help="print every frame")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM, socket.IPPROTO_UDP)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    sock.bind(("", args.port))
+    mreq = struct.pack("4sl", socket.inet_aton(args.group), socket.INADDR_ANY)
+    sock.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, mreq)
+    sock.settimeout(1.0)
+
+    last_seq = None
+    received = lost = 0
+    latencies = []
+    next_report = time.time() + args.interval
+
+    print("listening on %s:%d" % (args.group, args.port))
+    while True:
+        try:
+            packet = sock.recv(2048)
+        except socket.timeout:
+            packet = None
+
+        now_ms = time.time() * 1000.0
+        if packet and packet[:1] == b"{":
+            telemetry = json.loads(packet)
+            print("telemetry #%d: idle %s, fps %.1f" % (telemetry["seq"], telemetry["idle"],
+                                                        telemetry["lvgl"]["fps_x10"] / 10.0))
+        elif packet and struct.unpack_from("<I", packet)[0] == EVENT_MAGIC:
+            for etype, zone, slot, distance_mm, duration_ms in decode_events(packet):
+                print("event %-8s zone %d, target %d at %d mm, %d ms" % (
+                    EVENT_NAMES.get(etype, etype), zone, slot, distance_mm, duration_ms))
+        elif packet:
+            decoded = decode(packet)
+            if decoded is None:
+                continue
+            _, frames = decoded
+            for seq, epoch_ms, targets in frames:
+                if last_seq is not None:
+                    gap = (seq - last_seq - 1) & 0xFFFF
+                    if gap < 0x8000:
+                        lost += gap
+                last_seq = seq
+                received += 1
+                if epoch_ms:
+                    latencies.append(now_ms - epoch_ms)
+                if args.verbose:
+                    print("frame %5d: %s" % (seq, targets))
+
+        if time.time() >= next_report:
+            total = received + lost
+            print("frames %d, lost %d (%.2f%%), latency p50 %.1f ms, p99 %.1f ms, max %.1f ms" % (
+                received, lost, (lost * 100.0 / total) if total else 0.0,
+                percentile(latencies, 50), percentile(latencies, 99), max(latencies) if latencies else 0.0))
+            latencies = []
+            next_report = time.time() + args.interval
+
+
+if __name__ == "__main__":
+    main()